@@ -97,6 +97,19 @@ public:
 	 * By default, this maps to endOfData().
 	 */
 	virtual bool endOfStream() const { return endOfData(); }
+
+	/**
+	 * Get the number of samples this stream prefers to produce per call
+	 * to readBuffer().
+	 *
+	 * Streams decoding fixed-size blocks, such as ADPCM streams, work best
+	 * when asked for whole blocks. Consumers like the rate converters round
+	 * their requests down to a multiple of this size when it fits into their
+	 * buffers. Streams without a preference keep getting requests of any size.
+	 *
+	 * @return The preferred number of samples, or 0 if there is no preference.
+	 */
+	virtual int getPreferredBlockSize() const { return 0; }
 };
 
 /**
@@ -177,6 +190,7 @@ public:
 
 	bool isStereo() const { return _parent->isStereo(); }
 	int getRate() const { return _parent->getRate(); }
+	int getPreferredBlockSize() const { return _parent->getPreferredBlockSize(); }
 
 	uint getCompleteIterations() const { return _completeIterations; }
 	void setRemainingIterations(uint loops) { _loops = _completeIterations + loops; }
@@ -310,6 +324,7 @@ public:
 
 	bool isStereo() const { return _parent->isStereo(); }
 	int getRate() const { return _parent->getRate(); }
+	int getPreferredBlockSize() const { return _parent->getPreferredBlockSize(); }
 
 	uint getCompleteIterations() const { return _completeIterations; }
 	void setRemainingIterations(uint loops) { _loops = _completeIterations + loops; }
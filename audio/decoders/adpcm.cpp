@@ -47,11 +47,33 @@ ADPCMStream::ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Fl
 		_endpos(_startpos + size),
 		_channels(channels),
 		_blockAlign(blockAlign),
-		_rate(rate) {
+		_rate(rate),
+		_blockData(nullptr),
+		_blockDataSize(0) {
 
 	reset();
 }
 
+ADPCMStream::~ADPCMStream() {
+	delete[] _blockData;
+}
+
+bool ADPCMStream::readBlock() {
+	if (_stream->eos() || _stream->pos() >= _endpos)
+		return false;
+
+	if (!_blockData)
+		_blockData = new byte[_blockAlign];
+
+	_blockDataSize = _stream->read(_blockData, MIN<int64>(_blockAlign, _endpos - _stream->pos()));
+	if (_blockDataSize == 0)
+		return false;
+
+	memset(_blockData + _blockDataSize, 0, _blockAlign - _blockDataSize);
+	_blockPos[0] = 0;
+	return true;
+}
+
 void ADPCMStream::reset() {
 	memset(&_status, 0, sizeof(_status));
 	_blockPos[0] = _blockPos[1] = _blockAlign; // To make sure first header is read
@@ -316,27 +338,34 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 
 	int samples = 0;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
+	while (samples < numSamples) {
+		if (_samplesLeft[0] == 0) {
+			if (_blockPos[0] >= _blockDataSize) {
+				if (!readBlock())
+					break;
 
-			_blockPos[0] = _channels * 4;
-		}
+				for (int i = 0; i < _channels; i++) {
+					// read block header
+					_status.ima_ch[i].last = (int16)READ_LE_UINT16(_blockData + i * 4);
+					_status.ima_ch[i].stepIndex = (int16)READ_LE_UINT16(_blockData + i * 4 + 2);
+				}
 
-		// Decode a set of samples
-		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
-			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
+				_blockPos[0] = _channels * 4;
+				if (_blockPos[0] >= _blockDataSize)
+					continue;
+			}
+
+			// Decode a set of samples
+			const byte *data = _blockData + _blockPos[0];
+			for (int i = 0; i < _channels; i++) {
+				// The stream encodes four bytes per channel at a time
+				for (int j = 0; j < 4; j++) {
+					_buffer[i][j * 2] = decodeIMA(data[i * 4 + j] & 0x0f, i);
+					_buffer[i][j * 2 + 1] = decodeIMA((data[i * 4 + j] >> 4) & 0x0f, i);
+				}
+				_samplesLeft[i] = 8;
 			}
+			_blockPos[0] += _channels * 4;
 		}
 
 		while (samples < numSamples && _samplesLeft[0] != 0) {
@@ -392,31 +421,35 @@ int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	byte data;
 	int i;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+	for (samples = 0; samples < numSamples; samples++) {
 		if (_decodedSampleCount == 0) {
-			if (_blockPos[0] == _blockAlign) {
+			if (_blockPos[0] >= _blockDataSize) {
+				if (!readBlock())
+					break;
+
 				// read block header
+				const byte *header = _blockData;
 				for (i = 0; i < _channels; i++) {
-					_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
+					_status.ch[i].predictor = CLIP(*header++, (byte)0, (byte)6);
 					_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
 					_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
 				}
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].delta = _stream->readSint16LE();
+				for (i = 0; i < _channels; i++, header += 2)
+					_status.ch[i].delta = (int16)READ_LE_UINT16(header);
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].sample1 = _stream->readSint16LE();
+				for (i = 0; i < _channels; i++, header += 2)
+					_status.ch[i].sample1 = (int16)READ_LE_UINT16(header);
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
+				for (i = 0; i < _channels; i++, header += 2)
+					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = (int16)READ_LE_UINT16(header);
 
 				for (i = 0; i < _channels; i++)
 					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
 
 				_blockPos[0] = _channels * 7;
 			} else {
-				data = _stream->readByte();
+				data = _blockData[_blockPos[0]];
 				_blockPos[0]++;
 				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
 				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
@@ -48,6 +48,21 @@ protected:
 	uint32 _blockPos[2];
 	const int _rate;
 
+	/**
+	 * The current block, for decoders reading a whole block at once
+	 * instead of byte by byte. Bytes past the end of the stream are zero.
+	 */
+	byte *_blockData;
+	uint32 _blockDataSize;
+
+	/**
+	 * Read the next block into _blockData and reset _blockPos[0].
+	 *
+	 * @return false if the end of the stream was reached.
+	 */
+	bool readBlock();
+	bool endOfBlockData() const { return (_stream->eos() || _stream->pos() >= _endpos) && _blockPos[0] >= _blockDataSize; }
+
 	struct ADPCMStatus {
 		// OKI/IMA
 		struct {
@@ -61,6 +76,7 @@ protected:
 
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
+	~ADPCMStream();
 
 	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos); }
 	virtual bool isStereo() const { return _channels == 2; }
@@ -186,8 +202,12 @@ public:
 		_samplesLeft[1] = 0;
 	}
 
+	virtual bool endOfData() const { return endOfBlockData() && _samplesLeft[0] == 0; }
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
+	/** Each data byte of a block holds two samples. */
+	virtual int getPreferredBlockSize() const { return (_blockAlign - _channels * 4) * 2; }
+
 	void reset() {
 		Ima_ADPCMStream::reset();
 		_samplesLeft[0] = 0;
@@ -230,10 +250,13 @@ public:
 		_decodedSampleIndex = 0;
 	}
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return endOfBlockData() && (_decodedSampleCount == 0); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
+	/** The block header holds two samples per channel, and each data byte two more. */
+	virtual int getPreferredBlockSize() const { return _channels * 2 + (_blockAlign - _channels * 7) * 2; }
+
 protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
 
@@ -81,21 +81,33 @@ private:
 	};
 
 	/**
-	 * Fill the temporary sample buffer used in readBuffer.
+	 * Fill a sample buffer with raw data from the stream.
 	 *
+	 * @param dst        Buffer to fill, usually the temporary buffer used in readBuffer.
 	 * @param maxSamples Maximum samples to read.
 	 * @return actual count of samples read.
 	 */
-	int fillBuffer(int maxSamples);
+	int fillBuffer(byte *dst, int maxSamples);
 };
 
 template<int bytesPerSample, bool isUnsigned, bool isLE>
 int RawStream<bytesPerSample, isUnsigned, isLE>::readBuffer(int16 *buffer, const int numSamples) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	const bool isNativeEndian = isLE;
+#else
+	const bool isNativeEndian = !isLE;
+#endif
+
+	// Samples already in the output format need no conversion,
+	// so read them straight into the caller's buffer.
+	if (bytesPerSample == 2 && !isUnsigned && isNativeEndian)
+		return fillBuffer((byte *)buffer, numSamples);
+
 	int samplesLeft = numSamples;
 
 	while (samplesLeft > 0) {
-		// Try to read up to "samplesLeft" samples.
-		int len = fillBuffer(samplesLeft);
+		// Try to read up to "samplesLeft" samples, as far as they fit into our buffer.
+		int len = fillBuffer(_buffer, MIN<int>(kSampleBufferLength, samplesLeft));
 
 		// In case we were not able to read any samples
 		// we will stop reading here.
@@ -123,14 +135,8 @@ int RawStream<bytesPerSample, isUnsigned, isLE>::readBuffer(int16 *buffer, const
 }
 
 template<int bytesPerSample, bool isUnsigned, bool isLE>
-int RawStream<bytesPerSample, isUnsigned, isLE>::fillBuffer(int maxSamples) {
+int RawStream<bytesPerSample, isUnsigned, isLE>::fillBuffer(byte *dst, int maxSamples) {
 	int bufferedSamples = 0;
-	byte *dst = _buffer;
-
-	// We can only read up to "kSampleBufferLength" samples
-	// so we take this into consideration, when trying to
-	// read up to maxSamples.
-	maxSamples = MIN<int>(kSampleBufferLength, maxSamples);
 
 	// We will only read up to maxSamples
 	while (maxSamples > 0 && !endOfData()) {
@@ -0,0 +1,151 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mix/mix.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// Multiply the samples by the volumes and divide by Mixer::kMaxMixerVolume,
+// rounding towards zero exactly like the scalar code does.
+static FORCEINLINE __m256i avx2_scale(__m256i x, __m256i vol) {
+	__m256i lo = _mm256_mullo_epi16(x, vol);
+	__m256i hi = _mm256_mulhi_epi16(x, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_srli_epi32(_mm256_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_srli_epi32(_mm256_srai_epi32(p1, 31), 24)), 8);
+	return _mm256_packs_epi32(p0, p1);
+}
+
+// Sum each left/right pair and halve it, rounding towards zero
+static FORCEINLINE __m256i avx2_downmix(__m256i x) {
+	__m256i sum = _mm256_madd_epi16(x, _mm256_set1_epi16(1));
+	return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_srli_epi32(sum, 31)), 1);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mixAVX2T(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i volMono = _mm256_set1_epi16(volL);
+	const __m256i volMonoR = _mm256_set1_epi16(volR);
+	// After swapping the input channels, the right volume applies to the first sample of each pair
+	const __m256i volStereo = reverseStereo ? _mm256_set1_epi32((volL << 16) | volR) : _mm256_set1_epi32((volR << 16) | volL);
+	const __m256i swapMask = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+	                                          2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+
+	st_size_t i = 0;
+	if (inStereo && outStereo) {
+		for (; i + 8 <= numFrames; i += 8) {
+			__m256i x = _mm256_loadu_si256((const __m256i *)src);
+			if (reverseStereo)
+				x = _mm256_shuffle_epi8(x, swapMask);
+			__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, _mm256_adds_epi16(d, avx2_scale(x, volStereo)));
+			src += 16;
+			dst += 16;
+		}
+	} else if (outStereo) {
+		for (; i + 16 <= numFrames; i += 16) {
+			// Reorder the 64-bit blocks so that the in-lane unpacks below
+			// produce the duplicated samples in the right order
+			__m256i x = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)src), _MM_SHUFFLE(3, 1, 2, 0));
+			__m256i d0 = _mm256_loadu_si256((const __m256i *)dst);
+			__m256i d1 = _mm256_loadu_si256((const __m256i *)(dst + 16));
+			_mm256_storeu_si256((__m256i *)dst, _mm256_adds_epi16(d0, avx2_scale(_mm256_unpacklo_epi16(x, x), volStereo)));
+			_mm256_storeu_si256((__m256i *)(dst + 16), _mm256_adds_epi16(d1, avx2_scale(_mm256_unpackhi_epi16(x, x), volStereo)));
+			src += 16;
+			dst += 32;
+		}
+	} else if (inStereo) {
+		for (; i + 16 <= numFrames; i += 16) {
+			__m256i x0 = avx2_downmix(avx2_scale(_mm256_loadu_si256((const __m256i *)src), volStereo));
+			__m256i x1 = avx2_downmix(avx2_scale(_mm256_loadu_si256((const __m256i *)(src + 16)), volStereo));
+			// The pack works per 128-bit lane, so fix up the order of the 64-bit blocks afterwards
+			__m256i out = _mm256_permute4x64_epi64(_mm256_packs_epi32(x0, x1), _MM_SHUFFLE(3, 1, 2, 0));
+			__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, _mm256_adds_epi16(d, out));
+			src += 32;
+			dst += 16;
+		}
+	} else {
+		for (; i + 16 <= numFrames; i += 16) {
+			__m256i x = _mm256_loadu_si256((const __m256i *)src);
+			__m256i l = avx2_scale(x, volMono);
+			__m256i r = avx2_scale(x, volMonoR);
+			__m256i x0 = avx2_downmix(_mm256_unpacklo_epi16(l, r));
+			__m256i x1 = avx2_downmix(_mm256_unpackhi_epi16(l, r));
+			__m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			_mm256_storeu_si256((__m256i *)dst, _mm256_adds_epi16(d, _mm256_packs_epi32(x0, x1)));
+			src += 16;
+			dst += 16;
+		}
+	}
+
+	SampleMixer::mixScalar<inStereo, outStereo, reverseStereo>(dst, src, numFrames - i, volL, volR);
+}
+
+void SampleMixer::mixAVX2(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixAVX2T<true, true, true>(dst, src, numFrames, volL, volR);
+			else
+				mixAVX2T<true, true, false>(dst, src, numFrames, volL, volR);
+		} else
+			mixAVX2T<true, false, false>(dst, src, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixAVX2T<false, true, false>(dst, src, numFrames, volL, volR);
+		else
+			mixAVX2T<false, false, false>(dst, src, numFrames, volL, volR);
+	}
+}
+
+int32 SampleMixer::dotProductAVX2(const st_sample_t *samples, const int16 *coefs, uint numTaps) {
+	__m256i sum = _mm256_setzero_si256();
+	for (uint i = 0; i < numTaps; i += 16) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(samples + i));
+		__m256i c = _mm256_loadu_si256((const __m256i *)(coefs + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(x, c));
+	}
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum128);
+}
+
+} // End of namespace Audio
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
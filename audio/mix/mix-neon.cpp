@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/mix/mix.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+// Divide by Mixer::kMaxMixerVolume, rounding towards zero exactly like the scalar code does.
+static inline int32x4_t neon_div256(int32x4_t p) {
+	uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24);
+	return vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(bias)), 8);
+}
+
+static inline int16x8_t neon_scale(int16x8_t x, int16x4_t vol) {
+	int32x4_t p0 = neon_div256(vmull_s16(vget_low_s16(x), vol));
+	int32x4_t p1 = neon_div256(vmull_s16(vget_high_s16(x), vol));
+	return vcombine_s16(vmovn_s32(p0), vmovn_s32(p1));
+}
+
+// Sum each left/right pair and halve it, rounding towards zero
+static inline int16x4_t neon_downmix(int16x4_t l, int16x4_t r) {
+	int32x4_t sum = vaddl_s16(l, r);
+	sum = vaddq_s32(sum, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(sum), 31)));
+	return vmovn_s32(vshrq_n_s32(sum, 1));
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mixNEONT(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const int16x4_t vecVolL = vdup_n_s16(volL);
+	const int16x4_t vecVolR = vdup_n_s16(volR);
+
+	st_size_t i = 0;
+	for (; i + 8 <= numFrames; i += 8) {
+		int16x8_t l, r;
+		if (inStereo) {
+			int16x8x2_t in = vld2q_s16(src);
+			l = neon_scale(in.val[0], vecVolL);
+			r = neon_scale(in.val[1], vecVolR);
+			src += 16;
+		} else {
+			int16x8_t in = vld1q_s16(src);
+			l = neon_scale(in, vecVolL);
+			r = neon_scale(in, vecVolR);
+			src += 8;
+		}
+
+		if (outStereo) {
+			int16x8x2_t d = vld2q_s16(dst);
+			d.val[reverseStereo    ] = vqaddq_s16(d.val[reverseStereo    ], l);
+			d.val[reverseStereo ^ 1] = vqaddq_s16(d.val[reverseStereo ^ 1], r);
+			vst2q_s16(dst, d);
+			dst += 16;
+		} else {
+			int16x8_t out = vcombine_s16(neon_downmix(vget_low_s16(l), vget_low_s16(r)),
+			                             neon_downmix(vget_high_s16(l), vget_high_s16(r)));
+			vst1q_s16(dst, vqaddq_s16(vld1q_s16(dst), out));
+			dst += 8;
+		}
+	}
+
+	SampleMixer::mixScalar<inStereo, outStereo, reverseStereo>(dst, src, numFrames - i, volL, volR);
+}
+
+void SampleMixer::mixNEON(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixNEONT<true, true, true>(dst, src, numFrames, volL, volR);
+			else
+				mixNEONT<true, true, false>(dst, src, numFrames, volL, volR);
+		} else
+			mixNEONT<true, false, false>(dst, src, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixNEONT<false, true, false>(dst, src, numFrames, volL, volR);
+		else
+			mixNEONT<false, false, false>(dst, src, numFrames, volL, volR);
+	}
+}
+
+int32 SampleMixer::dotProductNEON(const st_sample_t *samples, const int16 *coefs, uint numTaps) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint i = 0; i < numTaps; i += 8) {
+		int16x8_t x = vld1q_s16(samples + i);
+		int16x8_t c = vld1q_s16(coefs + i);
+		sum = vmlal_s16(sum, vget_low_s16(x), vget_low_s16(c));
+		sum = vmlal_s16(sum, vget_high_s16(x), vget_high_s16(c));
+	}
+	int32x2_t sum2 = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(sum2, sum2), 0);
+}
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,152 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/mix/mix.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+// Multiply the samples by the volumes and divide by Mixer::kMaxMixerVolume,
+// rounding towards zero exactly like the scalar code does.
+static FORCEINLINE __m128i sse2_scale(__m128i x, __m128i vol) {
+	__m128i lo = _mm_mullo_epi16(x, vol);
+	__m128i hi = _mm_mulhi_epi16(x, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24)), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+// Sum each left/right pair and halve it, rounding towards zero
+static FORCEINLINE __m128i sse2_downmix(__m128i x) {
+	__m128i sum = _mm_madd_epi16(x, _mm_set1_epi16(1));
+	return _mm_srai_epi32(_mm_add_epi32(sum, _mm_srli_epi32(sum, 31)), 1);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mixSSE2T(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i volMono = _mm_set1_epi16(volL);
+	const __m128i volMonoR = _mm_set1_epi16(volR);
+	// After swapping the input channels, the right volume applies to the first sample of each pair
+	const __m128i volStereo = reverseStereo ? _mm_set1_epi32((volL << 16) | volR) : _mm_set1_epi32((volR << 16) | volL);
+
+	st_size_t i = 0;
+	if (inStereo && outStereo) {
+		for (; i + 4 <= numFrames; i += 4) {
+			__m128i x = _mm_loadu_si128((const __m128i *)src);
+			if (reverseStereo)
+				x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			__m128i d = _mm_loadu_si128((const __m128i *)dst);
+			_mm_storeu_si128((__m128i *)dst, _mm_adds_epi16(d, sse2_scale(x, volStereo)));
+			src += 8;
+			dst += 8;
+		}
+	} else if (outStereo) {
+		for (; i + 8 <= numFrames; i += 8) {
+			__m128i x = _mm_loadu_si128((const __m128i *)src);
+			__m128i d0 = _mm_loadu_si128((const __m128i *)dst);
+			__m128i d1 = _mm_loadu_si128((const __m128i *)(dst + 8));
+			_mm_storeu_si128((__m128i *)dst, _mm_adds_epi16(d0, sse2_scale(_mm_unpacklo_epi16(x, x), volStereo)));
+			_mm_storeu_si128((__m128i *)(dst + 8), _mm_adds_epi16(d1, sse2_scale(_mm_unpackhi_epi16(x, x), volStereo)));
+			src += 8;
+			dst += 16;
+		}
+	} else if (inStereo) {
+		for (; i + 8 <= numFrames; i += 8) {
+			__m128i x0 = sse2_downmix(sse2_scale(_mm_loadu_si128((const __m128i *)src), volStereo));
+			__m128i x1 = sse2_downmix(sse2_scale(_mm_loadu_si128((const __m128i *)(src + 8)), volStereo));
+			__m128i d = _mm_loadu_si128((const __m128i *)dst);
+			_mm_storeu_si128((__m128i *)dst, _mm_adds_epi16(d, _mm_packs_epi32(x0, x1)));
+			src += 16;
+			dst += 8;
+		}
+	} else {
+		for (; i + 8 <= numFrames; i += 8) {
+			__m128i x = _mm_loadu_si128((const __m128i *)src);
+			__m128i l = sse2_scale(x, volMono);
+			__m128i r = sse2_scale(x, volMonoR);
+			__m128i x0 = sse2_downmix(_mm_unpacklo_epi16(l, r));
+			__m128i x1 = sse2_downmix(_mm_unpackhi_epi16(l, r));
+			__m128i d = _mm_loadu_si128((const __m128i *)dst);
+			_mm_storeu_si128((__m128i *)dst, _mm_adds_epi16(d, _mm_packs_epi32(x0, x1)));
+			src += 8;
+			dst += 8;
+		}
+	}
+
+	SampleMixer::mixScalar<inStereo, outStereo, reverseStereo>(dst, src, numFrames - i, volL, volR);
+}
+
+void SampleMixer::mixSSE2(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixSSE2T<true, true, true>(dst, src, numFrames, volL, volR);
+			else
+				mixSSE2T<true, true, false>(dst, src, numFrames, volL, volR);
+		} else
+			mixSSE2T<true, false, false>(dst, src, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixSSE2T<false, true, false>(dst, src, numFrames, volL, volR);
+		else
+			mixSSE2T<false, false, false>(dst, src, numFrames, volL, volR);
+	}
+}
+
+int32 SampleMixer::dotProductSSE2(const st_sample_t *samples, const int16 *coefs, uint numTaps) {
+	__m128i sum = _mm_setzero_si128();
+	for (uint i = 0; i < numTaps; i += 8) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(samples + i));
+		__m128i c = _mm_loadu_si128((const __m128i *)(coefs + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(x, c));
+	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -0,0 +1,99 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/mix/mix.h"
+
+#include "common/system.h"
+
+namespace Audio {
+
+// Initialize these to nullptr at the start
+SampleMixer::MixFunc SampleMixer::mixFunc = nullptr;
+SampleMixer::DotProductFunc SampleMixer::dotProductFunc = nullptr;
+
+void SampleMixer::mixGeneric(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				mixScalar<true, true, true>(dst, src, numFrames, volL, volR);
+			else
+				mixScalar<true, true, false>(dst, src, numFrames, volL, volR);
+		} else
+			mixScalar<true, false, false>(dst, src, numFrames, volL, volR);
+	} else {
+		if (outStereo)
+			mixScalar<false, true, false>(dst, src, numFrames, volL, volR);
+		else
+			mixScalar<false, false, false>(dst, src, numFrames, volL, volR);
+	}
+}
+
+int32 SampleMixer::dotProductGeneric(const st_sample_t *samples, const int16 *coefs, uint numTaps) {
+	int32 sum = 0;
+	for (uint i = 0; i < numTaps; i++)
+		sum += samples[i] * coefs[i];
+	return sum;
+}
+
+void SampleMixer::selectFuncs() {
+	mixFunc = mixGeneric;
+	dotProductFunc = dotProductGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		mixFunc = mixNEON;
+		dotProductFunc = dotProductNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		mixFunc = mixSSE2;
+		dotProductFunc = dotProductSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		mixFunc = mixAVX2;
+		dotProductFunc = dotProductAVX2;
+	}
+#endif
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	// The SIMD kernels only handle signed output samples
+	mixFunc = mixGeneric;
+#endif
+}
+
+// This function just jumps to whatever function is in SampleMixer::mixFunc.
+// This way, we can detect at runtime whether or not the cpu has certain
+// SIMD feature enabled or not.
+void SampleMixer::mix(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames,
+                      st_volume_t volL, st_volume_t volR,
+                      bool inStereo, bool outStereo, bool reverseStereo) {
+	if (numFrames == 0)
+		return;
+
+	// If no function has been selected yet, detect and select
+	if (!mixFunc)
+		selectFuncs();
+
+	mixFunc(dst, src, numFrames, volL, volR, inStereo, outStereo, reverseStereo);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,155 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_MIX_MIX_H
+#define AUDIO_MIX_MIX_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+class SampleMixerTestSuite;
+class RateConverterTestSuite;
+
+namespace Audio {
+
+/**
+ * @defgroup audio_mix Sample mixing
+ * @ingroup audio
+ *
+ * @brief SIMD kernels used for resampling and mixing samples into the output buffer.
+ * @{
+ */
+
+/**
+ * Applies the per-channel volume/balance to a block of samples and adds
+ * them with clamping to the mixer output buffer.
+ *
+ * The actual kernel is picked at runtime depending on which SIMD features
+ * the CPU supports, in the same way as Graphics::BlendBlit does it. All
+ * kernels produce bit-identical output.
+ */
+class SampleMixer {
+private:
+	typedef void(*MixFunc)(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames,
+	                       st_volume_t volL, st_volume_t volR,
+	                       bool inStereo, bool outStereo, bool reverseStereo);
+
+#ifdef SCUMMVM_NEON
+	static void mixNEON(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void mixSSE2(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void mixAVX2(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+	static void mixGeneric(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR, bool inStereo, bool outStereo, bool reverseStereo);
+
+	typedef int32(*DotProductFunc)(const st_sample_t *samples, const int16 *coefs, uint numTaps);
+
+#ifdef SCUMMVM_NEON
+	static int32 dotProductNEON(const st_sample_t *samples, const int16 *coefs, uint numTaps);
+#endif
+#ifdef SCUMMVM_SSE2
+	static int32 dotProductSSE2(const st_sample_t *samples, const int16 *coefs, uint numTaps);
+#endif
+#ifdef SCUMMVM_AVX2
+	static int32 dotProductAVX2(const st_sample_t *samples, const int16 *coefs, uint numTaps);
+#endif
+	static int32 dotProductGeneric(const st_sample_t *samples, const int16 *coefs, uint numTaps);
+
+	static void selectFuncs();
+
+	static MixFunc mixFunc;
+	static DotProductFunc dotProductFunc;
+	friend class ::SampleMixerTestSuite;
+	friend class ::RateConverterTestSuite;
+
+public:
+	/**
+	 * Scalar reference implementation, also used by the SIMD kernels to
+	 * process the frames left over after the vectorized part.
+	 */
+	template<bool inStereo, bool outStereo, bool reverseStereo>
+	static void mixScalar(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+		for (st_size_t i = 0; i < numFrames; i++) {
+			st_sample_t inL, inR;
+			inL = *src++;
+			inR = (inStereo ? *src++ : inL);
+
+			st_sample_t outL, outR;
+			outL = (inL * (int)volL) / Mixer::kMaxMixerVolume;
+			outR = (inR * (int)volR) / Mixer::kMaxMixerVolume;
+
+			if (outStereo) {
+				// Output left channel
+				clampedAdd(dst[reverseStereo    ], outL);
+
+				// Output right channel
+				clampedAdd(dst[reverseStereo ^ 1], outR);
+
+				dst += 2;
+			} else {
+				// Output mono channel
+				clampedAdd(dst[0], (outL + outR) / 2);
+
+				dst += 1;
+			}
+		}
+	}
+
+	/**
+	 * Mix a block of samples into the output buffer.
+	 *
+	 * @param dst           The output buffer, holding numFrames mono or stereo frames.
+	 * @param src           The input samples, holding numFrames mono or stereo frames.
+	 * @param numFrames     Number of frames (sample pairs for stereo data) to mix.
+	 * @param volL          Volume for left channel, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param volR          Volume for right channel, in the range 0 - Mixer::kMaxMixerVolume.
+	 * @param inStereo      Whether @p src holds stereo frames.
+	 * @param outStereo     Whether @p dst holds stereo frames.
+	 * @param reverseStereo Whether the left and right channels should be swapped.
+	 */
+	static void mix(st_sample_t *dst, const st_sample_t *src, st_size_t numFrames,
+	                st_volume_t volL, st_volume_t volR,
+	                bool inStereo, bool outStereo, bool reverseStereo);
+
+	/**
+	 * Compute the dot product of a block of samples and FIR filter
+	 * coefficients, as used by the polyphase rate converter.
+	 *
+	 * @param samples The samples of one channel.
+	 * @param coefs   The filter coefficients.
+	 * @param numTaps Number of samples and coefficients, must be a multiple of 16.
+	 *
+	 * @return The sum of the products, without any scaling applied.
+	 */
+	static int32 dotProduct(const st_sample_t *samples, const int16 *coefs, uint numTaps) {
+		if (!dotProductFunc)
+			selectFuncs();
+		return dotProductFunc(samples, coefs, numTaps);
+	}
+};
+
+/** @} */
+} // End of namespace Audio
+
+#endif
@@ -25,6 +25,7 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -79,6 +80,9 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/** The resampling algorithm used for new channels, see the "audio_resampler" config key */
+	RateConverterType _rateConverterType;
+
 
 public:
 
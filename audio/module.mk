@@ -23,7 +23,9 @@ MODULE_OBJS := \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
+	prefetchstream.o \
 	rate.o \
+	rate_polyphase.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -45,6 +47,7 @@ MODULE_OBJS := \
 	decoders/wma.o \
 	decoders/xa.o \
 	decoders/xan_dpcm.o \
+	mix/mix.o \
 	mods/universaltracker.o \
 	mods/infogrames.o \
 	mods/maxtrax.o \
@@ -132,5 +135,18 @@ MODULE_OBJS += \
 	soundfont/vab/vab.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	mix/mix-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	mix/mix-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	mix/mix-avx2.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -0,0 +1,225 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/array.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+#include "audio/prefetchstream.h"
+
+namespace Audio {
+
+/**
+ * Keeps track of all prefetching streams and lets them decode ahead from a
+ * single timer callback, since a timer callback can only be installed once.
+ */
+class PrefetchScheduler : public Common::Singleton<PrefetchScheduler> {
+public:
+	PrefetchScheduler() : _installed(false) {}
+
+	void addStream(PrefetchingAudioStream *stream) {
+		{
+			Common::StackLock lock(_mutex);
+			_streams.push_back(stream);
+		}
+
+		// The timer is never removed again: streams are often deleted on
+		// the mixer thread, where waiting for the timer thread could dead
+		// lock. Without any streams, the callback returns right away.
+		if (!_installed) {
+			Common::TimerManager *timer = g_system ? g_system->getTimerManager() : nullptr;
+			if (timer)
+				_installed = timer->installTimerProc(&timerProc, 10000, this, "audioPrefetch");
+		}
+	}
+
+	void removeStream(PrefetchingAudioStream *stream) {
+		// Only protects the list: the stream itself waits for a chunk the
+		// timer thread may still be decoding into it.
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _streams.size(); i++) {
+			if (_streams[i] == stream) {
+				_streams.remove_at(i);
+				break;
+			}
+		}
+	}
+
+private:
+	static void timerProc(void *refCon) {
+		PrefetchScheduler *scheduler = (PrefetchScheduler *)refCon;
+
+		// Decode a single chunk per stream and tick, without holding the
+		// list lock while decoding. A stream is claimed while the list is
+		// locked, so it cannot be deleted before its chunk is done. Streams
+		// added or removed meanwhile may be skipped until the next tick.
+		for (uint i = 0; ; i++) {
+			PrefetchingAudioStream *stream;
+			{
+				Common::StackLock lock(scheduler->_mutex);
+				if (i >= scheduler->_streams.size())
+					break;
+
+				stream = scheduler->_streams[i];
+				stream->_decodeMutex.lock();
+			}
+
+			stream->decodeChunk();
+			stream->_decodeMutex.unlock();
+		}
+	}
+
+	Common::Mutex _mutex;
+	Common::Array<PrefetchingAudioStream *> _streams;
+	bool _installed;
+};
+
+PrefetchingAudioStream::PrefetchingAudioStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint32 prefetchTime)
+	: _parent(parent, disposeAfterUse), _ringRead(0), _ringFill(0), _parentEnded(parent->endOfData()) {
+	const int channels = parent->isStereo() ? 2 : 1;
+
+	// Keep at least one decode buffer worth of samples, in whole frames
+	_ringSize = (int)((uint64)parent->getRate() * prefetchTime / 1000) * channels;
+	_ringSize = MAX<int>(_ringSize, ARRAYSIZE(_decodeBuffer));
+	_ring = new int16[_ringSize];
+
+	PrefetchScheduler::instance().addStream(this);
+}
+
+PrefetchingAudioStream::~PrefetchingAudioStream() {
+	PrefetchScheduler::instance().removeStream(this);
+
+	// Wait for the timer thread, in case it is decoding into this stream
+	Common::StackLock decodeLock(_decodeMutex);
+	delete[] _ring;
+}
+
+int PrefetchingAudioStream::readRing(int16 *buffer, int numSamples) {
+	Common::StackLock lock(_ringMutex);
+
+	numSamples = MIN(numSamples, _ringFill);
+	int samples = 0;
+	while (samples < numSamples) {
+		const int len = MIN(numSamples - samples, _ringSize - _ringRead);
+		memcpy(buffer + samples, _ring + _ringRead, len * sizeof(int16));
+		samples += len;
+		_ringRead = (_ringRead + len) % _ringSize;
+	}
+	_ringFill -= samples;
+
+	return samples;
+}
+
+int PrefetchingAudioStream::readBuffer(int16 *buffer, const int numSamples) {
+	int samples = readRing(buffer, numSamples);
+	if (samples == numSamples)
+		return samples;
+
+	// The ring buffer ran empty, so decode the rest right here. If the timer
+	// thread is decoding right now, this waits for its single chunk, which
+	// is then read first.
+	Common::StackLock decodeLock(_decodeMutex);
+
+	samples += readRing(buffer + samples, numSamples - samples);
+	if (samples < numSamples && !_parentEnded) {
+		const int decoded = _parent->readBuffer(buffer + samples, numSamples - samples);
+		if (decoded > 0)
+			samples += decoded;
+
+		Common::StackLock ringLock(_ringMutex);
+		_parentEnded = _parent->endOfData();
+	}
+
+	return samples;
+}
+
+bool PrefetchingAudioStream::decodeChunk() {
+	int space;
+	{
+		Common::StackLock ringLock(_ringMutex);
+		if (_parentEnded)
+			return false;
+		space = _ringSize - _ringFill;
+	}
+
+	// Only the decoding owner adds data, so the free space can only grow
+	// until the decoded samples are copied below.
+	if (isStereo())
+		space &= ~1;
+	const int decoded = _parent->readBuffer(_decodeBuffer, MIN<int>(space, ARRAYSIZE(_decodeBuffer)));
+
+	Common::StackLock ringLock(_ringMutex);
+	_parentEnded = _parent->endOfData();
+
+	int written = 0;
+	while (written < decoded) {
+		const int writePos = (_ringRead + _ringFill) % _ringSize;
+		const int len = MIN(decoded - written, _ringSize - writePos);
+		memcpy(_ring + writePos, _decodeBuffer + written, len * sizeof(int16));
+		written += len;
+		_ringFill += len;
+	}
+
+	return decoded > 0 && !_parentEnded && _ringFill + (isStereo() ? 2 : 1) <= _ringSize;
+}
+
+void PrefetchingAudioStream::prefetch() {
+	Common::StackLock decodeLock(_decodeMutex);
+	while (decodeChunk())
+		;
+}
+
+int PrefetchingAudioStream::getPrefetchedSamples() const {
+	Common::StackLock lock(_ringMutex);
+	return _ringFill;
+}
+
+bool PrefetchingAudioStream::endOfData() const {
+	Common::StackLock lock(_ringMutex);
+	return _ringFill == 0 && _parentEnded;
+}
+
+bool PrefetchingAudioStream::seek(const Timestamp &where) {
+	Common::StackLock decodeLock(_decodeMutex);
+
+	const bool result = _parent->seek(where);
+
+	Common::StackLock ringLock(_ringMutex);
+	_ringRead = _ringFill = 0;
+	_parentEnded = _parent->endOfData();
+	return result;
+}
+
+SeekableAudioStream *makePrefetchingAudioStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint32 prefetchTime) {
+	if (!parent)
+		return nullptr;
+
+	return new PrefetchingAudioStream(parent, disposeAfterUse, prefetchTime);
+}
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PrefetchScheduler);
+}
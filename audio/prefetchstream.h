@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_PREFETCHSTREAM_H
+#define AUDIO_PREFETCHSTREAM_H
+
+#include "common/mutex.h"
+#include "common/ptr.h"
+
+#include "audio/audiostream.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_prefetchstream Prefetching audio stream
+ * @ingroup audio
+ *
+ * @brief Decode-ahead wrapper for expensive audio streams.
+ * @{
+ */
+
+enum {
+	/** Default amount of audio decoded ahead by a PrefetchingAudioStream, in milliseconds. */
+	kDefaultPrefetchTime = 250
+};
+
+/**
+ * A SeekableAudioStream which decodes its parent ahead of time on the
+ * timer thread and keeps the result in a ring buffer.
+ *
+ * Compressed formats like MP3 or Vorbis are otherwise decoded inside the
+ * mixer callback, where an expensive frame can make the output device run
+ * out of data. With this wrapper, readBuffer() only copies samples out of
+ * the ring buffer, and only decodes directly if the ring buffer ran empty.
+ *
+ * Seeking and rewinding discard whatever was decoded ahead.
+ *
+ * Manipulating the parent stream directly will break the prefetching stream.
+ */
+class PrefetchingAudioStream : public SeekableAudioStream {
+	friend class PrefetchScheduler;
+
+public:
+	/**
+	 * @param parent           The stream to decode ahead.
+	 * @param disposeAfterUse  Whether to delete the parent stream with this stream.
+	 * @param prefetchTime     How much audio to decode ahead, in milliseconds.
+	 */
+	PrefetchingAudioStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint32 prefetchTime = kDefaultPrefetchTime);
+	~PrefetchingAudioStream();
+
+	int readBuffer(int16 *buffer, const int numSamples) override;
+
+	bool isStereo() const override { return _parent->isStereo(); }
+	int getRate() const override { return _parent->getRate(); }
+	bool endOfData() const override;
+
+	bool seek(const Timestamp &where) override;
+	Timestamp getLength() const override { return _parent->getLength(); }
+
+	/**
+	 * Decode ahead until the ring buffer is full or the parent stream has
+	 * ended. The timer thread decodes a chunk at a time on its own, but this
+	 * may be called directly to fill the ring buffer right away.
+	 */
+	void prefetch();
+
+	/** Get the number of samples currently decoded ahead. */
+	int getPrefetchedSamples() const;
+
+private:
+	/** Copy up to @p numSamples samples out of the ring buffer. */
+	int readRing(int16 *buffer, int numSamples);
+
+	/**
+	 * Decode a single chunk into the ring buffer. Must only be called with
+	 * the decode mutex held.
+	 *
+	 * @return Whether there is room left for another chunk.
+	 */
+	bool decodeChunk();
+
+	Common::DisposablePtr<SeekableAudioStream> _parent;
+
+	/**
+	 * Protects the ring buffer state. Only held for copying samples, never
+	 * while decoding.
+	 */
+	mutable Common::Mutex _ringMutex;
+
+	/**
+	 * Held while someone decodes from the parent stream, so that the timer
+	 * thread, readBuffer() and seek() never use it at the same time. The
+	 * timer thread only holds it for a single chunk.
+	 */
+	Common::Mutex _decodeMutex;
+
+	int16 *_ring;
+	int _ringSize;
+	int _ringRead;
+	int _ringFill;
+
+	/** Whether the parent stream had no more data after the last decode. */
+	bool _parentEnded;
+
+	/** Samples decoded on the timer thread, before being copied into the ring buffer. */
+	int16 _decodeBuffer[2048];
+};
+
+/**
+ * Wrap a stream into a PrefetchingAudioStream.
+ *
+ * @param parent           The stream to decode ahead.
+ * @param disposeAfterUse  Whether to delete the parent stream with the new stream.
+ * @param prefetchTime     How much audio to decode ahead, in milliseconds.
+ *
+ * @return A new SeekableAudioStream.
+ */
+SeekableAudioStream *makePrefetchingAudioStream(SeekableAudioStream *parent, DisposeAfterUse::Flag disposeAfterUse, uint32 prefetchTime = kDefaultPrefetchTime);
+
+/** @} */
+
+} // End of namespace Audio
+
+#endif
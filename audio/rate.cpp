@@ -30,6 +30,7 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "audio/mix/mix.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -56,7 +57,7 @@ private:
 	 * but only until some point (depends largely on cache size, target
 	 * processor and various other factors), at which it will decrease again.
 	 */
-	st_sample_t _buffer[512];
+	st_sample_t _buffer[2048];
 
 	/** Current position inside the buffer */
 	const st_sample_t *_bufferPos;
@@ -64,6 +65,12 @@ private:
 	/** Size of data currently loaded into the buffer */
 	int _bufferSize;
 
+	/**
+	 * The resampled frames, before volume is applied and they are mixed
+	 * into the output buffer by SampleMixer.
+	 */
+	st_sample_t _mixBuffer[512];
+
 	/** How far output is ahead of input when doing simple conversion */
 	frac_t _outPos;
 
@@ -77,8 +84,8 @@ private:
 	st_sample_t _inCurL, _inCurR;
 
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
-	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
+	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples);
+	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples);
 
 public:
 	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
@@ -97,59 +104,39 @@ public:
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
-	st_sample_t *outStart, *outEnd;
-
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	st_size_t written = 0;
 
-	while (outBuffer < outEnd) {
+	while (written < numSamples) {
 		// Check if we have to refill the buffer
 		if (_bufferSize == 0) {
 			_bufferPos = _buffer;
-			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+			_bufferSize = input.readBuffer(_buffer, getReadSize(input, ARRAYSIZE(_buffer)));
 
 			if (_bufferSize <= 0)
-				return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				break;
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+		// Mix the data straight from the input cache into the output buffer
+		st_size_t frames = MIN<st_size_t>(numSamples - written, _bufferSize / (inStereo ? 2 : 1));
+		SampleMixer::mix(outBuffer + written * (outStereo ? 2 : 1), _bufferPos, frames, volL, volR, inStereo, outStereo, reverseStereo);
 
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		_bufferPos += frames * (inStereo ? 2 : 1);
+		_bufferSize -= frames * (inStereo ? 2 : 1);
+		written += frames;
 	}
 
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return written;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) {
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
 	st_sample_t *outStart, *outEnd;
 
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * (inStereo ? 2 : 1);
 
 	while (outBuffer < outEnd) {
 		// Read enough input samples so that _outPos >= 0
@@ -157,10 +144,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 			// Check if we have to refill the buffer
 			if (_bufferSize == 0) {
 				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+				_bufferSize = input.readBuffer(_buffer, getReadSize(input, ARRAYSIZE(_buffer)));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (outBuffer - outStart) / (inStereo ? 2 : 1);
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -171,43 +158,24 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 			}
 		} while (_outPos >= 0);
 
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
+		*outBuffer++ = *_bufferPos++;
+		if (inStereo)
+			*outBuffer++ = *_bufferPos++;
 
 		// Increment output position
 		_outPos += outPos_inc;
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (outBuffer - outStart) / (inStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
-int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples) {
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
 	st_sample_t *outStart, *outEnd;
 	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	outEnd = outBuffer + numSamples * (inStereo ? 2 : 1);
 
 	while (outBuffer < outEnd) {
 		// Read enough input samples so that _outPosFrac < 0
@@ -215,10 +183,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 			// Check if we have to refill the buffer
 			if (_bufferSize == 0) {
 				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+				_bufferSize = input.readBuffer(_buffer, getReadSize(input, ARRAYSIZE(_buffer)));
 
 				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+					return (outBuffer - outStart) / (inStereo ? 2 : 1);
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -237,36 +205,15 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 		// still space in the output buffer.
 		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
 			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
-			}
+			*outBuffer++ = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (inStereo)
+				*outBuffer++ = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
 			// Increment output position
 			_outPosFrac += outPos_inc;
 		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return (outBuffer - outStart) / (inStereo ? 2 : 1);
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -286,18 +233,59 @@ template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
 	assert(input.isStereo() == inStereo);
 
-	if (_inRate == _outRate) {
+	if (_inRate == _outRate)
 		return copyConvert(input, outBuffer, numSamples, volL, volR);
-	} else {
-		if ((_inRate % _outRate) == 0 && (_inRate < 65536)) {
-			return simpleConvert(input, outBuffer, numSamples, volL, volR);
-		} else {
-			return interpolateConvert(input, outBuffer, numSamples, volL, volR);
-		}
+
+	// Resample into the intermediate buffer, then apply the volume and mix
+	// the whole block at once
+	const st_size_t maxFrames = ARRAYSIZE(_mixBuffer) / (inStereo ? 2 : 1);
+	st_size_t written = 0;
+
+	while (written < numSamples) {
+		st_size_t frames = MIN<st_size_t>(numSamples - written, maxFrames);
+		st_size_t converted;
+
+		if ((_inRate % _outRate) == 0 && (_inRate < 65536))
+			converted = simpleConvert(input, _mixBuffer, frames);
+		else
+			converted = interpolateConvert(input, _mixBuffer, frames);
+
+		SampleMixer::mix(outBuffer + written * (outStereo ? 2 : 1), _mixBuffer, converted, volL, volR, inStereo, outStereo, reverseStereo);
+		written += converted;
+
+		if (converted < frames)
+			break;
 	}
+
+	return written;
+}
+
+int RateConverter::getReadSize(const AudioStream &input, int capacity) {
+	const int blockSize = input.getPreferredBlockSize();
+	if (blockSize <= 0 || blockSize > capacity)
+		return capacity;
+
+	// Never split a stereo frame
+	const int size = capacity - capacity % blockSize;
+	if (input.isStereo() && (size & 1))
+		return capacity;
+
+	return size;
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+// Defined in rate_polyphase.cpp
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+
+RateConverterType parseRateConverterType(const Common::String &name) {
+	if (name.equalsIgnoreCase("polyphase"))
+		return kRateConverterPolyphase;
+	return kRateConverterLinear;
+}
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterType type) {
+	if (type == kRateConverterPolyphase)
+		return makePolyphaseRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
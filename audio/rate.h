@@ -23,6 +23,7 @@
 #define AUDIO_RATE_H
 
 #include "common/frac.h"
+#include "common/str.h"
 
 namespace Audio {
 /**
@@ -102,9 +103,38 @@ public:
 	 * @return True if we need to drain, false otherwise
 	 */
 	virtual bool needsDraining() const = 0;
+
+protected:
+	/**
+	 * Get the number of samples to request from a stream to fill a buffer.
+	 *
+	 * The request is rounded down to a multiple of the stream's preferred
+	 * block size, as long as at least one whole block fits into the buffer.
+	 *
+	 * @param input		The AudioStream that will be read from.
+	 * @param capacity	The number of samples the buffer can hold.
+	 *
+	 * @return The number of samples to pass to AudioStream::readBuffer().
+	 */
+	static int getReadSize(const AudioStream &input, int capacity);
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * The resampling algorithms a RateConverter can use.
+ */
+enum RateConverterType {
+	kRateConverterLinear,   /*!< Nearest neighbour for integer ratios, linear interpolation otherwise. */
+	kRateConverterPolyphase /*!< Polyphase windowed-sinc FIR filter. */
+};
+
+/**
+ * Parse the value of the "audio_resampler" config key.
+ *
+ * @return The matching converter type, or kRateConverterLinear for unknown values.
+ */
+RateConverterType parseRateConverterType(const Common::String &name);
+
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, RateConverterType type = kRateConverterLinear);
 
 /** @} */
 } // End of namespace Audio
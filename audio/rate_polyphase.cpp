@@ -0,0 +1,351 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/mix/mix.h"
+
+#include "common/algorithm.h"
+#include "common/hashmap.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/util.h"
+
+#include <math.h>
+
+namespace Audio {
+
+enum {
+	/** Number of filter taps per phase, must be a multiple of 16. */
+	kPolyphaseTaps = 32,
+
+	/**
+	 * Maximum number of phases of a filter table. For conversion ratios
+	 * which do not reduce to at most that many phases, the nearest phase
+	 * is used.
+	 */
+	kPolyphaseMaxPhases = 1024,
+
+	/** Fixed point precision of the filter coefficients. */
+	kPolyphaseCoefBits = 14,
+
+	/** Number of input frames read from the stream at once. */
+	kPolyphaseBlockFrames = 512
+};
+
+/**
+ * Windowed-sinc filter coefficients for one conversion ratio, with one
+ * set of kPolyphaseTaps coefficients for each of the numPhases phases.
+ */
+struct PolyphaseTable {
+	uint numPhases;
+	uint step;
+	int16 *coefs;
+
+	PolyphaseTable(uint phases, uint inputStep);
+	~PolyphaseTable() { delete[] coefs; }
+
+	const int16 *getPhase(uint phase) const { return coefs + phase * kPolyphaseTaps; }
+};
+
+/** Zeroth order modified Bessel function of the first kind, used for the Kaiser window. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+PolyphaseTable::PolyphaseTable(uint phases, uint inputStep) : numPhases(phases), step(inputStep) {
+	const double beta = 8.0;
+	const double window = besselI0(beta);
+	// Cut off a little before the Nyquist frequency of the lower of both rates.
+	// Without any conversion, the filter is left as a plain delay instead.
+	const double cutoff = (numPhases == step) ? 1.0 : 0.9 * MIN<double>(1.0, (double)numPhases / step);
+
+	coefs = new int16[numPhases * kPolyphaseTaps];
+
+	for (uint phase = 0; phase < numPhases; phase++) {
+		double taps[kPolyphaseTaps];
+		double sum = 0.0;
+
+		for (int i = 0; i < kPolyphaseTaps; i++) {
+			// Distance between the output position and the input sample of this tap
+			double dist = (double)phase / numPhases + kPolyphaseTaps / 2 - 1 - i;
+			double x = dist / (kPolyphaseTaps / 2);
+			double sinc = (dist == 0.0) ? 1.0 : sin(M_PI * cutoff * dist) / (M_PI * cutoff * dist);
+			double kaiser = (x * x >= 1.0) ? 0.0 : besselI0(beta * sqrt(1.0 - x * x)) / window;
+
+			taps[i] = cutoff * sinc * kaiser;
+			sum += taps[i];
+		}
+
+		// Normalize every phase to unity gain, and put the rounding error
+		// on the largest tap so that constant signals pass unchanged.
+		int16 *dst = coefs + phase * kPolyphaseTaps;
+		int total = 0, largest = 0;
+		for (int i = 0; i < kPolyphaseTaps; i++) {
+			dst[i] = (int16)floor(taps[i] / sum * (1 << kPolyphaseCoefBits) + 0.5);
+			total += dst[i];
+			if (ABS(dst[i]) > ABS(dst[largest]))
+				largest = i;
+		}
+		dst[largest] += (1 << kPolyphaseCoefBits) - total;
+	}
+}
+
+typedef Common::SharedPtr<PolyphaseTable> PolyphaseTablePtr;
+
+/**
+ * Cache of the filter tables, so that channels using the same conversion
+ * ratio (which is by far the common case) share a single table.
+ */
+class PolyphaseTableCache : public Common::Singleton<PolyphaseTableCache> {
+public:
+	PolyphaseTablePtr getTable(uint phases, uint step) {
+		Common::StackLock lock(_mutex);
+
+		uint32 key = (phases << 16) | step;
+		TableMap::iterator i = _tables.find(key);
+		if (i != _tables.end())
+			return i->_value;
+
+		PolyphaseTablePtr table(new PolyphaseTable(phases, step));
+		_tables[key] = table;
+		return table;
+	}
+
+private:
+	typedef Common::HashMap<uint32, PolyphaseTablePtr> TableMap;
+
+	Common::Mutex _mutex;
+	TableMap _tables;
+};
+
+/**
+ * Rate converter using a polyphase windowed-sinc FIR filter.
+ *
+ * The input is pulled from the stream in blocks of kPolyphaseBlockFrames
+ * frames into a per channel history buffer, from which the output is
+ * computed with the SIMD dot product kernel of SampleMixer.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class PolyphaseRateConverter : public RateConverter {
+private:
+	/** Input and output rates */
+	st_rate_t _inRate, _outRate;
+
+	/** Filter table for the current rates */
+	PolyphaseTablePtr _table;
+
+	/** Input samples read from the stream, before being split into channels */
+	st_sample_t _readBuffer[kPolyphaseBlockFrames * 2];
+
+	/** History of the input samples, one buffer per channel */
+	st_sample_t _history[2][kPolyphaseBlockFrames + kPolyphaseTaps];
+
+	/** Number of frames in the history buffers */
+	uint _historySize;
+
+	/** Start of the filter window inside the history buffers */
+	uint _pos;
+
+	/**
+	 * Position of the output between two input samples, in units of
+	 * 1 / _numPhases input samples. The conversion ratio is _step / _numPhases.
+	 */
+	uint _phase, _numPhases, _step;
+
+	/** Whether the end of the stream has been padded with silence */
+	bool _flushed;
+
+	/** The resampled frames, before volume is applied */
+	st_sample_t _mixBuffer[512];
+
+	void updateTable();
+	bool fillHistory(AudioStream &input);
+
+public:
+	PolyphaseRateConverter(st_rate_t inputRate, st_rate_t outputRate);
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; }
+
+	st_rate_t getInputRate() const override { return _inRate; }
+	st_rate_t getOutputRate() const override { return _outRate; }
+
+	bool needsDraining() const override {
+		const int pending = (int)_historySize - (int)_pos;
+		if (_flushed)
+			return pending >= kPolyphaseTaps;
+		// Anything beyond the initial silence is still waiting to be output
+		return pending > kPolyphaseTaps / 2 - 1;
+	}
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+PolyphaseRateConverter<inStereo, outStereo, reverseStereo>::PolyphaseRateConverter(st_rate_t inputRate, st_rate_t outputRate) :
+	_inRate(inputRate), _outRate(outputRate), _pos(0), _phase(0), _numPhases(1), _step(1), _flushed(false) {
+	// Start with silence, so that the first output sample is centered on the first input sample
+	_historySize = kPolyphaseTaps / 2 - 1;
+	memset(_history, 0, sizeof(_history));
+	updateTable();
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void PolyphaseRateConverter<inStereo, outStereo, reverseStereo>::updateTable() {
+	const uint gcd = Common::gcd(_inRate, _outRate);
+	if (_table && _numPhases == _outRate / gcd && _step == _inRate / gcd)
+		return;
+
+	// Keep the position between the input samples when the rates change
+	_phase = (uint)((uint64)_phase * (_outRate / gcd) / _numPhases);
+	_numPhases = _outRate / gcd;
+	_step = _inRate / gcd;
+
+	uint phases = _numPhases;
+	uint step = _step;
+	if (phases > kPolyphaseMaxPhases) {
+		step = (uint)(((uint64)step * kPolyphaseMaxPhases + phases / 2) / phases);
+		phases = kPolyphaseMaxPhases;
+	}
+	step = CLIP<uint>(step, 1, 0xFFFF);
+
+	_table = PolyphaseTableCache::instance().getTable(phases, step);
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+bool PolyphaseRateConverter<inStereo, outStereo, reverseStereo>::fillHistory(AudioStream &input) {
+	// Move the samples still needed to the start of the history buffers.
+	// When downsampling, the window may already be past the end of them.
+	if (_pos < _historySize) {
+		for (uint ch = 0; ch < (inStereo ? 2 : 1); ch++)
+			memmove(_history[ch], _history[ch] + _pos, (_historySize - _pos) * sizeof(st_sample_t));
+		_historySize -= _pos;
+		_pos = 0;
+	} else {
+		_pos -= _historySize;
+		_historySize = 0;
+	}
+
+	const uint freeFrames = MIN<uint>(kPolyphaseBlockFrames + kPolyphaseTaps - _historySize, kPolyphaseBlockFrames);
+	int samples = input.readBuffer(_readBuffer, getReadSize(input, freeFrames * (inStereo ? 2 : 1)));
+
+	if (samples <= 0) {
+		// Once the stream has ended, pad with silence to output its tail
+		if (input.endOfStream() && !_flushed) {
+			for (uint ch = 0; ch < (inStereo ? 2 : 1); ch++)
+				memset(_history[ch] + _historySize, 0, (kPolyphaseTaps / 2) * sizeof(st_sample_t));
+			_historySize += kPolyphaseTaps / 2;
+			_flushed = true;
+			return true;
+		}
+		return false;
+	}
+
+	const uint frames = samples / (inStereo ? 2 : 1);
+	if (inStereo) {
+		for (uint i = 0; i < frames; i++) {
+			_history[0][_historySize + i] = _readBuffer[i * 2];
+			_history[1][_historySize + i] = _readBuffer[i * 2 + 1];
+		}
+	} else {
+		memcpy(_history[0] + _historySize, _readBuffer, frames * sizeof(st_sample_t));
+	}
+	_historySize += frames;
+
+	return true;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int PolyphaseRateConverter<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == inStereo);
+
+	updateTable();
+
+	const uint tablePhases = _table->numPhases;
+	const st_size_t maxFrames = ARRAYSIZE(_mixBuffer) / (inStereo ? 2 : 1);
+	st_size_t written = 0;
+	bool inputAvailable = true;
+
+	while (written < numSamples && inputAvailable) {
+		st_size_t frames = MIN<st_size_t>(numSamples - written, maxFrames);
+		st_size_t converted = 0;
+		st_sample_t *out = _mixBuffer;
+
+		while (converted < frames) {
+			if (_pos + kPolyphaseTaps > _historySize) {
+				if (!fillHistory(input)) {
+					inputAvailable = false;
+					break;
+				}
+				continue;
+			}
+
+			const int16 *coefs = _table->getPhase(tablePhases == _numPhases ? _phase : (uint)((uint64)_phase * tablePhases / _numPhases));
+			for (uint ch = 0; ch < (inStereo ? 2 : 1); ch++) {
+				int32 sum = SampleMixer::dotProduct(_history[ch] + _pos, coefs, kPolyphaseTaps);
+				sum = (sum + (1 << (kPolyphaseCoefBits - 1))) >> kPolyphaseCoefBits;
+				*out++ = (st_sample_t)CLIP<int32>(sum, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+			}
+			converted++;
+
+			_phase += _step;
+			_pos += _phase / _numPhases;
+			_phase %= _numPhases;
+		}
+
+		SampleMixer::mix(outBuffer + written * (outStereo ? 2 : 1), _mixBuffer, converted, volL, volR, inStereo, outStereo, reverseStereo);
+		written += converted;
+	}
+
+	return written;
+}
+
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				return new PolyphaseRateConverter<true, true, true>(inRate, outRate);
+			else
+				return new PolyphaseRateConverter<true, true, false>(inRate, outRate);
+		} else
+			return new PolyphaseRateConverter<true, false, false>(inRate, outRate);
+	} else {
+		if (outStereo) {
+			return new PolyphaseRateConverter<false, true, false>(inRate, outRate);
+		} else
+			return new PolyphaseRateConverter<false, false, false>(inRate, outRate);
+	}
+}
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PolyphaseTableCache);
+}
@@ -172,6 +172,17 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the time of the last modification of the file
+	 * referred by this node. This allows checking whether a file changed
+	 * without reading it.
+	 *
+	 * @param size  Set to the size of the file in bytes.
+	 * @param mtime Set to the last modification time, in seconds since the Unix epoch.
+	 * @return bool true if the information could be retrieved, false otherwise.
+	 */
+	virtual bool getFileInfo(int64 &size, int64 &mtime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -182,6 +193,18 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a SeekableReadStream instance corresponding to the file
+	 * referred by this node, which may hand out its contents in place
+	 * through borrowData(). Backends which cannot do this return a normal
+	 * read stream.
+	 *
+	 * The file must not be truncated while the stream is used.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableReadStream *createMappedReadStream() { return createReadStream(); }
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mmapstream.h"
+
+#ifdef HAS_MMAP
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/** Mappings are limited in size on 32-bit hosts to spare address space. */
+static const int64 kMaxMappedSize = sizeof(void *) >= 8 ? (int64)0x7FFFFFFF : 64 * 1024 * 1024;
+
+PosixMmapStream::Mapping::~Mapping() {
+	munmap(_addr, _size);
+}
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size < kMinMappedSize || st.st_size > kMaxMappedSize) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMmapStream(new Mapping(addr, (size_t)st.st_size), st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(Mapping *mapping, int64 size) :
+		_mapping(mapping), _data((const byte *)mapping->_addr), _size(size), _pos(0), _eos(false) {
+}
+
+bool PosixMmapStream::seek(int64 offs, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offs = _size + offs;
+		break;
+	case SEEK_CUR:
+		offs = _pos + offs;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offs < 0 || offs > _size)
+		return false;
+
+	_pos = offs;
+	_eos = false;
+	return true;
+}
+
+uint32 PosixMmapStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+Common::SharedPtr<byte> PosixMmapStream::borrowData(uint32 dataSize) {
+	if (dataSize > _size - _pos)
+		return Common::SharedPtr<byte>();
+
+	byte *data = const_cast<byte *>(_data + _pos);
+	_pos += dataSize;
+
+	return Common::SharedPtr<byte>(data, MappingReference(_mapping));
+}
+
+#endif
@@ -0,0 +1,92 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMMAPSTREAM_H
+
+#include "common/scummsys.h"
+
+#ifdef HAS_MMAP
+
+#include "common/noncopyable.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "common/str.h"
+
+/**
+ * A read-only file stream backed by a memory mapping of the whole file.
+ *
+ * Reads are plain memory copies, and the contents can be borrowed
+ * without any copy through borrowData(). The mapping is kept alive
+ * until both the stream and all borrowed data have been released.
+ */
+class PosixMmapStream final : public Common::SeekableReadStream, public Common::NonCopyable {
+public:
+	/** Files smaller than this are cheaper to read through stdio. */
+	static const int64 kMinMappedSize = 256 * 1024;
+
+	/**
+	 * Map the file at the given path.
+	 *
+	 * @return The stream, or nullptr if the file is smaller than
+	 *         @ref kMinMappedSize or could not be mapped.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offs, int whence = SEEK_SET) override;
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	Common::SharedPtr<byte> borrowData(uint32 dataSize) override;
+
+private:
+	struct Mapping {
+		Mapping(void *addr, size_t size) : _addr(addr), _size(size) {}
+		~Mapping();
+
+		void *_addr;
+		size_t _size;
+	};
+
+	/** Keeps the mapping alive for as long as borrowed data is referenced. */
+	struct MappingReference {
+		MappingReference(const Common::SharedPtr<Mapping> &mapping) : _mapping(mapping) {}
+		void operator()(byte *) {}
+
+		Common::SharedPtr<Mapping> _mapping;
+	};
+
+	PosixMmapStream(Mapping *mapping, int64 size);
+
+	Common::SharedPtr<Mapping> _mapping;
+	const byte *_data;
+	int64 _size;
+	int64 _pos;
+	bool _eos;
+};
+
+#endif
+
+#endif
@@ -49,14 +49,14 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/saves/default/default-saves.h"
+#include "backends/timer/default/default-timer.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
-#include "backends/saves/default/default-saves.h"
-#include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
 
@@ -89,6 +89,11 @@ public:
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
 	virtual void quit();
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
@@ -119,6 +124,12 @@ OSystem_NULL::OSystem_NULL(bool silenceLogs) :
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// Tests never call initBackend(), but code like the video decoders
+	// still asks for the screen format
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -225,6 +236,23 @@ void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 	td.tm_wday = t.tm_wday;
 }
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	// Created on first use, since its mutex needs g_system. Nothing calls
+	// the timer procs on their own, tests run them directly.
+	if (!_timerManager)
+		_timerManager = new DefaultTimerManager();
+	return _timerManager;
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	// Tests set the save path before using it
+	if (!_savefileManager)
+		_savefileManager = new DefaultSaveFileManager();
+	return _savefileManager;
+}
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 void OSystem_NULL::quit() {
 	exit(0);
@@ -37,6 +37,9 @@
 #include "common/archive.h"
 #include "common/config-manager.h"
 #include "common/compression/deflate.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/timer.h"
 
 #include <errno.h>	// for removeSavefile()
 
@@ -44,13 +47,89 @@
 const char *const DefaultSaveFileManager::TIMESTAMPS_FILENAME = "timestamps";
 #endif
 
-DefaultSaveFileManager::DefaultSaveFileManager() {
+namespace {
+
+/** Suffix of the metadata index files, which live next to the saves. */
+const char *const kSaveIndexSuffix = ".saveindex";
+
+/** Bytes of a pending save to compress and write per tick of the 10 ms timer. */
+const uint32 kPendingSaveBytesPerTick = 16 * 1024;
+const uint32 kSaveIndexVersion = 2;
+
+/**
+ * A save file which is serialized in memory, and handed to the save file
+ * manager for writing in the background once it is finalized or deleted.
+ */
+class AsyncOutSaveFile : public Common::OutSaveFile {
+public:
+	AsyncOutSaveFile(DefaultSaveFileManager *manager, const Common::FSNode &fileNode, Common::WriteStream *fileStream) :
+		Common::OutSaveFile(new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO)),
+		_manager(manager), _fileNode(fileNode), _fileStream(fileStream) {
+	}
+
+	~AsyncOutSaveFile() override {
+		queue();
+	}
+
+	void finalize() override {
+		queue();
+	}
+
+	bool err() const override {
+		// Failing to write the file only shows once it has been written.
+		// Never wait for that here, engines check err() right after
+		// finalize(). The save file manager warns about late failures.
+		if (_failed && *_failed)
+			return true;
+		return Common::OutSaveFile::err();
+	}
+
+	void clearErr() override {
+		if (_failed)
+			*_failed = false;
+		Common::OutSaveFile::clearErr();
+	}
+
+private:
+	void queue() {
+		if (!_fileStream)
+			return;
+
+		Common::MemoryWriteStreamDynamic *memory = static_cast<Common::MemoryWriteStreamDynamic *>(_wrapped);
+		_failed = _manager->queueSave(_fileNode, _fileStream, memory->getData(), memory->size());
+		_fileStream = nullptr;
+
+		// The data belongs to the save file manager now, ignore further writes
+		delete _wrapped;
+		_wrapped = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+	}
+
+	DefaultSaveFileManager *_manager;
+	Common::FSNode _fileNode;
+	Common::WriteStream *_fileStream;
+	Common::SharedPtr<bool> _failed;
+};
+
+} // End of anonymous namespace
+
+DefaultSaveFileManager::DefaultSaveFileManager() : _pendingSavesTimerInstalled(false) {
 }
 
-DefaultSaveFileManager::DefaultSaveFileManager(const Common::Path &defaultSavepath) {
+DefaultSaveFileManager::DefaultSaveFileManager(const Common::Path &defaultSavepath) : _pendingSavesTimerInstalled(false) {
 	ConfMan.registerDefault("savepath", defaultSavepath);
 }
 
+DefaultSaveFileManager::~DefaultSaveFileManager() {
+	waitForPendingSaves();
+
+	// The timer manager may be gone already when the backend shuts down
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+	if (_pendingSavesTimerInstalled && timerManager)
+		timerManager->removeTimerProc(&pendingSavesTimerProc);
+
+	flushSaveIndexes();
+}
+
 
 void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	clearError();
@@ -84,6 +163,9 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 
 	Common::StringArray results;
 	for (SaveFileCache::const_iterator file = _saveFileCache.begin(), end = _saveFileCache.end(); file != end; ++file) {
+		if (file->_key.hasSuffixIgnoreCase(kSaveIndexSuffix))
+			continue;
+
 		if (!locked.contains(file->_key) && file->_key.matchString(pattern, true)) {
 			results.push_back(file->_key);
 		}
@@ -92,6 +174,8 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openRawFile(const Common::String &filename) {
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -108,6 +192,8 @@ Common::InSaveFile *DefaultSaveFileManager::openRawFile(const Common::String &fi
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String &filename) {
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -130,6 +216,9 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 }
 
 Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
+	// Writing the same file twice at once would mix up the data
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	const Common::Path savePathName = getSavePath();
 	assureCached(savePathName);
@@ -149,6 +238,8 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	saveTimestamps(timestamps);
 #endif
 
+	invalidateSaveIndexEntries(filename);
+
 	// Obtain node.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
 	Common::FSNode fileNode;
@@ -161,11 +252,26 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 		fileNode = file->_value;
 	}
 
+	// Let the engine serialize into memory, compression and writing happen
+	// in the background. Everything reading save files, including the cloud
+	// sync uploading them, waits for pending saves first.
+	if (ConfMan.getBool("async_saves") && g_system->getTimerManager()) {
+		// The write stream is atomic, an interrupted write does not destroy
+		// an existing save
+		Common::WriteStream *const sf = fileNode.createWriteStream();
+		if (!sf)
+			return nullptr;
+
+		_saveFileCache[filename] = Common::FSNode(fileNode.getPath());
+
+		return new AsyncOutSaveFile(this, fileNode, compress ? Common::wrapCompressedWriteStream(sf, ConfMan.getInt("save_compression_level")) : sf);
+	}
+
 	// Open the file for saving.
 	Common::SeekableWriteStream *const sf = fileNode.createWriteStream();
 	if (!sf)
 		return nullptr;
-	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? Common::wrapCompressedWriteStream(sf) : sf);
+	Common::OutSaveFile *const result = new Common::OutSaveFile(compress ? Common::wrapCompressedWriteStream(sf, ConfMan.getInt("save_compression_level")) : sf);
 
 	// Add file to cache now that it exists.
 	_saveFileCache[filename] = Common::FSNode(fileNode.getPath());
@@ -174,6 +280,8 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 }
 
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
+	waitForPendingSaves();
+
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
 	if (getError().getCode() != Common::kNoError)
@@ -189,6 +297,8 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 #endif
 
+	invalidateSaveIndexEntries(filename);
+
 	// Obtain node if exists.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
 	if (file == _saveFileCache.end()) {
@@ -219,6 +329,213 @@ Common::ErrorCode DefaultSaveFileManager::removeFile(const Common::FSNode &fileN
 	return Common::kUnknownError;
 }
 
+bool DefaultSaveFileManager::hasPendingSaves() {
+	Common::StackLock lock(_pendingSavesMutex);
+	return !_pendingSaves.empty();
+}
+
+void DefaultSaveFileManager::waitForPendingSaves() {
+	Common::StackLock lock(_pendingSavesMutex);
+	while (!_pendingSaves.empty())
+		writePendingSave(0xFFFFFFFF);
+}
+
+Common::SharedPtr<bool> DefaultSaveFileManager::queueSave(const Common::FSNode &fileNode, Common::WriteStream *stream, byte *data, uint32 size) {
+	// Install the timer first, the timer manager holds its own lock while
+	// calling into pendingSavesTimerProc
+	if (!_pendingSavesTimerInstalled)
+		_pendingSavesTimerInstalled = g_system->getTimerManager()->installTimerProc(&pendingSavesTimerProc, 10000, this, "pendingSaves");
+
+	PendingSave save;
+	save.fileNode = fileNode;
+	save.stream = stream;
+	save.data = data;
+	save.size = size;
+	save.written = 0;
+	save.failed = Common::SharedPtr<bool>(new bool(false));
+
+	Common::StackLock lock(_pendingSavesMutex);
+	_pendingSaves.push_back(save);
+	return save.failed;
+}
+
+void DefaultSaveFileManager::pendingSavesTimerProc(void *refCon) {
+	DefaultSaveFileManager *manager = (DefaultSaveFileManager *)refCon;
+
+	// Compress in small steps, this shares the timer thread with the audio
+	// prefetching and networking
+	Common::StackLock lock(manager->_pendingSavesMutex);
+	if (!manager->_pendingSaves.empty())
+		manager->writePendingSave(kPendingSaveBytesPerTick);
+}
+
+void DefaultSaveFileManager::writePendingSave(uint32 maxBytes) {
+	PendingSave &save = _pendingSaves.front();
+
+	uint32 len = MIN(maxBytes, save.size - save.written);
+	if (len)
+		save.stream->write(save.data + save.written, len);
+	save.written += len;
+
+	if (save.written < save.size)
+		return;
+
+	save.stream->finalize();
+	if (save.stream->err()) {
+		warning("DefaultSaveFileManager: Failed to write saved game '%s'", save.fileNode.getName().c_str());
+		*save.failed = true;
+	}
+	delete save.stream;
+
+	free(save.data);
+	_pendingSaves.pop_front();
+}
+
+Common::SeekableReadStream *DefaultSaveFileManager::readSaveIndexEntry(const Common::String &target, const Common::String &filename) {
+	SaveIndex &index = getSaveIndex(target);
+	if (!index.entries.contains(filename))
+		return nullptr;
+
+	SaveIndexEntry &entry = index.entries[filename];
+	const int64 fileSize = entry.fileSize;
+	if (!checkSaveFingerprint(filename, entry)) {
+		// The save file changed behind our back
+		index.entries.erase(filename);
+		index.dirty = true;
+		return nullptr;
+	}
+	if (fileSize != entry.fileSize)
+		index.dirty = true;
+
+	byte *data = (byte *)malloc(entry.data.size());
+	if (!data)
+		return nullptr;
+	memcpy(data, entry.data.data(), entry.data.size());
+	return new Common::MemoryReadStream(data, entry.data.size(), DisposeAfterUse::YES);
+}
+
+void DefaultSaveFileManager::writeSaveIndexEntry(const Common::String &target, const Common::String &filename, const byte *data, uint32 size) {
+	// Entries are usually updated right after saving, when the save file
+	// may still be written in the background
+	SaveIndexEntry entry;
+	if (hasPendingSaves()) {
+		entry.fileSize = -1;
+		entry.mtime = -1;
+	} else if (!getSaveFingerprint(filename, entry.fileSize, entry.mtime)) {
+		return;
+	}
+	entry.data.resize(size);
+	memcpy(entry.data.data(), data, size);
+
+	SaveIndex &index = getSaveIndex(target);
+	index.entries[filename] = entry;
+	index.dirty = true;
+}
+
+void DefaultSaveFileManager::flushSaveIndexes() {
+	for (Common::HashMap<Common::String, SaveIndex>::iterator i = _saveIndexes.begin(); i != _saveIndexes.end(); ++i) {
+		SaveIndex &index = i->_value;
+		if (!index.dirty)
+			continue;
+		index.dirty = false;
+
+		for (SaveIndex::EntryMap::iterator entry = index.entries.begin(); entry != index.entries.end(); ++entry) {
+			if (entry->_value.fileSize == -1 && !checkSaveFingerprint(entry->_key, entry->_value))
+				index.entries.erase(entry);
+		}
+
+		Common::WriteStream *out = Common::FSNode(Common::Path(i->_key)).createWriteStream();
+		if (!out) {
+			warning("DefaultSaveFileManager: Failed to write save index '%s'", i->_key.c_str());
+			continue;
+		}
+		out = Common::wrapCompressedWriteStream(out);
+
+		out->writeUint32BE(MKTAG('S', 'V', 'I', 'X'));
+		out->writeUint32LE(kSaveIndexVersion);
+		out->writeUint32LE(index.entries.size());
+		for (SaveIndex::EntryMap::const_iterator entry = index.entries.begin(); entry != index.entries.end(); ++entry) {
+			out->writeUint16LE(entry->_key.size());
+			out->writeString(entry->_key);
+			out->writeSint64LE(entry->_value.fileSize);
+			out->writeSint64LE(entry->_value.mtime);
+			out->writeUint32LE(entry->_value.data.size());
+			out->write(entry->_value.data.data(), entry->_value.data.size());
+		}
+
+		out->finalize();
+		if (out->err())
+			warning("DefaultSaveFileManager: Failed to write save index '%s'", i->_key.c_str());
+		delete out;
+	}
+}
+
+DefaultSaveFileManager::SaveIndex &DefaultSaveFileManager::getSaveIndex(const Common::String &target) {
+	const Common::Path indexPath = getSavePath().join(target + kSaveIndexSuffix);
+	const Common::String indexKey = indexPath.toString();
+	if (_saveIndexes.contains(indexKey))
+		return _saveIndexes[indexKey];
+
+	SaveIndex &index = _saveIndexes[indexKey];
+	index.dirty = false;
+
+	const Common::FSNode indexNode(indexPath);
+	if (!indexNode.exists())
+		return index;
+
+	Common::ScopedPtr<Common::SeekableReadStream> in(Common::wrapCompressedReadStream(indexNode.createReadStream()));
+	if (!in || in->readUint32BE() != MKTAG('S', 'V', 'I', 'X') || in->readUint32LE() != kSaveIndexVersion)
+		return index;
+
+	const uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count; i++) {
+		const Common::String filename = in->readString(0, in->readUint16LE());
+		SaveIndexEntry entry;
+		entry.fileSize = in->readSint64LE();
+		entry.mtime = in->readSint64LE();
+		const uint32 size = in->readUint32LE();
+		if (in->eos() || in->err() || size > in->size() - in->pos())
+			break;
+
+		entry.data.resize(size);
+		if (in->read(entry.data.data(), size) != size)
+			break;
+		index.entries[filename] = entry;
+	}
+
+	return index;
+}
+
+bool DefaultSaveFileManager::getSaveFingerprint(const Common::String &filename, int64 &fileSize, int64 &mtime) {
+	waitForPendingSaves();
+
+	assureCached(getSavePath());
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return false;
+
+	return file->_value.getFileInfo(fileSize, mtime);
+}
+
+bool DefaultSaveFileManager::checkSaveFingerprint(const Common::String &filename, SaveIndexEntry &entry) {
+	if (entry.fileSize == -1)
+		return getSaveFingerprint(filename, entry.fileSize, entry.mtime);
+
+	int64 fileSize, mtime;
+	return getSaveFingerprint(filename, fileSize, mtime) && fileSize == entry.fileSize && mtime == entry.mtime;
+}
+
+void DefaultSaveFileManager::invalidateSaveIndexEntries(const Common::String &filename) {
+	// The target of the save file is not known. Indexes which are not loaded
+	// yet notice the change through the fingerprint of the entry.
+	for (Common::HashMap<Common::String, SaveIndex>::iterator i = _saveIndexes.begin(); i != _saveIndexes.end(); ++i) {
+		if (i->_value.entries.contains(filename)) {
+			i->_value.entries.erase(filename);
+			i->_value.dirty = true;
+		}
+	}
+}
+
 bool DefaultSaveFileManager::exists(const Common::String &filename) {
 	// Assure the savefile name cache is up-to-date.
 	assureCached(getSavePath());
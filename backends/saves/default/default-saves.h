@@ -23,18 +23,31 @@
 #define BACKEND_SAVES_DEFAULT_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/fs.h"
 #include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+
+#ifdef CXXTEST_RUNNING
+class DefaultSavesTestSuite;
+#endif
 
 /**
  * Provides a default savefile manager implementation for common platforms.
  */
 class DefaultSaveFileManager : public Common::SaveFileManager {
+#ifdef CXXTEST_RUNNING
+	friend class ::DefaultSavesTestSuite;
+#endif
+
 public:
 	DefaultSaveFileManager();
 	DefaultSaveFileManager(const Common::Path &defaultSavepath);
+	~DefaultSaveFileManager() override;
 
 	void updateSavefilesList(Common::StringArray &lockedFiles) override;
 	Common::StringArray listSavefiles(const Common::String &pattern) override;
@@ -44,6 +57,24 @@ public:
 	bool removeSavefile(const Common::String &filename) override;
 	bool exists(const Common::String &filename) override;
 
+	bool hasPendingSaves() override;
+	void waitForPendingSaves() override;
+
+	/**
+	 * Queue a save file serialized in memory for writing in the background.
+	 * The stream, opened for fileNode, and the data, allocated with malloc(),
+	 * are owned by the save file manager from now on.
+	 *
+	 * @return A flag which is set if writing the save file failed. It is set
+	 *         from the timer thread, and only final once hasPendingSaves()
+	 *         returns false.
+	 */
+	Common::SharedPtr<bool> queueSave(const Common::FSNode &fileNode, Common::WriteStream *stream, byte *data, uint32 size);
+
+	Common::SeekableReadStream *readSaveIndexEntry(const Common::String &target, const Common::String &filename) override;
+	void writeSaveIndexEntry(const Common::String &target, const Common::String &filename, const byte *data, uint32 size) override;
+	void flushSaveIndexes() override;
+
 #ifdef USE_LIBCURL
 
 	static const uint32 INVALID_TIMESTAMP = UINT_MAX;
@@ -104,6 +135,71 @@ private:
 	 * The currently cached directory.
 	 */
 	Common::Path _cachedDirectory;
+
+	/** A save file waiting to be written in the background. */
+	struct PendingSave {
+		Common::FSNode fileNode;
+		Common::WriteStream *stream;
+		byte *data;
+		uint32 size;
+		uint32 written;
+		Common::SharedPtr<bool> failed;
+	};
+
+	/** Save files to write, the first one is being written. */
+	Common::List<PendingSave> _pendingSaves;
+	Common::Mutex _pendingSavesMutex;
+	bool _pendingSavesTimerInstalled;
+
+	static void pendingSavesTimerProc(void *refCon);
+
+	/**
+	 * Write up to maxBytes of the first pending save.
+	 * Must be called with the pending saves mutex held.
+	 */
+	void writePendingSave(uint32 maxBytes);
+
+	/** Cached metadata of a save file, see readSaveIndexEntry(). */
+	struct SaveIndexEntry {
+		int64 fileSize; ///< -1 while the save file was still being written
+		int64 mtime;
+		Common::Array<byte> data;
+	};
+
+	/** The metadata index of a target, stored as a file next to its saves. */
+	struct SaveIndex {
+		typedef Common::HashMap<Common::String, SaveIndexEntry, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> EntryMap;
+		EntryMap entries;
+		bool dirty;
+	};
+
+	/** The metadata indexes loaded so far, by the path of their file. */
+	Common::HashMap<Common::String, SaveIndex> _saveIndexes;
+
+	/**
+	 * Get the metadata index of a target in the current save path, and
+	 * load it if needed.
+	 */
+	SaveIndex &getSaveIndex(const Common::String &target);
+
+	/**
+	 * Get the size and modification time of a save file, which tell whether
+	 * it changed since its index entry was stored, without reading it.
+	 *
+	 * @return false if the save file does not exist, or the file system
+	 *         does not tell.
+	 */
+	bool getSaveFingerprint(const Common::String &filename, int64 &fileSize, int64 &mtime);
+
+	/**
+	 * Check whether a save file did not change since its index entry was
+	 * stored. Entries stored while their save file was still being written
+	 * get the fingerprint of the finished file.
+	 */
+	bool checkSaveFingerprint(const Common::String &filename, SaveIndexEntry &entry);
+
+	/** Drop the index entries of a save file which is about to change. */
+	void invalidateSaveIndexEntries(const Common::String &filename);
 };
 
 #endif
@@ -74,8 +74,9 @@ int64 OutSaveFile::size() const {
 	if (sws) {
 		return sws->size();
 	} else {
-		warning("Size isn't supported for compressed save files");
-		return -1;
+		// Compressed save files can only be appended to, so everything
+		// written so far is their uncompressed size
+		return _wrapped->pos();
 	}
 }
 
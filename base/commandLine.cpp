@@ -345,6 +345,8 @@ void registerDefaults() {
 	ConfMan.registerDefault("dump_scripts", false);
 	ConfMan.registerDefault("save_slot", -1);
 	ConfMan.registerDefault("autosave_period", 5 * 60); // By default, trigger autosave every 5 minutes
+	ConfMan.registerDefault("async_saves", true);
+	ConfMan.registerDefault("save_compression_level", -1); // zlib default
 	ConfMan.registerDefault("engine_speed", 60); // FPS limit for 3D games
 
 #if defined(ENABLE_SCUMM) || defined(ENABLE_SWORD2)
@@ -1427,7 +1429,7 @@ static Common::Error listSaves(const Common::String &singleTarget) {
 		}
 
 		// Query the plugin for a list of saved games
-		SaveStateList saveList = metaEngine.listSaves(i->target.c_str());
+		SaveStateList saveList = metaEngine.listSaves(i->target.c_str(), false);
 
 		if (!saveList.empty()) {
 			// TODO: Include more info about the target (desc, engine name, ...) ???
@@ -32,6 +32,7 @@
 
 #include "engines/engine.h"
 #include "engines/metaengine.h"
+#include "engines/advancedDetector.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
 #include "base/version.h"
@@ -323,6 +324,9 @@ static Common::Error runGame(const Plugin *enginePlugin, OSystem &system, const
 	// Free up memory
 	metaEngine.deleteInstance(engine, game, meDescriptor);
 
+	// Make sure the last saves are on disk before going back to the launcher
+	system.getSavefileManager()->waitForPendingSaves();
+
 	// Reset the file/directory mappings
 	SearchMan.clear();
 
@@ -519,6 +523,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		if (res.getCode() != Common::kNoError)
 			warning("%s", res.getDesc().c_str());
 
+		AdvancedDetectorCacheManager::destroy();
 		PluginManager::destroy();
 
 		return res.getCode();
@@ -890,6 +895,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	AdvancedDetectorCacheManager::destroy();
 	PluginManager::destroy();
 	GUI::GuiManager::destroy();
 	Common::ConfigManager::destroy();
@@ -709,6 +709,8 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
+	ADCacheMan.clearFileMaps();
+	ADCacheMan.flushPersistentCache();
 
 	return DetectionResults(candidates);
 }
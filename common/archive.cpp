@@ -340,6 +340,38 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
+}
+
+void SearchSet::buildIndex() const {
+	_index.clear(true);
+
+	// Walk in ascending priority, so that higher priority archives
+	// overwrite the entries of the ones they shadow
+	for (ArchiveNodeList::const_iterator it = _list.reverse_begin(); it != _list.end(); --it) {
+		ArchiveMemberList members;
+		it->_arc->listMembers(members);
+
+		for (ArchiveMemberList::const_iterator m = members.begin(); m != members.end(); ++m) {
+			if ((*m)->isDirectory())
+				continue;
+
+			_index.setVal((*m)->getPathInArchive().normalize(), it->_arc);
+		}
+	}
+
+	_indexValid = true;
+}
+
+Archive *SearchSet::findIndexedArchive(const Path &path) const {
+	if (!_indexValid)
+		buildIndex();
+
+	MemberIndex::const_iterator i = _index.find(path.normalize());
+	if (i == _index.end())
+		return nullptr;
+
+	return i->_value;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -430,6 +462,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -453,6 +486,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -475,6 +509,9 @@ bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
+	if (_indexEnabled)
+		return findIndexedArchive(path) != nullptr;
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		if (it->_arc->hasFile(path))
@@ -560,6 +597,16 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
+	if (_indexEnabled) {
+		Archive *arc = findIndexedArchive(path);
+		if (!arc)
+			return ArchiveMemberPtr();
+
+		if (container)
+			*container = arc;
+		return arc->getMember(path);
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		if (it->_arc->hasFile(path)) {
@@ -581,6 +628,11 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	if (_indexEnabled) {
+		Archive *arc = findIndexedArchive(path);
+		return arc ? arc->createReadStreamForMember(path) : nullptr;
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
@@ -244,6 +244,10 @@ public:
 	SharedArchiveContents(byte *contents, uint32 contentSize) :
 		_strongRef(contents, ArrayDeleter<byte>()), _weakRef(_strongRef),
 		_contentSize(contentSize), _missingFile(false), _bypass(nullptr) {}
+	/** Share contents owned elsewhere, e.g. borrowed from a memory mapped file. */
+	SharedArchiveContents(const SharedPtr<byte> &contents, uint32 contentSize) :
+		_strongRef(contents), _weakRef(_strongRef),
+		_contentSize(contentSize), _missingFile(false), _bypass(nullptr) {}
 	SharedArchiveContents() : _strongRef(nullptr), _weakRef(nullptr), _contentSize(0), _missingFile(true), _bypass(nullptr) {}
 	static SharedArchiveContents bypass(SeekableReadStream *stream) {
 		return SharedArchiveContents(stream);
@@ -348,8 +352,17 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	typedef HashMap<Path, Archive *, Path::IgnoreCase_Hash, Path::IgnoreCase_EqualTo> MemberIndex;
+	mutable MemberIndex _index;  //!< Maps each member path to the first archive containing it.
+	mutable bool _indexValid;
+	bool _indexEnabled;
+
+	void invalidateIndex() { _indexValid = false; _index.clear(true); }
+	void buildIndex() const;
+	Archive *findIndexedArchive(const Path &path) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _ignoreClashes(false), _indexValid(false), _indexEnabled(false) { }
 	virtual ~SearchSet() { clear(); }
 
 	char getPathSeparator() const override { return '/'; }
@@ -477,6 +490,26 @@ public:
 	 */
 	void setIgnoreClashes(bool ignoreClashes) { _ignoreClashes = ignoreClashes; }
 
+	/**
+	 * Use a merged index of the members of all archives for lookups.
+	 *
+	 * When enabled, hasFile, getMember and createReadStreamForMember find the
+	 * archive owning a path with a single case-insensitive hash lookup instead
+	 * of querying every archive in priority order. The index is built from
+	 * listMembers on first use and rebuilt after archives are added, removed
+	 * or reprioritized.
+	 *
+	 * Only enable this when the contents of the archives do not change while
+	 * they are in the set, and when their listMembers reports every file they
+	 * can open. Call @ref refreshIndex if an archive changes anyway.
+	 */
+	void setIndexed(bool indexed) { _indexEnabled = indexed; invalidateIndex(); }
+
+	/**
+	 * Drop the member index, so that it gets rebuilt on the next lookup.
+	 */
+	void refreshIndex() { invalidateIndex(); }
+
 	bool getChildren(const Common::Path &path, Common::Array<Common::String> &list, ListMode mode = kListDirectoriesOnly, bool hidden = true) const override;
 };
 
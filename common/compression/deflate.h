@@ -177,8 +177,12 @@ SeekableReadStream *wrapClickteamReadStream(SeekableReadStream *toBeWrapped,
  *
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
+ *
+ * @param toBeWrapped	the stream to be wrapped
+ * @param level	the compression level, from 1 (fastest) to 9 (smallest),
+ *              or -1 for the zlib default
  */
-WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped);
+WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped, int level = -1);
 
 /** @} */
 
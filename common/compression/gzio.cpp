@@ -34,6 +34,7 @@
    comments to that effect with your name and the date.  Thank you.
  */
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/endian.h"
 #include "common/stream.h"
@@ -224,7 +225,8 @@ public:
 		_inflateD(0), _bb(0), _bk(0), _wp(0), _tl(nullptr),
 		_td(nullptr), _bl(0),
 		_bd(0), _savedOffset(0), _err(false), _mode(mode), _input(parent, disposeParent),
-		_inbufD(0), _inbufSize(0), _uncompressedSize(uncompressedSize), _streamPos(0), _eos(false) {
+		_inbufD(0), _inbufSize(0), _uncompressedSize(uncompressedSize), _streamPos(0), _eos(false),
+		_numLitCodes(0), _numDistCodes(0) {
 
 		if (dict && dict_size) {
 			dict_size = MIN<uint32>(dict_size, sizeof(_slide));
@@ -232,6 +234,8 @@ public:
 		}
 	}
 
+	~GzioReadStream();
+
 	uint32 read(void *dataPtr, uint32 dataSize) override;
 
 	bool eos() const override { return _eos; }
@@ -239,7 +243,7 @@ public:
 	void clearErr() override { _eos = false; _err = false; }
 
 	int64 pos() const override { return _streamPos; }
-	int64 size() const override { return _uncompressedSize; }
+	int64 size() const override;
 
 	bool seek(int64 offs, int whence = SEEK_SET) override;
 
@@ -257,6 +261,12 @@ private:
 	static const int WSIZE = 0x8000;
 	static const int INBUFSIZ = 0x2000;
 
+	/*
+	 *  A window is saved about every CHECKPOINT_SPAN bytes of uncompressed
+	 *  data, so seeking backwards does not have to restart at the beginning.
+	 */
+	static const int CHECKPOINT_SPAN = 0x100000;
+
 	/* If input is in memory following fields are used instead of file.  */
 	Common::DisposablePtr<Common::SeekableReadStream> _input;
 	/* The offset at which the data starts in the underlying file.  */
@@ -302,6 +312,35 @@ private:
 	uint64 _streamPos;
 	bool _eos;
 
+	/* The code lengths of the current dynamic block.  */
+	unsigned _codeLengths[286 + 30];
+	unsigned _numLitCodes;
+	unsigned _numDistCodes;
+
+	/* The decompression state right after a full window was inflated.  */
+	struct Checkpoint {
+		int64 savedOffset;
+		int64 inputPos;
+		unsigned long bb;
+		unsigned bk;
+		int blockType;
+		int blockLen;
+		int lastBlock;
+		int codeState;
+		unsigned inflateN;
+		unsigned inflateD;
+		unsigned codeLengths[286 + 30];
+		unsigned numLitCodes;
+		unsigned numDistCodes;
+		uint8 slide[WSIZE];
+	};
+	Common::Array<Checkpoint *> _checkpoints;
+
+	void add_checkpoint();
+	const Checkpoint *find_checkpoint(int64 offset) const;
+	void restore_checkpoint(const Checkpoint *checkpoint);
+	void build_dynamic_tables();
+
 	void inflate_window();
 	void get_new_block();
 	byte parentGetByte();
@@ -922,16 +961,42 @@ GzioReadStream::init_dynamic_block ()
   _bb = b;
   _bk = k;
 
-  /* build the decoding tables for literal/length and distance codes */
+  /* keep the code lengths, checkpoints need them to rebuild the tables */
+  memcpy (_codeLengths, ll, (nl + nd) * sizeof (unsigned));
+  _numLitCodes = nl;
+  _numDistCodes = nd;
+
+  build_dynamic_tables ();
+  if (_err)
+    return;
+
+  /* indicate we're now working on a block */
+  _codeState = 0;
+  _blockLen++;
+  return;
+
+ fail:
+  huft_free (_tl);
+  _td = NULL;
+  _tl = NULL;
+}
+
+
+/* build the decoding tables for the literal/length and distance codes of
+   the current dynamic block. */
+
+void
+GzioReadStream::build_dynamic_tables ()
+{
   _bl = lbits;
-  if (huft_build (ll, nl, 257, cplens, cplext, &_tl, &_bl) != 0)
+  if (huft_build (_codeLengths, _numLitCodes, 257, cplens, cplext, &_tl, &_bl) != 0)
     {
       _err = true;
       _tl = 0;
       return;
     }
   _bd = dbits;
-  if (huft_build (ll + nl, nd, 0, cpdist, cpdext, &_td, &_bd) != 0)
+  if (huft_build (_codeLengths + _numLitCodes, _numDistCodes, 0, cpdist, cpdext, &_td, &_bd) != 0)
     {
       huft_free (_tl);
       _tl = 0;
@@ -939,16 +1004,6 @@ GzioReadStream::init_dynamic_block ()
       _err = true;
       return;
     }
-
-  /* indicate we're now working on a block */
-  _codeState = 0;
-  _blockLen++;
-  return;
-
- fail:
-  huft_free (_tl);
-  _td = NULL;
-  _tl = NULL;
 }
 
 
@@ -1086,6 +1141,99 @@ GzioReadStream::inflate_window ()
     }
 
   _savedOffset += _wp;
+
+  if (_wp == WSIZE && !_err)
+    add_checkpoint ();
+}
+
+void GzioReadStream::add_checkpoint() {
+	int64 lastOffset = _checkpoints.empty() ? 0 : _checkpoints.back()->savedOffset;
+	if (_savedOffset < lastOffset + CHECKPOINT_SPAN)
+		return;
+
+	Checkpoint *checkpoint = new Checkpoint();
+	checkpoint->savedOffset = _savedOffset;
+	checkpoint->inputPos = _input->pos() - (_inbufSize - _inbufD);
+	checkpoint->bb = _bb;
+	checkpoint->bk = _bk;
+	checkpoint->blockType = _blockType;
+	checkpoint->blockLen = _blockLen;
+	checkpoint->lastBlock = _lastBlock;
+	checkpoint->codeState = _codeState;
+	checkpoint->inflateN = _inflateN;
+	checkpoint->inflateD = _inflateD;
+	memcpy(checkpoint->codeLengths, _codeLengths, sizeof(_codeLengths));
+	checkpoint->numLitCodes = _numLitCodes;
+	checkpoint->numDistCodes = _numDistCodes;
+	memcpy(checkpoint->slide, _slide, WSIZE);
+
+	_checkpoints.push_back(checkpoint);
+}
+
+const GzioReadStream::Checkpoint *GzioReadStream::find_checkpoint(int64 offset) const {
+	// A checkpoint holds the window just before its offset
+	const Checkpoint *found = nullptr;
+	for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->savedOffset <= offset + WSIZE; i++)
+		found = _checkpoints[i];
+	return found;
+}
+
+void GzioReadStream::restore_checkpoint(const Checkpoint *checkpoint) {
+	huft_free(_tl);
+	huft_free(_td);
+	_tl = nullptr;
+	_td = nullptr;
+
+	parentSeek(checkpoint->inputPos);
+
+	_savedOffset = checkpoint->savedOffset;
+	_bb = checkpoint->bb;
+	_bk = checkpoint->bk;
+	_blockType = checkpoint->blockType;
+	_lastBlock = checkpoint->lastBlock;
+	_inflateN = checkpoint->inflateN;
+	_inflateD = checkpoint->inflateD;
+	memcpy(_codeLengths, checkpoint->codeLengths, sizeof(_codeLengths));
+	_numLitCodes = checkpoint->numLitCodes;
+	_numDistCodes = checkpoint->numDistCodes;
+	memcpy(_slide, checkpoint->slide, WSIZE);
+	_wp = WSIZE;
+
+	// Huffman coded blocks in progress need their decoding tables again
+	if (checkpoint->blockLen && checkpoint->blockType == INFLATE_FIXED)
+		init_fixed_block();
+	else if (checkpoint->blockLen && checkpoint->blockType == INFLATE_DYNAMIC)
+		build_dynamic_tables();
+
+	_blockLen = checkpoint->blockLen;
+	_codeState = checkpoint->codeState;
+}
+
+GzioReadStream::~GzioReadStream() {
+	huft_free(_tl);
+	huft_free(_td);
+
+	for (uint i = 0; i < _checkpoints.size(); i++)
+		delete _checkpoints[i];
+}
+
+int64 GzioReadStream::size() const {
+	// Only gzip streams store their uncompressed size, find it out for
+	// the others by decompressing everything once
+	if (_uncompressedSize == 0 && !_err) {
+		GzioReadStream *self = const_cast<GzioReadStream *>(this);
+		do {
+			self->inflate_window();
+		} while (_wp == WSIZE && !_err);
+
+		if (!_err)
+			self->_uncompressedSize = _savedOffset;
+
+		// The last window may be partial, start over at the next read
+		self->initialize_tables();
+	}
+
+	return _uncompressedSize;
 }
 
 
@@ -1241,6 +1389,11 @@ GzioReadStream::readAtOffset (int64 offset, byte *buf, uint32 len)
 {
   int32 ret = 0;
 
+  /* Can we skip ahead, or go back to a checkpoint before the offset?  */
+  const Checkpoint *checkpoint = find_checkpoint (offset);
+  if (checkpoint && (checkpoint->savedOffset > _savedOffset || _savedOffset > offset + WSIZE))
+    restore_checkpoint (checkpoint);
+
   /* Do we reset decompression to the beginning of the file?  */
   if (_savedOffset > offset + WSIZE)
     initialize_tables();
@@ -1304,10 +1457,14 @@ bool GzioReadStream::seek(int64 offs, int whence) {
 	// Pre-Condition
 	assert(_uncompressedSize == 0 || _streamPos <= _uncompressedSize);
 	switch (whence) {
-	case SEEK_END:
-		assert(_uncompressedSize != 0);
-		_streamPos = _uncompressedSize + offs;
+	case SEEK_END: {
+		// Decompresses everything once if the size is not known yet
+		const int64 sz = size();
+		if (_err)
+			return false;
+		_streamPos = sz + offs;
 		break;
+	}
 	case SEEK_SET:
 	default:
 		_streamPos = offs;
@@ -1383,7 +1540,7 @@ SeekableReadStream* wrapDeflateReadStream(Common::SeekableReadStream *parent, Di
 	return gzio;
 }
 
-WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
+WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped, int level) {
 	// Not supported, return stream itself to write uncompressed data
 	return toBeWrapped;
 }
@@ -95,6 +95,9 @@ typedef Byte Bytef;
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -287,6 +290,9 @@ int unzGetLocalExtrafield(unzFile file, voidp buf, unsigned len);
 #define SIZECENTRALDIRITEM (0x2e)
 #define SIZEZIPLOCALHEADER (0x1e)
 
+/* deflated members at least this big are inflated on demand while reading */
+#define UNZ_STREAMED_MEMBER_SIZE (1024 * 1024)
+
 
 #if 0
 const char unz_copyright[] =
@@ -325,6 +331,7 @@ typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCa
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _streamRef; /* owns _stream, shared with streamed members */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +466,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_streamRef = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -489,7 +497,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_ERRNO;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -516,7 +523,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -606,7 +612,7 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
+	// Streamed members may keep the stream of the archive alive
 	delete s;
 	return UNZ_OK;
 }
@@ -958,6 +964,79 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 	return err;
 }
 
+namespace {
+
+/**
+ * A deflated member which is inflated while it is read. It keeps the stream
+ * of the archive alive, so it can outlive the archive, and checks the CRC32
+ * once the contents were read in order up to the end.
+ */
+class StreamedZipMember : public Common::SeekableReadStream {
+public:
+	StreamedZipMember(const Common::SharedPtr<Common::SeekableReadStream> &archiveStream, Common::SeekableReadStream *inflated, uint32 size, uint32 crc) :
+		_archiveStream(archiveStream), _inflated(inflated), _size(size), _expectedCrc(crc), _crcPos(0), _crcFailed(false) {
+#ifdef USE_ZLIB
+		_crcValue = crc32(0, nullptr, 0);
+#else
+		_crcValue = _crc.getInitRemainder();
+#endif
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		const int64 start = _inflated->pos();
+		const uint32 len = _inflated->read(dataPtr, dataSize);
+
+		// Data read after seeking around does not add up to the CRC32
+		if (start != _crcPos || len == 0)
+			return len;
+
+#ifdef USE_ZLIB
+		_crcValue = crc32(_crcValue, (const Bytef *)dataPtr, len);
+#else
+		for (uint32 i = 0; i < len; i++)
+			_crcValue = _crc.processByte(((const byte *)dataPtr)[i], _crcValue);
+#endif
+		_crcPos += len;
+
+		if (_crcPos == _size) {
+#ifdef USE_ZLIB
+			const uint32 crc32_data = _crcValue;
+#else
+			const uint32 crc32_data = _crc.finalize(_crcValue);
+#endif
+			if (crc32_data != _expectedCrc) {
+				warning("CRC32 mismatch: %08x, %08x", crc32_data, _expectedCrc);
+				_crcFailed = true;
+			}
+		}
+		return len;
+	}
+
+	bool eos() const override { return _inflated->eos(); }
+	bool err() const override { return _crcFailed || _inflated->err(); }
+	void clearErr() override { _inflated->clearErr(); }
+
+	int64 pos() const override { return _inflated->pos(); }
+	int64 size() const override { return _inflated->size(); }
+	bool seek(int64 offset, int whence = SEEK_SET) override { return _inflated->seek(offset, whence); }
+
+private:
+	Common::SharedPtr<Common::SeekableReadStream> _archiveStream;
+	Common::ScopedPtr<Common::SeekableReadStream> _inflated; // reads from _archiveStream
+	const uint32 _size;
+	const uint32 _expectedCrc;
+#ifdef USE_ZLIB
+	uLong _crcValue;
+#else
+	Common::CRC32 _crc;
+	uint32 _crcValue;
+#endif
+	int64 _crcPos;
+	bool _crcFailed;
+};
+
+} // End of anonymous namespace
+
 /*
   Open for reading data the current file in the zipfile.
   If there is no error and the file is opened, the return value is UNZ_OK.
@@ -989,8 +1068,46 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 
 	uint32 crc32_wait = s->cur_file_info.crc;
 
+	uint32 dataStart = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+
+	// Inflating big members up front costs a lot of memory and time before the
+	// first byte can be read. Hand out a stream which inflates as it is read
+	// instead.
+	if (s->cur_file_info.compression_method == Z_DEFLATED && s->cur_file_info.uncompressed_size >= UNZ_STREAMED_MEMBER_SIZE) {
+		Common::SeekableReadStream *compressed = new Common::SafeSeekableSubReadStream(s->_stream, dataStart, dataStart + s->cur_file_info.compressed_size);
+		Common::SeekableReadStream *inflated = Common::wrapDeflateReadStream(compressed, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+		if (!inflated)
+			return Common::SharedArchiveContents();
+		return Common::SharedArchiveContents::bypass(new StreamedZipMember(s->_streamRef, inflated, s->cur_file_info.uncompressed_size, crc32_wait));
+	}
+
+	s->_stream->seek(dataStart);
+
+	// Memory mapped archives hand out their data in place, so stored members
+	// need no copy at all and deflated ones are inflated straight from the file
+	Common::SharedPtr<byte> borrowed = s->_stream->borrowData(s->cur_file_info.compressed_size);
+	if (borrowed) {
+		Common::SharedPtr<byte> contents = borrowed;
+
+		if (s->cur_file_info.compression_method == Z_DEFLATED) {
+			contents = Common::SharedPtr<byte>(new byte[s->cur_file_info.uncompressed_size], Common::ArrayDeleter<byte>());
+			Common::inflateZlibHeaderless(contents.get(), s->cur_file_info.uncompressed_size, borrowed.get(), s->cur_file_info.compressed_size);
+		}
+
+#ifndef USE_ZLIB
+		uint32 crc32_data = crc.crcFast(contents.get(), s->cur_file_info.uncompressed_size);
+#else
+		uint32 crc32_data = crc32(0, contents.get(), s->cur_file_info.uncompressed_size);
+#endif
+		if (crc32_data != crc32_wait) {
+			warning("CRC32 mismatch: %08x, %08x", crc32_data, crc32_wait);
+			return Common::SharedArchiveContents();
+		}
+
+		return Common::SharedArchiveContents(contents, s->cur_file_info.uncompressed_size);
+	}
+
 	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
 	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
 	byte *uncompressedBuffer = nullptr;
 
@@ -1127,7 +1244,8 @@ Archive *makeZipArchive(const Path &name, bool flattenTree) {
 }
 
 Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
+	// Members are handed out straight from the mapped archive where possible
+	return makeZipArchive(node.createMappedReadStream(), flattenTree);
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
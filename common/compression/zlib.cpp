@@ -31,8 +31,14 @@
 #error Version 1.2.0.4 or newer of zlib is required for this code
 #endif
 
+// Seek checkpoints need inflateGetDictionary(), added in zlib 1.2.7.1
+#if ZLIB_VERNUM >= 0x1271
+#define USE_INFLATE_CHECKPOINTS
+#endif
+
 #include "common/compression/deflate.h"
 
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -103,11 +109,83 @@ protected:
 	DisposablePtr<SeekableReadStream> _wrapped;
 	z_stream _stream;
 	int _zlibErr;
+	int _windowBits;
 	uint64 _parentPos;
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
 
+#ifdef USE_INFLATE_CHECKPOINTS
+	enum {
+		WINDOWSIZE = 1 << MAX_WBITS,
+		CHECKPOINT_SPAN = 1024 * 1024
+	};
+
+	/**
+	 * The inflate state at a deflate block boundary, from which decompression
+	 * can be resumed without going through the data before it.
+	 */
+	struct Checkpoint {
+		uint32 outPos;          ///< Position in the uncompressed data
+		uint64 inPos;           ///< Position in the compressed data, relative to _parentPos
+		int bits;               ///< Number of bits of the byte before inPos still to be used
+		uint windowSize;
+		byte window[WINDOWSIZE]; ///< The last uncompressed bytes before outPos
+	};
+
+	/** Checkpoints roughly every CHECKPOINT_SPAN bytes, sorted by position. */
+	Array<Checkpoint *> _checkpoints;
+
+	void addCheckpoint(uint32 outPos) {
+		uint32 lastPos = _checkpoints.empty() ? 0 : _checkpoints.back()->outPos;
+		if (outPos < lastPos + CHECKPOINT_SPAN)
+			return;
+
+		Checkpoint *checkpoint = new Checkpoint();
+		checkpoint->outPos = outPos;
+		checkpoint->inPos = _wrapped->pos() - _parentPos - _stream.avail_in;
+		checkpoint->bits = _stream.data_type & 7;
+		checkpoint->windowSize = WINDOWSIZE;
+		if (inflateGetDictionary(&_stream, checkpoint->window, &checkpoint->windowSize) != Z_OK) {
+			delete checkpoint;
+			return;
+		}
+
+		_checkpoints.push_back(checkpoint);
+	}
+
+	const Checkpoint *findCheckpoint(uint32 outPos) const {
+		const Checkpoint *found = nullptr;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= outPos; i++)
+			found = _checkpoints[i];
+		return found;
+	}
+
+	bool restoreCheckpoint(const Checkpoint *checkpoint) {
+		// Checkpoints sit between deflate blocks, where no header follows
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_wrapped->seek(_parentPos + checkpoint->inPos - (checkpoint->bits ? 1 : 0), SEEK_SET);
+		if (checkpoint->bits) {
+			byte partial = _wrapped->readByte();
+			_zlibErr = inflatePrime(&_stream, checkpoint->bits, partial >> (8 - checkpoint->bits));
+			if (_zlibErr != Z_OK)
+				return false;
+		}
+
+		_zlibErr = inflateSetDictionary(&_stream, checkpoint->window, checkpoint->windowSize);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_pos = checkpoint->outPos;
+		return true;
+	}
+#endif
+
 public:
 
 	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream() {
@@ -137,7 +215,8 @@ public:
 		// the compressed file. This feature was added in zlib 1.2.0.4,
 		// released 10 August 2003.
 		// Note: This is *crucial* for savegame compatibility, do *not* remove!
-		_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		_windowBits = MAX_WBITS + 32;
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -157,7 +236,8 @@ public:
 		_pos = 0;
 		_eos = false;
 
-		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		_windowBits = -MAX_WBITS;
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -175,6 +255,11 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+
+#ifdef USE_INFLATE_CHECKPOINTS
+		for (uint i = 0; i < _checkpoints.size(); i++)
+			delete _checkpoints[i];
+#endif
 	}
 
 	bool err() const override { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -194,7 +279,14 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
+#ifdef USE_INFLATE_CHECKPOINTS
+			// Stop at every block boundary to see if a checkpoint is due
+			_zlibErr = inflate(&_stream, Z_BLOCK);
+			if (_zlibErr == Z_OK && (_stream.data_type & 128) && !(_stream.data_type & 64))
+				addCheckpoint(_pos + dataSize - _stream.avail_out);
+#else
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+#endif
 		}
 
 		// Update the position counter
@@ -213,6 +305,21 @@ public:
 		return _pos;
 	}
 	int64 size() const override {
+		// Only gzip streams store their uncompressed size, find it out for
+		// the others by decompressing everything once
+		if (_origSize == 0 && !err()) {
+			GZipReadStream *self = const_cast<GZipReadStream *>(this);
+			uint32 oldPos = _pos;
+
+			byte tmpBuf[4096];
+			while (!self->eos() && !err())
+				self->read(tmpBuf, sizeof(tmpBuf));
+
+			if (!err())
+				self->_origSize = _pos;
+			self->seek(oldPos, SEEK_SET);
+		}
+
 		return _origSize;
 	}
 	bool seek(int64 offset, int whence = SEEK_SET) override {
@@ -234,6 +341,16 @@ public:
 
 		assert(newPos >= 0);
 
+#ifdef USE_INFLATE_CHECKPOINTS
+		// Resume from the closest checkpoint when it saves going back to the
+		// start, or skipping over data that was already decompressed once
+		const Checkpoint *checkpoint = findCheckpoint(newPos);
+		if (checkpoint && ((uint32)newPos < _pos || checkpoint->outPos > _pos)) {
+			if (!restoreCheckpoint(checkpoint))
+				return false; // FIXME: STREAM REWRITE
+		}
+#endif
+
 		if ((uint32)newPos < _pos) {
 			// To search backward, we have to restart the whole decompression
 			// from the start of the file. A rather wasteful operation, best
@@ -251,7 +368,12 @@ public:
 
 			_pos = 0;
 			_wrapped->seek(_parentPos, SEEK_SET);
+#ifdef USE_INFLATE_CHECKPOINTS
+			// Checkpoints may have switched the stream to raw deflate
+			_zlibErr = inflateReset2(&_stream, _windowBits);
+#else
 			_zlibErr = inflateReset(&_stream);
+#endif
 			if (_zlibErr != Z_OK)
 				return false; // FIXME: STREAM REWRITE
 			_stream.next_in = _buf;
@@ -306,7 +428,7 @@ protected:
 	}
 
 public:
-	GZipWriteStream(WriteStream *w) : _wrapped(w), _stream(), _pos(0) {
+	GZipWriteStream(WriteStream *w, int level) : _wrapped(w), _stream(), _pos(0) {
 		assert(w != nullptr);
 
 		// Adding 16 to windowBits indicates to zlib that it is supposed to
@@ -314,7 +436,7 @@ public:
 		// released 10 August 2003.
 		// Note: This is *crucial* for savegame compatibility, do *not* remove!
 		_zlibErr = deflateInit2(&_stream,
-		                 Z_DEFAULT_COMPRESSION,
+		                 level,
 		                 Z_DEFLATED,
 		                 MAX_WBITS + 16,
 		                 8,
@@ -420,10 +542,12 @@ SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, Dispo
 	return new GZipReadStream(toBeWrapped, disposeParent, knownSize, dict, dictLen);
 }
 
-WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
+WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped, int level) {
 	if (!toBeWrapped)
 		return nullptr;
-	return new GZipWriteStream(toBeWrapped);
+	if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION)
+		level = Z_DEFAULT_COMPRESSION;
+	return new GZipWriteStream(toBeWrapped, level);
 }
 
 } // End of namespace Common
@@ -252,6 +252,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the time of the last modification of the file
+	 * referred by this node, without opening it.
+	 *
+	 * @param size  Set to the size of the file in bytes.
+	 * @param mtime Set to the last modification time, in seconds since the Unix epoch.
+	 *
+	 * @return True if the information could be retrieved, false if the node does
+	 *         not exist or the backend does not support it.
+	 */
+	bool getFileInfo(int64 &size, int64 &mtime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -261,6 +273,20 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a SeekableReadStream instance corresponding to the file
+	 * referred by this node, which may hand out its contents in place
+	 * through SeekableReadStream::borrowData(), e.g. by mapping the file.
+	 * Otherwise, this is the same as createReadStream().
+	 *
+	 * Only use this for files which are not modified while being read.
+	 * On POSIX systems, reading a mapped file which got truncated kills
+	 * the process.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
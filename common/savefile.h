@@ -114,8 +114,8 @@ public:
 	bool seek(int64 offset, int whence) override;
 
 	/**
-	 * Returns the size of the save file
-	 * This is only supported when creating uncompressed save files.
+	 * Returns the size of the save file.
+	 * For compressed save files, this is the amount of uncompressed data written.
 	 */
 	int64 size() const override;
 };
@@ -201,6 +201,20 @@ public:
 	 */
 	virtual OutSaveFile *openForSaving(const String &name, bool compress = true) = 0;
 
+	/**
+	 * Return whether save files are still being written in the background.
+	 *
+	 * Save file managers may hand back control as soon as an OutSaveFile is
+	 * finalized or deleted, and write it to its storage afterwards.
+	 */
+	virtual bool hasPendingSaves() { return false; }
+
+	/**
+	 * Block until all save files being written in the background are stored.
+	 * This should be called before quitting.
+	 */
+	virtual void waitForPendingSaves() {}
+
 	/**
 	 * Open the file with the specified @p name in the given directory for loading.
 	 *
@@ -276,6 +290,35 @@ public:
 	 * @return true if the file exists. false otherwise.
 	 */
 	virtual bool exists(const String &name) = 0;
+
+	/**
+	 * Read the entry of a save file from the metadata index of a target.
+	 *
+	 * Engines use the index to list their saves without opening and parsing
+	 * every one of them. The entry is dropped as soon as the save file
+	 * changes.
+	 *
+	 * @param target    Target the save file belongs to.
+	 * @param filename  Name of the save file.
+	 *
+	 * @return The data of the entry, or NULL if there is no valid entry.
+	 */
+	virtual SeekableReadStream *readSaveIndexEntry(const String &target, const String &filename) { return nullptr; }
+
+	/**
+	 * Store the entry of an existing save file in the metadata index of a target.
+	 *
+	 * @param target    Target the save file belongs to.
+	 * @param filename  Name of the save file.
+	 * @param data      Data of the entry.
+	 * @param size      Size of the data.
+	 */
+	virtual void writeSaveIndexEntry(const String &target, const String &filename, const byte *data, uint32 size) {}
+
+	/**
+	 * Write the metadata indexes which were modified back to the storage.
+	 */
+	virtual void flushSaveIndexes() {}
 };
 
 /** @} */
@@ -62,6 +62,10 @@ void WriteStream::writeString(const String &str) {
 }
 
 SeekableReadStream *ReadStream::readStream(uint32 dataSize) {
+	SharedPtr<byte> data = borrowData(dataSize);
+	if (data)
+		return new MemoryReadStream(data, dataSize);
+
 	void *buf = malloc(dataSize);
 	dataSize = read(buf, dataSize);
 	assert(dataSize > 0);
@@ -256,6 +260,17 @@ uint32 SubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return dataSize;
 }
 
+SharedPtr<byte> SubReadStream::borrowData(uint32 dataSize) {
+	if (dataSize > _end - _pos)
+		return SharedPtr<byte>();
+
+	SharedPtr<byte> data = _parentStream->borrowData(dataSize);
+	if (data)
+		_pos += dataSize;
+
+	return data;
+}
+
 SeekableSubReadStream::SeekableSubReadStream(SeekableReadStream *parentStream, uint32 begin, uint32 end, DisposeAfterUse::Flag disposeParentStream)
 	: SubReadStream(parentStream, end, disposeParentStream),
 	_parentStream(parentStream),
@@ -299,6 +314,13 @@ uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return SeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+SharedPtr<byte> SafeSeekableSubReadStream::borrowData(uint32 dataSize) {
+	// Make sure the parent stream is at the right position
+	seek(0, SEEK_CUR);
+
+	return SeekableSubReadStream::borrowData(dataSize);
+}
+
 void SeekableReadStream::hexdump(int len, int bytesPerLine, int startOffset) {
 	uint pos_ = pos();
 	uint size_ = size();
@@ -608,4 +630,9 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+SharedPtr<byte> SafeMutexedSeekableSubReadStream::borrowData(uint32 dataSize) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::borrowData(dataSize);
+}
+
 } // End of namespace Common
@@ -706,10 +706,28 @@ public:
 		return this->readMultiple<EndianStorageFormat, T...>(EndianStorageFormat::Big, values...);
 	}
 
+	/**
+	 * Borrow the next @p dataSize bytes of the stream without copying them,
+	 * and advance the stream past them.
+	 *
+	 * Streams whose contents are already in memory, such as memory mapped
+	 * files, can hand out their data in place. The returned memory is
+	 * read-only and stays valid as long as the returned pointer is
+	 * referenced, even after the stream has been destroyed.
+	 *
+	 * @return The data, or a null pointer if the stream does not support
+	 *         borrowing or fewer than @p dataSize bytes are left. In that
+	 *         case, the stream position is left unchanged.
+	 */
+	virtual SharedPtr<byte> borrowData(uint32 dataSize) { return SharedPtr<byte>(); }
+
 	/**
 	 * Read the specified amount of data into a malloc'ed buffer
 	 * which is then wrapped into a MemoryReadStream.
 	 *
+	 * If the stream supports @ref borrowData, the data is not copied and
+	 * the MemoryReadStream refers to the contents of this stream instead.
+	 *
 	 * The returned stream might contain less data than requested
 	 * if reading more data failed. This is because of an I/O error or because
 	 * the end of the stream was reached. It can be determined by
@@ -65,6 +65,7 @@ public:
 	virtual bool err() const { return _parentStream->err(); }
 	virtual void clearErr() { _eos = false; _parentStream->clearErr(); }
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	virtual SharedPtr<byte> borrowData(uint32 dataSize);
 };
 
 /*
@@ -108,6 +109,7 @@ public:
 	}
 
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	virtual SharedPtr<byte> borrowData(uint32 dataSize);
 };
 
 /**
@@ -124,6 +126,7 @@ public:
 		: SafeSeekableSubReadStream(parentStream, begin, end, disposeParentStream), _mutex(mutex) {
 	}
 	uint32 read(void *dataPtr, uint32 dataSize) override;
+	SharedPtr<byte> borrowData(uint32 dataSize) override;
 protected:
 	Common::Mutex &_mutex;
 };
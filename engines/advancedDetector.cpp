@@ -24,6 +24,7 @@
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
+#include "common/hash-str.h"
 #include "common/macresman.h"
 #include "common/md5.h"
 #include "common/config-manager.h"
@@ -245,8 +246,6 @@ bool AdvancedMetaEngineDetectionBase::cleanupPirated(ADDetectedGames &matched) c
 }
 
 DetectedGames AdvancedMetaEngineDetectionBase::detectGames(const Common::FSList &fslist, uint32 skipADFlags, bool skipIncomplete) {
-	FileMap allFiles;
-
 	if (fslist.empty())
 		return DetectedGames();
 
@@ -254,8 +253,8 @@ DetectedGames AdvancedMetaEngineDetectionBase::detectGames(const Common::FSList
 	// the _directoryGlobsMap
 	preprocessDescriptions();
 
-	// Compose a hashmap of all files in fslist.
-	composeFileHashMap(allFiles, fslist, (_maxScanDepth == 0 ? 1 : _maxScanDepth));
+	// Compose a hashmap of all files in fslist, shared with the other engines
+	const FileMap &allFiles = getSharedFileHashMap(fslist);
 
 	// Run the detector on this
 	ADDetectedGames matches = detectGame(fslist.begin()->getParent(), allFiles, Common::UNK_LANG, Common::kPlatformUnknown, "", skipADFlags, skipIncomplete);
@@ -407,6 +406,7 @@ Common::Error AdvancedMetaEngineDetectionBase::identifyGame(DetectedGame &game,
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.flushPersistentCache();
 
 	if (!agdDesc.desc)
 		return Common::kNoGameDataFoundError;
@@ -442,7 +442,7 @@ void AdvancedMetaEngineDetectionBase::composeFileHashMap(FileMap &allFiles, cons
 				continue;
 
 			Common::FSList files;
-			if (!file->getChildren(files, Common::FSNode::kListAll))
+			if (!ADCacheMan.getChildren(*file, files))
 				continue;
 
 			composeFileHashMap(allFiles, files, depth - 1, tstr);
@@ -462,12 +462,216 @@ void AdvancedMetaEngineDetectionBase::composeFileHashMap(FileMap &allFiles, cons
 	}
 }
 
+const AdvancedMetaEngineDetectionBase::FileMap &AdvancedMetaEngineDetectionBase::getSharedFileHashMap(const Common::FSList &fslist) const {
+	int depth = (_maxScanDepth == 0 ? 1 : _maxScanDepth);
+
+	// The composed map only depends on the scanned entries, the depth, the
+	// directory globs and whether full paths are recorded. Lists of the same
+	// directory taken at different times may differ, so the entries are part
+	// of the key, through a hash of their paths.
+	uint entriesHash = 0;
+	for (const auto &file : fslist) {
+		entriesHash = entriesHash * 31 + Common::hashit(file.getPath().toString('/').c_str());
+		if (file.isDirectory())
+			entriesHash ^= 1;
+	}
+
+	Common::StringArray globs;
+	for (const auto &glob : _globsMap)
+		globs.push_back(glob._key);
+	for (auto &glob : globs)
+		glob.toLowercase();
+	Common::sort(globs.begin(), globs.end());
+
+	Common::String key = Common::String::format("%s:%d:%08x:%d:%d", fslist.front().getParent().getPath().toString('/').c_str(),
+		fslist.size(), entriesHash, globs.empty() ? 1 : depth, (_flags & kADFlagMatchFullPaths) ? 1 : 0);
+	for (const auto &glob : globs) {
+		key += ':';
+		key += glob;
+	}
+
+	bool created;
+	FileMap &allFiles = ADCacheMan.getFileMap(key, created);
+	if (created)
+		composeFileHashMap(allFiles, fslist, depth);
+	else
+		debugC(9, kDebugGlobalDetection, "Reusing file map of '%s'", key.c_str());
+
+	return allFiles;
+}
+
 /* Singleton Cache Storage for MD5 */
 
 namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+#define AD_MD5_CACHE_FILENAME "detection_md5.cache"
+#define AD_MD5_CACHE_VERSION 1
+
+/** Beyond this many entries, entries not used during this session are dropped. */
+static const uint kMaxPersistentCacheEntries = 200000;
+
+/** Minimum delay between two non-forced writes of the persistent cache. */
+static const uint32 kPersistentCacheFlushDelay = 5000;
+
+static int hexDigitValue(char c) {
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+Common::Path AdvancedDetectorCacheManager::getPersistentCachePath() {
+	Common::Path configPath = ConfMan.getCustomConfigFileName();
+	if (configPath.empty())
+		configPath = g_system->getDefaultConfigFileName();
+	if (configPath.empty())
+		return Common::Path();
+
+	return configPath.getParent().appendComponent(AD_MD5_CACHE_FILENAME);
+}
+
+void AdvancedDetectorCacheManager::loadPersistentCache() {
+	_persistentLoaded = true;
+
+	Common::Path path = getPersistentCachePath();
+	if (path.empty())
+		return;
+
+	Common::FSNode node(path);
+	if (!node.exists())
+		return;
+
+	Common::ScopedPtr<Common::SeekableReadStream> in(node.createReadStream());
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != MKTAG('A', 'D', 'M', '5') || in->readUint32LE() != AD_MD5_CACHE_VERSION) {
+		debugC(2, kDebugGlobalDetection, "Ignoring MD5 cache '%s' with unknown format", path.toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	uint32 count = in->readUint32LE();
+	for (uint32 i = 0; i < count && !in->eos() && !in->err(); i++) {
+		uint16 keyLen = in->readUint16LE();
+		Common::String key = in->readString(0, keyLen);
+
+		PersistentEntry entry;
+		entry.fileSize = in->readSint64LE();
+		entry.fileTime = in->readSint64LE();
+		entry.size = in->readSint64LE();
+		entry.md5prop = in->readUint16LE();
+
+		byte md5[16];
+		if (in->read(md5, sizeof(md5)) != sizeof(md5))
+			break;
+
+		for (uint j = 0; j < sizeof(md5); j++)
+			entry.md5 += Common::String::format("%02x", md5[j]);
+
+		entry.used = false;
+		_persistentHashMap.setVal(key, entry);
+	}
+
+	debugC(2, kDebugGlobalDetection, "Loaded %d entries from MD5 cache '%s'", _persistentHashMap.size(), path.toString(Common::Path::kNativeSeparator).c_str());
+}
+
+bool AdvancedDetectorCacheManager::getPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, FileProperties &props) {
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	PersistentHashMap::iterator i = _persistentHashMap.find(key);
+	if (i == _persistentHashMap.end())
+		return false;
+
+	PersistentEntry &entry = i->_value;
+	if (entry.fileSize != fileSize || entry.fileTime != fileTime) {
+		// The file changed since the MD5 was computed
+		_persistentHashMap.erase(i);
+		_persistentDirty = true;
+		return false;
+	}
+
+	entry.used = true;
+	props.size = entry.size;
+	props.md5 = entry.md5;
+	props.md5prop = (MD5Properties)entry.md5prop;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, const FileProperties &props) {
+	// Only plain MD5 hex strings can be stored in the compact format
+	if (props.md5.size() != 32 || key.size() > 0xFFFF)
+		return;
+
+	if (!_persistentLoaded)
+		loadPersistentCache();
+
+	PersistentEntry entry;
+	entry.fileSize = fileSize;
+	entry.fileTime = fileTime;
+	entry.size = props.size;
+	entry.md5prop = props.md5prop;
+	entry.md5 = props.md5;
+	entry.used = true;
+	_persistentHashMap.setVal(key, entry);
+	_persistentDirty = true;
+}
+
+void AdvancedDetectorCacheManager::flushPersistentCache(bool force) {
+	if (!_persistentDirty)
+		return;
+
+	uint32 now = g_system->getMillis();
+	if (!force && _lastFlush != 0 && now - _lastFlush < kPersistentCacheFlushDelay)
+		return;
+
+	_persistentDirty = false;
+	_lastFlush = now;
+
+	if (_persistentHashMap.size() > kMaxPersistentCacheEntries) {
+		for (PersistentHashMap::iterator i = _persistentHashMap.begin(); i != _persistentHashMap.end(); ++i) {
+			if (!i->_value.used)
+				_persistentHashMap.erase(i);
+		}
+	}
+
+	Common::Path path = getPersistentCachePath();
+	if (path.empty())
+		return;
+
+	Common::ScopedPtr<Common::WriteStream> out(Common::FSNode(path).createWriteStream());
+	if (!out) {
+		warning("Unable to write MD5 cache '%s'", path.toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('A', 'D', 'M', '5'));
+	out->writeUint32LE(AD_MD5_CACHE_VERSION);
+	out->writeUint32LE(_persistentHashMap.size());
+
+	for (PersistentHashMap::const_iterator i = _persistentHashMap.begin(); i != _persistentHashMap.end(); ++i) {
+		const PersistentEntry &entry = i->_value;
+
+		out->writeUint16LE(i->_key.size());
+		out->write(i->_key.c_str(), i->_key.size());
+		out->writeSint64LE(entry.fileSize);
+		out->writeSint64LE(entry.fileTime);
+		out->writeSint64LE(entry.size);
+		out->writeUint16LE(entry.md5prop);
+
+		for (uint j = 0; j < 16; j++)
+			out->writeByte((hexDigitValue(entry.md5[j * 2]) << 4) | hexDigitValue(entry.md5[j * 2 + 1]));
+	}
+
+	if (!out->flush() || out->err())
+		warning("Unable to write MD5 cache '%s'", path.toString(Common::Path::kNativeSeparator).c_str());
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -532,10 +736,40 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
+/**
+ * Name a file by its location on disk rather than by the name it was looked up
+ * with, so that engines matching the same file through different relative
+ * paths share a single MD5 computation.
+ *
+ * @param diskName  Set to the name of the file on disk, i.e. the archive for archive members.
+ */
+static Common::String getFileCacheLocation(const AdvancedMetaEngineBase::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, Common::Path &diskName) {
+	Common::String member;
+
+	diskName = fname;
+	if (md5prop & kMD5Archive) {
+		Common::StringTokenizer tok(fname.toString(), ":");
+		Common::String archiveType = tok.nextToken();
+		diskName = Common::Path(tok.nextToken());
+		member = archiveType + ':' + tok.nextToken();
+	}
+
+	Common::String location = allFiles.contains(diskName) ? allFiles[diskName].getPath().toString('/') : diskName.toString('/');
+	if (!member.empty()) {
+		location += ':';
+		location += member;
+	}
+
+	return location;
+}
+
 bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+	Common::Path diskName;
+	Common::String location = getFileCacheLocation(allFiles, md5prop, fname, diskName);
+
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
-		hashname += fname.toString('/');
+		hashname += location;
 		hashname += ':';
 		hashname += Common::String::format("%d", _md5Bytes);
 
@@ -545,16 +779,70 @@ bool AdvancedMetaEngineDetectionBase::getFileProperties(const FileMap &allFiles,
 		return true;
 	}
 
+	// Look in the persistent cache, keyed by absolute path, before reading the file
+	Common::String persistentKey;
+	int64 fileSize = 0, fileTime = 0;
+	bool persistent = getPersistentCacheKey(allFiles, md5prop, diskName, location, persistentKey, fileSize, fileTime);
+
+	if (persistent && ADCacheMan.getPersistentMD5(persistentKey, fileSize, fileTime, fileProps)) {
+		ADCacheMan.setMD5(hashname, fileProps.md5);
+		ADCacheMan.setSize(hashname, fileProps.size);
+		return true;
+	}
+
 	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+
+		if (persistent)
+			ADCacheMan.setPersistentMD5(persistentKey, fileSize, fileTime, fileProps);
 	}
 
 	return res;
 }
 
+/**
+ * Accumulate the size and modification time of a file into the values
+ * used to validate persistent cache entries.
+ */
+static bool addFileInfo(const AdvancedMetaEngineBase::FileMap &allFiles, const Common::Path &fname, int64 &fileSize, int64 &fileTime) {
+	if (!allFiles.contains(fname))
+		return false;
+
+	int64 size, mtime;
+	if (!allFiles[fname].getFileInfo(size, mtime))
+		return false;
+
+	fileSize += size;
+	fileTime = MAX(fileTime, mtime);
+	return true;
+}
+
+bool AdvancedMetaEngineDetectionBase::getPersistentCacheKey(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &diskName, const Common::String &location, Common::String &key, int64 &fileSize, int64 &fileTime) const {
+	if (!addFileInfo(allFiles, diskName, fileSize, fileTime))
+		return false;
+
+	if (md5prop & (kMD5MacResFork | kMD5MacDataFork)) {
+		// Forks may come from companion files, so any change to those
+		// has to invalidate the entry as well
+		Common::String baseName = diskName.baseName();
+		addFileInfo(allFiles, diskName.append(".rsrc"), fileSize, fileTime);
+		addFileInfo(allFiles, diskName.append(".bin"), fileSize, fileTime);
+		addFileInfo(allFiles, diskName.getParent().appendComponent("._" + baseName), fileSize, fileTime);
+		addFileInfo(allFiles, Common::Path("__MACOSX").join(diskName.getParent()).appendComponent("._" + baseName), fileSize, fileTime);
+	}
+
+	key = md5PropToCachePrefix(md5prop);
+	key += ':';
+	key += Common::String::format("%d", _md5Bytes);
+	key += ':';
+	key += location;
+
+	return true;
+}
+
 bool AdvancedMetaEngineBase::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
 }
@@ -588,9 +588,27 @@ protected:
 	 */
 	void composeFileHashMap(FileMap &allFiles, const Common::FSList &fslist, int depth, const Common::Path &parentName = Common::Path()) const;
 
+	/**
+	 * Compose a hashmap of all files in @p fslist, or reuse the one composed
+	 * by another engine during the current detection run if it scanned the
+	 * same directory with the same depth, globs and path matching flags.
+	 *
+	 * The returned map is owned by the @ref AdvancedDetectorCacheManager.
+	 */
+	const FileMap &getSharedFileHashMap(const Common::FSList &fslist) const;
+
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
+	/**
+	 * Compute the key and validation data of a file in the persistent MD5 cache.
+	 *
+	 * @param diskName  Name of the file on disk in @p allFiles.
+	 * @param location  Absolute location of the file, including any archive member.
+	 * @return false if the file cannot be stored in the persistent cache.
+	 */
+	bool getPersistentCacheKey(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &diskName, const Common::String &location, Common::String &key, int64 &fileSize, int64 &fileTime) const;
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -731,6 +749,11 @@ private:
 
 /**
  * Singleton Cache Storage for Computed MD5s and Open Archives
+ *
+ * Besides the in-memory cache, which only lives for a single detection run,
+ * MD5s of files on disk are also kept in a persistent cache stored next to
+ * the configuration file. Its entries are keyed by the absolute file path and
+ * are discarded as soon as the size or modification time of the file changes.
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -771,10 +794,70 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Get the file map stored under @p key, creating an empty one if there is none.
+	 *
+	 * @param created  Set to true if the map was just created and still has to be filled.
+	 */
+	AdvancedMetaEngineBase::FileMap &getFileMap(const Common::String &key, bool &created) {
+		created = !fileMapHashMap.contains(key);
+		return fileMapHashMap[key];
+	}
+
+	/**
+	 * List the contents of a directory, reusing the listing made by a
+	 * previous engine during the current detection run.
+	 */
+	bool getChildren(const Common::FSNode &node, Common::FSList &files) {
+		DirectoryHashMap::const_iterator i = directoryHashMap.find(node.getPath());
+		if (i != directoryHashMap.end()) {
+			files = i->_value;
+			return true;
+		}
+
+		if (!node.getChildren(files, Common::FSNode::kListAll))
+			return false;
+
+		directoryHashMap.setVal(node.getPath(), files);
+		return true;
+	}
+
+	void clearFileMaps() {
+		fileMapHashMap.clear(true);
+		directoryHashMap.clear(true);
+	}
+
+	/**
+	 * Look up an MD5 in the persistent cache.
+	 *
+	 * @param key       Identifies the absolute path, MD5 properties and byte count.
+	 * @param fileSize  Current size of the file(s) the MD5 was computed from.
+	 * @param fileTime  Current modification time of the file(s).
+	 * @param props     Set to the cached size, MD5 and MD5 properties on success.
+	 * @return true if an entry was found and the file did not change since.
+	 */
+	bool getPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, FileProperties &props);
+
+	/** Store an MD5 in the persistent cache. */
+	void setPersistentMD5(const Common::String &key, int64 fileSize, int64 fileTime, const FileProperties &props);
+
+	/**
+	 * Write the persistent cache to disk, if it was modified.
+	 *
+	 * Unless @p force is set, writes are throttled so that mass-adding games
+	 * does not rewrite the whole cache after every directory.
+	 */
+	void flushPersistentCache(bool force = false);
+
+	AdvancedDetectorCacheManager() : _persistentLoaded(false), _persistentDirty(false), _lastFlush(0) {
 		clear();
 	}
 
+	~AdvancedDetectorCacheManager() {
+		flushPersistentCache(true);
+		clearArchives();
+	}
+
 	void clearArchives() {
 		for (auto &entry : archiveHashMap) {
 			delete entry._value;
@@ -786,6 +869,7 @@ public:
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
 		clearArchives();
+		clearFileMaps();
 	}
 
 private:
@@ -794,9 +878,31 @@ private:
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	typedef Common::HashMap<Common::Path, Common::Archive *, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> ArchiveHashMap;
+	typedef Common::HashMap<Common::String, AdvancedMetaEngineBase::FileMap> FileMapHashMap;
+	typedef Common::HashMap<Common::Path, Common::FSList, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> DirectoryHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+	FileMapHashMap fileMapHashMap;
+	DirectoryHashMap directoryHashMap;
+
+	struct PersistentEntry {
+		int64 fileSize;
+		int64 fileTime;
+		int64 size;
+		uint16 md5prop;
+		Common::String md5;
+		bool used;
+	};
+
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentHashMap;
+	PersistentHashMap _persistentHashMap;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+	uint32 _lastFlush;
+
+	static Common::Path getPersistentCachePath();
+	void loadPersistentCache();
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -235,7 +235,28 @@ Common::Error AGSEngine::run() {
 	_G(loadSaveGameOnStartup) = ConfMan.getInt("save_slot");
 
 	syncSoundSettings();
+
+	// Benchmark the script interpreter by running the given number of game
+	// ticks without frame limit, then quitting. Input can come from a
+	// recording played back with --record-mode=playback.
+	const int benchmarkTicks = ConfMan.hasKey("ags_benchmark_ticks") ? ConfMan.getInt("ags_benchmark_ticks") : 0;
+	_G(benchmarkTicksLeft) = MAX(benchmarkTicks, 0);
+
+	// Only measure the time spent in scripts if it is reported at the end
+	const bool reportScriptStats = DebugMan.isDebugChannelEnabled(kDebugScript);
+	_G(scriptClockEnabled) = reportScriptStats || benchmarkTicks > 0;
+
+	const uint32 startTime = g_system->getMillis();
 	AGS3::initialize_engine(startup_opts);
+	const uint32 elapsed = g_system->getMillis() - startTime;
+
+	if (benchmarkTicks > 0) {
+		debug("AGS benchmark: %u ms in total, %u ticks per second\n%s", elapsed,
+			(uint32)((uint64)(_G(loopcounter) - _G(scriptStatsLoopCounter)) * 1000 / MAX<uint32>(elapsed, 1)),
+			AGS3::cc_get_exec_stats().GetCStr());
+	} else if (reportScriptStats) {
+		debugC(1, kDebugScript, "%s", AGS3::cc_get_exec_stats().GetCStr());
+	}
 
 	// Do shutdown stuff
 	::AGS3::quit_free();
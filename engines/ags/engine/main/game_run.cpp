@@ -740,6 +740,9 @@ static void game_loop_update_background_animation() {
 static void game_loop_update_loop_counter() {
 	_G(loopcounter)++;
 
+	if (_G(benchmarkTicksLeft) > 0 && --_G(benchmarkTicksLeft) == 0)
+		_G(want_exit) = true;
+
 	if (_GP(play).wait_counter > 0) _GP(play).wait_counter--;
 	if (_GP(play).shakesc_length > 0) _GP(play).shakesc_length--;
 
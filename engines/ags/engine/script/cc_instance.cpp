@@ -542,6 +542,93 @@ inline bool FixupArgument(RuntimeScriptValue &arg, const int fixup, const uintpt
 	}
 }
 
+// Assigns the second argument of the operation at pc, if its fixup was
+// resolved when the code was decoded; returns false if it has to be fixed up
+inline bool GetResolvedArgument(RuntimeScriptValue &arg, ScriptDecodedCode &decoded, int32_t pc) {
+	const ScriptDecodedCode::Op &op = decoded.Ops[pc];
+	if (op.ResolvedArg < 0)
+		return false;
+	if (op.ArgFixup != FIXUP_IMPORT) {
+		arg = decoded.ResolvedArgs[op.ResolvedArg];
+		return true;
+	}
+
+	if (decoded.ImportsVersion != _GP(simp).getVersion())
+		decoded.ResolveImports();
+	const ScriptDecodedCode::Import &import = decoded.Imports[op.ResolvedArg];
+	if (!import.Found)
+		return false; // let FixupArgument report the error
+	arg = import.Value;
+	return true;
+}
+
+// Starts or stops the script clock, and restores its previous state when it
+// goes out of scope. The clock measures the real time spent running the
+// byte-code, without the engine and plugin functions that it calls. It only
+// runs while the statistics are wanted, as reading the time around every
+// engine call is not free.
+class ScriptClock {
+public:
+	explicit ScriptClock(bool running) : _enabled(_G(scriptClockEnabled)), _wasRunning(_G(scriptClockRunning)) {
+		if (_enabled)
+			Set(running);
+	}
+	~ScriptClock() {
+		if (_enabled)
+			Set(_wasRunning);
+	}
+
+private:
+	static void Set(bool running) {
+		if (running == _G(scriptClockRunning))
+			return;
+		const uint32 now = AGS_Clock::now();
+		if (running)
+			_G(scriptClockStart) = now;
+		else
+			_G(scriptRunTime) += now - _G(scriptClockStart);
+		_G(scriptClockRunning) = running;
+	}
+
+	const bool _enabled;
+	const bool _wasRunning;
+};
+
+// Adds the instructions run by a Run() call to the statistics
+struct ScriptInstructionCounter {
+	~ScriptInstructionCounter() {
+		_G(scriptInstructions) += Count;
+	}
+
+	uint32_t Count = 0;
+};
+
+String cc_get_exec_stats() {
+	const unsigned int ticks = _G(loopcounter) - _G(scriptStatsLoopCounter);
+	const uint32 time = _G(scriptRunTime);
+	String stats = String::FromFormat("Game ticks: %u\n", ticks);
+	stats.AppendFmt("Script instructions: %llu\n", (unsigned long long)_G(scriptInstructions));
+	if (!_G(scriptClockEnabled)) {
+		stats.Append("Time spent in scripts is measured after resetting the statistics\n");
+		return stats;
+	}
+	stats.AppendFmt("Time spent in scripts, without engine calls: %u ms\n", time);
+	if (time > 0) {
+		stats.AppendFmt("Ticks per second of script time: %u\n", (uint32)((uint64)ticks * 1000 / time));
+		stats.AppendFmt("Script instructions per second: %llu\n", (unsigned long long)(_G(scriptInstructions) * 1000 / time));
+	}
+	return stats;
+}
+
+void cc_reset_exec_stats() {
+	_G(scriptInstructions) = 0;
+	_G(scriptRunTime) = 0;
+	_G(scriptStatsLoopCounter) = _G(loopcounter);
+	_G(scriptClockEnabled) = true;
+	if (_G(scriptClockRunning))
+		_G(scriptClockStart) = AGS_Clock::now();
+}
+
 #define MAXNEST 50  // number of recursive function calls allowed
 int ccInstance::Run(int32_t curpc) {
 	pc = curpc;
@@ -560,7 +647,11 @@ int ccInstance::Run(int32_t curpc) {
 	thisbase[0] = 0;
 	funcstart[0] = pc;
 	ccInstance *codeInst = runningInst;
-	ScriptOperation codeOp;
+	if (!codeInst->decoded_code)
+		codeInst->CreateDecodedCode();
+	// Keep a reference, in case the instance is freed while it runs
+	const std::shared_ptr<ScriptDecodedCode> decoded = codeInst->decoded_code;
+	const ScriptDecodedCode::Op *const decodedOps = decoded->Ops.data();
 	FunctionCallStack func_callstack;
 #if DEBUG_CC_EXEC
 	const bool dump_opcodes = (ccGetOption(SCOPT_DEBUGRUN) != 0) ||
@@ -572,6 +663,8 @@ int ccInstance::Run(int32_t curpc) {
 
 	const auto timeout = std::chrono::milliseconds(_G(timeoutCheckMs));
 	_lastAliveTs = AGS_Clock::now();
+	ScriptClock scriptClock(true);
+	ScriptInstructionCounter instructionCounter;
 
 	/* Main bytecode execution loop */
 	//=====================================================================
@@ -583,47 +676,38 @@ int ccInstance::Run(int32_t curpc) {
 		//
 		/* Read operation */
 		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-							"invalid instruction %d found in code stream", codeOp.Instruction.Code);
-
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
-
-		CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
-							"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-
-
-		// Read arguments; use switch as it proved to be faster than the loop
-
-		switch (codeOp.ArgCount) {
-		case 3:
-			codeOp.Args[2].SetInt32(static_cast<int32_t>(codeInst->code[pc + 3]));
-			/* fall-through */
-		case 2:
-			codeOp.Args[1].SetInt32(static_cast<int32_t>(codeInst->code[pc + 2]));
-			/* fall-through */
-		case 1:
-			codeOp.Args[0].SetInt32(static_cast<int32_t>(codeInst->code[pc + 1]));
-			break;
-		default:
-			break;
+		if (static_cast<uint32_t>(pc) >= static_cast<uint32_t>(codeInst->codesize)) {
+			cc_error("unexpected end of code data (%d; %d)", pc, codeInst->codesize);
+			return -1;
+		}
+		const ScriptDecodedCode::Op &codeOp = decodedOps[pc];
+		if (codeOp.Code == ScriptDecodedCode::kInvalidCode) {
+			const int32_t instr = static_cast<int32_t>(codeInst->code[pc]) & INSTANCE_ID_REMOVEMASK;
+			if (instr < 0 || instr >= CC_NUM_SCCMDS)
+				cc_error("invalid instruction %d found in code stream", instr);
+			else
+				cc_error("unexpected end of code data (%d; %d)", pc + (*g_commands)[instr].ArgCount, codeInst->codesize);
+			return -1;
 		}
+		instructionCounter.Count++;
 		//---------------------------------------------------------------------
 		/* End read operation */
 		//=====================================================================
 
 #if (DEBUG_CC_EXEC)
 		if (dump_opcodes) {
-			DumpInstruction(codeOp);
+			ScriptOperation dumpOp;
+			dumpOp.Instruction = ScriptInstruction(codeOp.Code, codeOp.InstanceId);
+			dumpOp.ArgCount = codeOp.ArgCount;
+			for (int i = 0; i < codeOp.ArgCount; ++i)
+				dumpOp.Args[i].SetInt32(codeOp.Args[i]);
+			DumpInstruction(dumpOp);
 		}
 #endif
 
 		/* Perform operation */
 		//=====================================================================
-		switch (codeOp.Instruction.Code) {
+		switch (codeOp.Code) {
 		case SCMD_LINENUM:
 			line_number = codeOp.Arg1i();
 			_G(currentline) = line_number;
@@ -692,9 +776,11 @@ int ccInstance::Run(int32_t curpc) {
 			// be only up to 4 bytes large;
 			// I guess that's an obsolete way to do WRITE, WRITEW and WRITEB
 			const auto arg_size = codeOp.Arg1i();
-			FixupArgument(codeOp.Args[1], codeInst->code_fixups[pc + 2], codeInst->code[pc + 2], this->stack, codeInst->strings);
-			ASSERT_CC_ERROR();
-			const auto &arg_value = codeOp.Arg2();
+			RuntimeScriptValue arg_value;
+			if (!GetResolvedArgument(arg_value, *decoded, pc)) {
+				FixupArgument(arg_value, codeInst->code_fixups[pc + 2], codeInst->code[pc + 2], this->stack, codeInst->strings);
+				ASSERT_CC_ERROR();
+			}
 			switch (arg_size) {
 			case sizeof(char):
 				registers[SREG_MAR].WriteByte(arg_value.IValue);
@@ -729,9 +815,11 @@ int ccInstance::Run(int32_t curpc) {
 		}
 		case SCMD_LITTOREG: {
 			auto &reg1 = registers[codeOp.Arg1i()];
-			FixupArgument(codeOp.Args[1], codeInst->code_fixups[pc + 2], codeInst->code[pc + 2], this->stack, codeInst->strings);
-			ASSERT_CC_ERROR();
-			const auto &arg_value = codeOp.Arg2();
+			RuntimeScriptValue arg_value;
+			if (!GetResolvedArgument(arg_value, *decoded, pc)) {
+				FixupArgument(arg_value, codeInst->code_fixups[pc + 2], codeInst->code[pc + 2], this->stack, codeInst->strings);
+				ASSERT_CC_ERROR();
+			}
 			reg1 = arg_value;
 			break;
 		}
@@ -1158,7 +1246,7 @@ int ccInstance::Run(int32_t curpc) {
 			ccInstance *wasRunning = runningInst;
 
 			// extract the instance ID
-			int32_t instId = codeOp.Instruction.InstanceId;
+			int32_t instId = codeOp.InstanceId;
 			// determine the offset into the code of the instance we want
 			runningInst = _G(loadedInstances)[instId];
 			uintptr_t callAddr = reg1.PtrU8 - reinterpret_cast<uint8_t *>(&runningInst->code[0]);
@@ -1200,6 +1288,8 @@ int ccInstance::Run(int32_t curpc) {
 			}
 
 			RuntimeScriptValue return_value;
+			// Engine functions don't count as script time
+			ScriptClock engineCallClock(false);
 
 			if (reg1.Type == kScValPluginFunction) {
 				_GP(GlobalReturnValue).Invalidate();
@@ -1318,7 +1408,7 @@ int ccInstance::Run(int32_t curpc) {
 		case SCMD_NEWARRAY: {
 			auto &reg1 = registers[codeOp.Arg1i()];
 			const auto arg_elsize = codeOp.Arg2i();
-			const auto arg_managed = codeOp.Arg3().GetAsBool();
+			const auto arg_managed = codeOp.Arg3i() != 0;
 			int numElements = reg1.IValue;
 			if (numElements < 1) {
 				cc_error("invalid size for dynamic array; requested: %d, range: 1..%d", numElements, INT32_MAX);
@@ -1458,7 +1548,7 @@ int ccInstance::Run(int32_t curpc) {
 				loopIterationCheckDisabled++;
 			break;
 		default:
-			cc_error("instruction %d is not implemented", codeOp.Instruction.Code);
+			cc_error("instruction %d is not implemented", codeOp.Code);
 			return -1;
 		}
 		/* End perform operation */
@@ -1651,6 +1741,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		decoded_code = joined->decoded_code;
 	} else {
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
@@ -1740,6 +1831,7 @@ void ccInstance::Free() {
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	decoded_code.reset();
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1950,9 +2042,73 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
 	}
+
+	CreateDecodedCode();
 	return true;
 }
 
+void ccInstance::CreateDecodedCode() {
+	decoded_code.reset(new ScriptDecodedCode());
+	ScriptDecodedCode &decoded = *decoded_code;
+	decoded.Ops.resize(codesize);
+	for (int32_t pos = 0; pos < codesize; ++pos) {
+		const int32_t code_value = static_cast<int32_t>(code[pos]);
+		const int32_t instr = code_value & INSTANCE_ID_REMOVEMASK;
+		if (instr < 0 || instr >= CC_NUM_SCCMDS)
+			continue;
+		const int arg_count = (*g_commands)[instr].ArgCount;
+		if (pos + arg_count >= codesize)
+			continue;
+
+		ScriptDecodedCode::Op &op = decoded.Ops[pos];
+		op.Code = static_cast<uint8_t>(instr);
+		op.InstanceId = static_cast<uint8_t>((code_value >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+		op.ArgCount = static_cast<uint8_t>(arg_count);
+		for (int i = 0; i < arg_count; ++i)
+			op.Args[i] = static_cast<int32_t>(code[pos + 1 + i]);
+
+		// Only these instructions take a literal argument which may need a fixup
+		if (instr != SCMD_WRITELIT && instr != SCMD_LITTOREG)
+			continue;
+		const int fixup = code_fixups[pos + 2];
+		switch (fixup) {
+		case FIXUP_GLOBALDATA:
+		case FIXUP_FUNCTION:
+		case FIXUP_STRING: {
+			RuntimeScriptValue arg;
+			FixupArgument(arg, fixup, code[pos + 2], stack, strings);
+			op.ArgFixup = static_cast<uint8_t>(fixup);
+			op.ResolvedArg = static_cast<int32_t>(decoded.ResolvedArgs.size());
+			decoded.ResolvedArgs.push_back(arg);
+			break;
+		}
+		case FIXUP_IMPORT: {
+			ScriptDecodedCode::Import import;
+			import.Index = static_cast<uint32_t>(code[pos + 2]);
+			op.ArgFixup = static_cast<uint8_t>(fixup);
+			op.ResolvedArg = static_cast<int32_t>(decoded.Imports.size());
+			decoded.Imports.push_back(import);
+			break;
+		}
+		default:
+			break; // stack offsets are fixed up when the instruction runs
+		}
+	}
+	decoded.ResolveImports();
+}
+
+void ScriptDecodedCode::ResolveImports() {
+	for (auto &import : Imports) {
+		const ScriptImport *sys_import = _GP(simp).getByIndex(import.Index);
+		import.Found = sys_import != nullptr;
+		if (import.Found)
+			import.Value = sys_import->Value;
+		else
+			import.Value.Invalidate();
+	}
+	ImportsVersion = _GP(simp).getVersion();
+}
+
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval) {
 	// Write value to the stack tail and advance stack ptr
 	registers[SREG_SP].WriteValue(rval);
@@ -83,6 +83,50 @@ struct ScriptOperation {
 	inline int Arg3i() const { return Args[2].IValue; }
 };
 
+// Byte-code of a script, decoded once for ccInstance::Run(), so that running
+// an instruction needs neither to look up its command nor to read its
+// arguments from the byte-code.
+// Every position of the code is decoded as if an instruction started there,
+// since the program counter, jump offsets, return addresses and the call
+// stack all refer to positions of the byte-code.
+// The fixups of literal arguments which do not depend on the stack are
+// resolved here too, instead of each time the instruction runs.
+struct ScriptDecodedCode {
+	enum {
+		kInvalidCode = 0xFF
+	};
+
+	struct Op {
+		uint8_t Code = kInvalidCode; // instruction code without the instance id, or kInvalidCode
+		uint8_t InstanceId = 0;
+		uint8_t ArgCount = 0;
+		uint8_t ArgFixup = 0;        // fixup type of the resolved argument
+		int32_t ResolvedArg = -1;    // index of the resolved second argument, or -1
+		int32_t Args[MAX_SCMD_ARGS] = {}; // arguments, as integer literals
+
+		// returns argN as a integer literal, 1-based
+		inline int Arg1i() const { return Args[0]; }
+		inline int Arg2i() const { return Args[1]; }
+		inline int Arg3i() const { return Args[2]; }
+	};
+
+	// An argument which refers to a system import; imports may be replaced
+	// or removed later, so these are resolved again when the imports change
+	struct Import {
+		uint32_t Index = 0;          // index of the system import
+		bool Found = false;
+		RuntimeScriptValue Value;
+	};
+
+	std::vector<Op> Ops;                          // one for each position of the byte-code
+	std::vector<RuntimeScriptValue> ResolvedArgs; // global data, function and string arguments
+	std::vector<Import> Imports;                  // import arguments
+	uint32_t ImportsVersion = 0;                  // version of the system imports they were resolved with
+
+	// Resolves the import arguments with the current system imports
+	void ResolveImports();
+};
+
 struct ScriptVariable {
 	ScriptVariable() {
 		ScAddress = -1; // address = 0 is valid one, -1 means undefined
@@ -154,6 +198,8 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// byte-code decoded for execution, shared with the forks like code_fixups
+	std::shared_ptr<ScriptDecodedCode> decoded_code;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -208,6 +254,8 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Decodes the byte-code, once the fixups and imports are resolved
+	void    CreateDecodedCode();
 
 	// Begin executing script starting from the given bytecode index
 	int     Run(int32_t curpc);
@@ -238,6 +286,11 @@ private:
 extern void script_commands_init();
 extern void script_commands_free();
 
+// Gets the statistics of the script interpreter as human-readable text
+extern Shared::String cc_get_exec_stats();
+// Starts the statistics of the script interpreter over
+extern void cc_reset_exec_stats();
+
 } // namespace AGS3
 
 #endif
@@ -31,6 +31,7 @@ uint32_t SystemImports::add(const String &name, const RuntimeScriptValue &value,
 		if (anotherscr == nullptr) {
 			imports[ixof].Value = value;
 			imports[ixof].InstancePtr = anotherscr;
+			version++;
 		}
 		return ixof;
 	}
@@ -49,6 +50,7 @@ uint32_t SystemImports::add(const String &name, const RuntimeScriptValue &value,
 	imports[ixof].Name = name;
 	imports[ixof].Value = value;
 	imports[ixof].InstancePtr = anotherscr;
+	version++;
 	return ixof;
 }
 
@@ -60,6 +62,7 @@ void SystemImports::remove(const String &name) {
 	imports[idx].Name = nullptr;
 	imports[idx].Value.Invalidate();
 	imports[idx].InstancePtr = nullptr;
+	version++;
 }
 
 const ScriptImport *SystemImports::getByName(const String &name) {
@@ -123,6 +126,7 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 			import.Name = nullptr;
 			import.Value.Invalidate();
 			import.InstancePtr = nullptr;
+			version++;
 		}
 	}
 }
@@ -130,6 +134,7 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 void SystemImports::clear() {
 	btree.clear();
 	imports.clear();
+	version++;
 }
 
 } // namespace AGS3
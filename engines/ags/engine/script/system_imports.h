@@ -49,6 +49,8 @@ private:
 
 	std::vector<ScriptImport> imports;
 	IndexMap btree;
+	// Incremented whenever an import is added, replaced or removed
+	uint32_t version = 0;
 
 public:
 	uint32_t add(const String &name, const RuntimeScriptValue &value, ccInstance *inst);
@@ -59,6 +61,7 @@ public:
 	String findName(const RuntimeScriptValue &value);
 	void RemoveScriptExports(ccInstance *inst);
 	void clear();
+	uint32_t getVersion() const { return version; }
 };
 
 } // namespace AGS3
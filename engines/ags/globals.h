@@ -396,6 +396,14 @@ public:
 	// Of 2012-12-20: now used only for plugin exports
 	RuntimeScriptValue *_GlobalReturnValue;
 	Common::DumpFile *_scriptDumpFile = nullptr;
+	// Statistics of the script interpreter, see cc_get_exec_stats()
+	uint64 _scriptInstructions = 0;
+	uint32 _scriptRunTime = 0; // real time spent running byte-code, without engine calls, in ms
+	uint32 _scriptClockStart = 0;
+	bool _scriptClockEnabled = false; // whether _scriptRunTime is measured
+	bool _scriptClockRunning = false;
+	unsigned int _scriptStatsLoopCounter = 0; // _loopcounter when the statistics were reset
+	unsigned int _benchmarkTicksLeft = 0; // game ticks until the game quits, for ags_benchmark_ticks
 
 	/**@}*/
 
@@ -929,6 +929,9 @@ Common::Error Engine::saveGameState(int slot, const Common::String &desc, bool i
 	}
 
 	delete saveFile;
+
+	if (result.getCode() == Common::kNoError)
+		getMetaEngine()->updateSaveIndex(_targetName.c_str(), slot, desc, isAutosave);
 	return result;
 }
 
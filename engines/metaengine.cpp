@@ -26,6 +26,9 @@
 #include "backends/keymapper/keymap.h"
 #include "backends/keymapper/standard-actions.h"
 
+#include "common/hash-str.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
 #include "common/savefile.h"
 #include "common/system.h"
 #include "common/translation.h"
@@ -394,8 +397,116 @@ SaveStateList MetaEngine::listSaves(const char *target) const {
 	return saveList;
 }
 
+namespace {
+
+enum {
+	kSaveIndexEntryVersion = 1
+};
+
+enum SaveIndexFlags {
+	kSaveIndexListed       = 1 << 0, ///< The file was listed, as a save or not
+	kSaveIndexIsSave       = 1 << 1, ///< The file is a save, its list descriptor follows
+	kSaveIndexHasMetaInfos = 1 << 2  ///< The meta infos of the save follow
+};
+
+/** What the save index knows about a save file. */
+struct SaveIndexEntry {
+	SaveIndexEntry() : flags(0) {}
+
+	byte flags;
+	SaveStateDescriptor listDesc;
+	SaveStateDescriptor metaInfos;
+};
+
+bool readSaveIndexEntry(const char *target, const Common::String &filename, SaveIndexEntry &entry) {
+	Common::ScopedPtr<Common::SeekableReadStream> in(g_system->getSavefileManager()->readSaveIndexEntry(target, filename));
+	if (!in || in->readByte() != kSaveIndexEntryVersion)
+		return false;
+
+	SaveIndexEntry result;
+	result.flags = in->readByte();
+	if ((result.flags & kSaveIndexIsSave) && !result.listDesc.loadFromStream(*in))
+		return false;
+	if ((result.flags & kSaveIndexHasMetaInfos) && !result.metaInfos.loadFromStream(*in))
+		return false;
+
+	entry = result;
+	return true;
+}
+
+void writeSaveIndexEntry(const char *target, const Common::String &filename, const SaveIndexEntry &entry) {
+	Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+	out.writeByte(kSaveIndexEntryVersion);
+	out.writeByte(entry.flags);
+	if ((entry.flags & kSaveIndexIsSave) && !entry.listDesc.saveToStream(out))
+		return;
+	if ((entry.flags & kSaveIndexHasMetaInfos) && !entry.metaInfos.saveToStream(out))
+		return;
+
+	g_system->getSavefileManager()->writeSaveIndexEntry(target, filename, out.getData(), out.size());
+}
+
+bool usesSaveIndex(const MetaEngine &metaEngine) {
+	// Otherwise, there is no telling which file holds which slot
+	return metaEngine.hasFeature(MetaEngine::kSimpleSavesNames) || metaEngine.hasFeature(MetaEngine::kSavesUseExtendedFormat);
+}
+
+SaveStateList listIndexedSaves(const MetaEngine &metaEngine, const char *target) {
+	if (!usesSaveIndex(metaEngine))
+		return metaEngine.listSaves(target);
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const Common::StringArray filenames = saveFileMan->listSavefiles(metaEngine.getSavegameFilePattern(target));
+
+	// Use the index if it knows all the files
+	SaveStateList saveList;
+	Common::Array<SaveIndexEntry> entries(filenames.size());
+	bool complete = !filenames.empty();
+	for (uint i = 0; i < filenames.size(); i++) {
+		if (!readSaveIndexEntry(target, filenames[i], entries[i]) || !(entries[i].flags & kSaveIndexListed))
+			complete = false;
+		else if (entries[i].flags & kSaveIndexIsSave)
+			saveList.push_back(entries[i].listDesc);
+	}
+
+	if (complete) {
+		Common::sort(saveList.begin(), saveList.end(), SaveStateDescriptorSlotComparator());
+		return saveList;
+	}
+
+	saveList = metaEngine.listSaves(target);
+
+	// Only index the list if every save comes from one of the files
+	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> files;
+	for (uint i = 0; i < filenames.size(); i++)
+		files[filenames[i]] = true;
+
+	Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> saves;
+	for (uint i = 0; i < saveList.size(); i++) {
+		const Common::String filename = metaEngine.getSavegameFile(saveList[i].getSaveSlot(), target);
+		if (saveList[i].getLocked() || !files.contains(filename))
+			return saveList;
+		saves[filename] = i;
+	}
+
+	for (uint i = 0; i < filenames.size(); i++) {
+		SaveIndexEntry &entry = entries[i];
+		entry.flags = (entry.flags & kSaveIndexHasMetaInfos) | kSaveIndexListed;
+		if (saves.contains(filenames[i])) {
+			entry.flags |= kSaveIndexIsSave;
+			entry.listDesc = saveList[saves[filenames[i]]];
+		}
+		writeSaveIndexEntry(target, filenames[i], entry);
+	}
+	saveFileMan->flushSaveIndexes();
+
+	return saveList;
+}
+
+} // End of anonymous namespace
+
 SaveStateList MetaEngine::listSaves(const char *target, bool saveMode) const {
-	SaveStateList saveList = listSaves(target);
+	SaveStateList saveList = listIndexedSaves(*this, target);
 	int autosaveSlot = getAutosaveSlot();
 	if (!saveMode || autosaveSlot == -1)
 		return saveList;
@@ -442,6 +553,44 @@ GUI::OptionsContainerWidget *MetaEngine::buildEngineOptionsWidget(GUI::GuiObject
 	return new GUI::ExtraGuiOptionsWidget(boss, name, target, engineOptions);
 }
 
+SaveStateDescriptor MetaEngine::queryIndexedSaveMetaInfos(const char *target, int slot) const {
+	if (!usesSaveIndex(*this))
+		return querySaveMetaInfos(target, slot);
+
+	const Common::String filename = getSavegameFile(slot, target);
+	SaveIndexEntry entry;
+	readSaveIndexEntry(target, filename, entry);
+	if (entry.flags & kSaveIndexHasMetaInfos)
+		return entry.metaInfos;
+
+	SaveStateDescriptor desc = querySaveMetaInfos(target, slot);
+	if (desc.getSaveSlot() != slot || desc.getLocked())
+		return desc;
+
+	// Keep the index small, the dialogs scale thumbnails down anyway
+	entry.metaInfos = desc;
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (thumbnail && thumbnail->w > kThumbnailWidth)
+		entry.metaInfos.setThumbnail(Graphics::scale(*thumbnail, kThumbnailWidth, thumbnail->h * kThumbnailWidth / thumbnail->w));
+	entry.flags |= kSaveIndexHasMetaInfos;
+	writeSaveIndexEntry(target, filename, entry);
+
+	return desc;
+}
+
+void MetaEngine::updateSaveIndex(const char *target, int slot, const Common::String &desc, bool isAutosave) const {
+	if (!usesSaveIndex(*this))
+		return;
+
+	// The file is listed with the description of its extended save header,
+	// the meta infos are read again when they are needed
+	SaveIndexEntry entry;
+	entry.flags = kSaveIndexListed | kSaveIndexIsSave;
+	entry.listDesc = SaveStateDescriptor(this, slot, desc);
+	entry.listDesc.setAutosave(isAutosave);
+	writeSaveIndexEntry(target, getSavegameFile(slot, target), entry);
+}
+
 bool MetaEngine::removeSaveState(const char *target, int slot) const {
 	if (!hasFeature(kSavesUseExtendedFormat))
 		return false;
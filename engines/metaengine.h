@@ -300,7 +300,9 @@ public:
 	 * Return a list of all save states associated with the given target.
 	 *
 	 * This is a wrapper around the basic listSaves virtual method, but it has
-	 * some extra logic for autosave handling.
+	 * some extra logic for autosave handling. For engines which store each
+	 * save in its own file, the list is taken from the save index as long
+	 * as the save files did not change.
 	 *
 	 * @param target    Name of a config manager target.
 	 * @param saveMode  If true, get the list for a save dialog.
@@ -358,6 +360,30 @@ public:
 	 */
 	virtual SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const;
 
+	/**
+	 * Return meta information from the specified save state like
+	 * querySaveMetaInfos(), but take it from the save index as long as the
+	 * save file did not change.
+	 *
+	 * The index keeps thumbnails at the usual thumbnail size at most.
+	 *
+	 * @param target  Name of a config manager target.
+	 * @param slot    Slot number of the save state.
+	 */
+	SaveStateDescriptor queryIndexedSaveMetaInfos(const char *target, int slot) const;
+
+	/**
+	 * Update the save index after a save state was written with the extended
+	 * save format, so that listing the saves does not need to read all of
+	 * them again.
+	 *
+	 * @param target      Name of a config manager target.
+	 * @param slot        Slot number of the save state.
+	 * @param desc        Description of the save state.
+	 * @param isAutosave  Whether the save state is an autosave.
+	 */
+	void updateSaveIndex(const char *target, int slot, const Common::String &desc, bool isAutosave) const;
+
 	/**
 	 * Return the name of the save file for the given slot and optional target,
 	 * or a pattern for matching filenames against.
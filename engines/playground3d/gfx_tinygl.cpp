@@ -95,6 +95,8 @@ void TinyGLRenderer::init() {
 
 	_context = TinyGL::createContext(kOriginalWidth, kOriginalHeight, g_system->getScreenFormat(), 512, true, ConfMan.getBool("dirtyrects"));
 	TinyGL::setContext(_context);
+	if (ConfMan.hasKey("tinygl_tile_size"))
+		TinyGL::setTileSize(ConfMan.getInt("tinygl_tile_size"));
 
 	tglMatrixMode(TGL_PROJECTION);
 	tglLoadIdentity();
@@ -21,8 +21,10 @@
 
 #include "common/scummsys.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/error.h"
 #include "common/events.h"
+#include "common/tokenizer.h"
 
 #include "graphics/renderer.h"
 
@@ -88,6 +90,26 @@ Common::Error Playground3dEngine::run() {
 		_fogColor = Math::Vector4d(1.0f, 1.0f, 1.0f, 1.0f);
 	}
 
+	if (ConfMan.hasKey("playground3d_benchmark")) {
+		runBenchmark(ConfMan.getInt("playground3d_benchmark"));
+	} else {
+		setupTest(testId);
+
+		while (!shouldQuit()) {
+			processInput();
+			drawFrame(testId);
+		}
+
+		cleanupTest();
+	}
+
+	_gfx->deinit();
+	_system->showMouse(false);
+
+	return Common::kNoError;
+}
+
+void Playground3dEngine::setupTest(int testId) {
 	switch (testId) {
 		case 1:
 			_clearColor = Math::Vector4d(0.5f, 0.5f, 0.5f, 1.0f);
@@ -124,21 +146,64 @@ Common::Error Playground3dEngine::run() {
 		default:
 			assert(false);
 	}
+}
 
-	while (!shouldQuit()) {
-		processInput();
-		drawFrame(testId);
-	}
-
+void Playground3dEngine::cleanupTest() {
 	delete _rgbaTexture;
 	delete _rgbTexture;
 	delete _rgb565Texture;
 	delete _rgba5551Texture;
 	delete _rgba4444Texture;
-	_gfx->deinit();
-	_system->showMouse(false);
+	_rgbaTexture = nullptr;
+	_rgbTexture = nullptr;
+	_rgb565Texture = nullptr;
+	_rgba5551Texture = nullptr;
+	_rgba4444Texture = nullptr;
+}
 
-	return Common::kNoError;
+// Draws each test scene listed in playground3d_benchmark_tests, or all of
+// them, for the given number of frames, without the frame limiter, and logs
+// the average time spent per frame.
+void Playground3dEngine::runBenchmark(int frames) {
+	if (frames <= 0)
+		frames = 300;
+
+	Common::Array<int> testIds;
+	if (ConfMan.hasKey("playground3d_benchmark_tests")) {
+		Common::StringTokenizer tokenizer(ConfMan.get("playground3d_benchmark_tests"), " ,");
+		while (!tokenizer.empty()) {
+			Common::String token = tokenizer.nextToken();
+			int testId = atoi(token.c_str());
+			if (testId < 1 || testId > 5) {
+				warning("Playground3d benchmark: unknown test '%s'", token.c_str());
+				continue;
+			}
+			testIds.push_back(testId);
+		}
+	} else {
+		for (int testId = 1; testId <= 5; testId++)
+			testIds.push_back(testId);
+	}
+
+	for (uint i = 0; i < testIds.size() && !shouldQuit(); i++) {
+		int testId = testIds[i];
+		setupTest(testId);
+
+		uint32 startTime = _system->getMillis();
+		int frame;
+		for (frame = 0; frame < frames && !shouldQuit(); frame++) {
+			processInput();
+			drawFrame(testId, false);
+		}
+		uint32 elapsed = _system->getMillis() - startTime;
+
+		if (frame > 0) {
+			debug("Playground3d benchmark: test %d, %d frames in %d ms, %.3f ms per frame",
+			      testId, frame, elapsed, (float)elapsed / frame);
+		}
+
+		cleanupTest();
+	}
 }
 
 void Playground3dEngine::processInput() {
@@ -218,7 +283,7 @@ void Playground3dEngine::drawRgbaTexture() {
 	_gfx->drawRgbaTexture();
 }
 
-void Playground3dEngine::drawFrame(int testId) {
+void Playground3dEngine::drawFrame(int testId, bool limitFrameRate) {
 	_gfx->clear(_clearColor);
 
 	float pitch = 0.0f;
@@ -260,9 +325,13 @@ void Playground3dEngine::drawFrame(int testId) {
 
 	_gfx->flipBuffer();
 
-	_frameLimiter->delayBeforeSwap();
+	if (limitFrameRate) {
+		_frameLimiter->delayBeforeSwap();
+	}
 	_system->updateScreen();
-	_frameLimiter->startFrame();
+	if (limitFrameRate) {
+		_frameLimiter->startFrame();
+	}
 }
 
 } // End of namespace Playground3d
@@ -43,7 +43,7 @@ public:
 
 	void processInput();
 
-	void drawFrame(int testId);
+	void drawFrame(int testId, bool limitFrameRate = true);
 
 private:
 	OSystem *_system;
@@ -62,6 +62,10 @@ private:
 
 	float _rotateAngleX, _rotateAngleY, _rotateAngleZ;
 
+	void setupTest(int testId);
+	void cleanupTest();
+	void runBenchmark(int frames);
+
 	Graphics::Surface *generateRgbaTexture(int width, int height, Graphics::PixelFormat format);
 	void drawAndRotateCube();
 	void drawPolyOffsetTest();
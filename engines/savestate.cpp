@@ -23,7 +23,9 @@
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "graphics/surface.h"
+#include "graphics/thumbnail.h"
 #include "common/config-manager.h"
+#include "common/stream.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 
@@ -111,3 +113,54 @@ bool SaveStateDescriptor::isValid() const
 {
 	return _slot >= 0 && !_description.empty();
 }
+
+bool SaveStateDescriptor::saveToStream(Common::WriteStream &out) const {
+	if (_thumbnail && _thumbnail->format.bytesPerPixel != 2 && _thumbnail->format.bytesPerPixel != 4)
+		return false;
+
+	const Common::String description = _description.encode();
+
+	out.writeSint32LE(_slot);
+	out.writeUint16LE(description.size());
+	out.writeString(description);
+	out.writeByte(_isDeletable);
+	out.writeByte(_isWriteProtected);
+	out.writeByte(_isLocked);
+	out.writeByte(_saveDate.size());
+	out.writeString(_saveDate);
+	out.writeByte(_saveTime.size());
+	out.writeString(_saveTime);
+	out.writeByte(_playTime.size());
+	out.writeString(_playTime);
+	out.writeUint32LE(_playTimeMSecs);
+	out.writeByte(_saveType);
+
+	out.writeByte(_thumbnail ? 1 : 0);
+	if (_thumbnail)
+		Graphics::saveThumbnail(out, *_thumbnail);
+
+	return !out.err();
+}
+
+bool SaveStateDescriptor::loadFromStream(Common::SeekableReadStream &in) {
+	_slot = in.readSint32LE();
+	_description = in.readString(0, in.readUint16LE()).decode();
+	_isDeletable = in.readByte() != 0;
+	_isWriteProtected = in.readByte() != 0;
+	_isLocked = in.readByte() != 0;
+	_saveDate = in.readPascalString();
+	_saveTime = in.readPascalString();
+	_playTime = in.readPascalString();
+	_playTimeMSecs = in.readUint32LE();
+	_saveType = (SaveType)in.readByte();
+
+	_thumbnail.reset();
+	if (in.readByte()) {
+		Graphics::Surface *thumbnail = nullptr;
+		if (!Graphics::loadThumbnail(in, thumbnail))
+			return false;
+		setThumbnail(thumbnail);
+	}
+
+	return !in.eos() && !in.err();
+}
@@ -29,6 +29,11 @@
 
 class MetaEngine;
 
+namespace Common {
+class SeekableReadStream;
+class WriteStream;
+}
+
 namespace Graphics {
 struct Surface;
 }
@@ -225,6 +230,18 @@ public:
 	 * Returns true if this entry is valid
 	 */
 	bool isValid() const;
+
+	/**
+	 * Write the descriptor, including its thumbnail, to a stream.
+	 *
+	 * @return false if the thumbnail can not be stored.
+	 */
+	bool saveToStream(Common::WriteStream &out) const;
+
+	/**
+	 * Read a descriptor written by saveToStream().
+	 */
+	bool loadFromStream(Common::SeekableReadStream &in);
 private:
 	/**
 	 * The saveslot id, as it would be passed to the "-x" command line switch.
@@ -95,6 +95,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("opcodes",			WRAP_METHOD(Console, cmdOpcodes));
 	registerCmd("selector",			WRAP_METHOD(Console, cmdSelector));
 	registerCmd("selectors",			WRAP_METHOD(Console, cmdSelectors));
+	registerCmd("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	registerCmd("kernfunctions",		WRAP_METHOD(Console, cmdKernelFunctions));
 	registerCmd("functions",		WRAP_METHOD(Console, cmdKernelFunctions));	// alias
 	registerCmd("kerncall", 		WRAP_METHOD(Console, cmdKernelCall));
@@ -117,6 +118,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -150,6 +152,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
+	registerCmd("frameout_benchmark", WRAP_METHOD(Console, cmdFrameOutBenchmark));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -336,6 +340,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" opcodes - Lists the opcode names\n");
 	debugPrintf(" selectors - Lists the selector names\n");
 	debugPrintf(" selector - Attempts to find the requested selector by name\n");
+	debugPrintf(" selector_cache - Shows or resets the selector lookup cache statistics\n");
 	debugPrintf(" functions - Lists the kernel functions\n");
 	debugPrintf(" class_table - Shows the available classes\n");
 	debugPrintf("\n");
@@ -357,6 +362,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_cache - Shows or changes the resource cache budget and statistics\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -386,6 +392,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" cel_cache - Shows or changes the capacity and statistics of the cel cache (SCI2+)\n");
+	debugPrintf(" frameout_benchmark - Measures how long the current scene takes to render (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -446,7 +454,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" bp_function / bpe - Sets a breakpoint on the execution of the specified exported function\n");
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
-	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" script_steps - Shows the number of executed SCI operations, and their speed\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -573,6 +581,33 @@ bool Console::cmdSelector(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		debugPrintf("Shows the hit rate of the selector lookup cache.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		debugPrintf("With 'reset', the cache is emptied and its statistics are cleared.\n");
+		return true;
+	}
+
+	SegManager *segMan = _engine->_gamestate->_segMan;
+
+	if (argc == 2) {
+		segMan->invalidateSelectorLookups();
+		segMan->_selectorLookupHits = 0;
+		segMan->_selectorLookupMisses = 0;
+		debugPrintf("Selector lookup cache reset\n");
+		return true;
+	}
+
+	const uint32 lookups = segMan->_selectorLookupHits + segMan->_selectorLookupMisses;
+	debugPrintf("Selector lookup cache: %u entries\n", segMan->_selectorLookupCache.size());
+	debugPrintf("Lookups: %u, hits: %u, misses: %u\n", lookups, segMan->_selectorLookupHits, segMan->_selectorLookupMisses);
+	if (lookups)
+		debugPrintf("Hit rate: %.1f%%\n", segMan->_selectorLookupHits * 100.0 / lookups);
+
+	return true;
+}
+
 bool Console::cmdSelectors(int argc, const char **argv) {
 	debugPrintf("Selector names in numeric order:\n");
 	Common::String selectorName;
@@ -1134,6 +1169,41 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc > 3) {
+		debugPrintf("Shows or changes the budget and statistics of the resource cache.\n");
+		debugPrintf("Usage: %s [reset | <size in KiB> [<limit in KiB>]]\n", argv[0]);
+		debugPrintf("The budget grows up to the limit when the game reloads freed resources.\n");
+		return true;
+	}
+
+	if (argc >= 2) {
+		if (!strcmp(argv[1], "reset")) {
+			resMan->resetCacheStats();
+		} else {
+			const int maxMemory = atoi(argv[1]) * 1024;
+			const int limit = argc == 3 ? atoi(argv[2]) * 1024 : MAX(maxMemory, resMan->getMaxMemoryLRULimit());
+			resMan->setMaxMemoryLRU(maxMemory, limit);
+		}
+	}
+
+	const ResourceManager::CacheStats &stats = resMan->getCacheStats();
+	const uint32 requests = stats.hits + stats.misses;
+	debugPrintf("Unlocked: %d KiB of %d KiB (limit %d KiB), locked: %d KiB\n",
+		resMan->getMemoryLRU() / 1024, resMan->getMaxMemoryLRU() / 1024,
+		resMan->getMaxMemoryLRULimit() / 1024, resMan->getMemoryLocked() / 1024);
+	debugPrintf("Requests: %u, hits: %u, misses: %u (%u of them reloads)\n",
+		requests, stats.hits, stats.misses, stats.refaults);
+	if (requests)
+		debugPrintf("Hit rate: %.1f%%\n", stats.hits * 100.0 / requests);
+	debugPrintf("Evictions: %u, prefetches: %u\n", stats.evictions, stats.prefetches);
+	debugPrintf("Time spent loading: %u ms\n", stats.loadTime);
+
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -2407,6 +2477,60 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc > 2) {
+		debugPrintf("Shows or changes the capacity and statistics of the cel cache.\n");
+		debugPrintf("Usage: %s [reset | <capacity>]\n", argv[0]);
+		return true;
+	}
+
+	CelCache &cache = *CelObj::getCache();
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset")) {
+			cache.resetStats();
+		} else {
+			cache.setCapacity(MAX(atoi(argv[1]), 0));
+		}
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	debugPrintf("Cel cache: %u of %u entries\n", cache.size(), cache.getCapacity());
+	debugPrintf("Lookups: %u, hits: %u, misses: %u\n", lookups, cache.getHits(), cache.getMisses());
+	if (lookups)
+		debugPrintf("Hit rate: %.1f%%\n", cache.getHits() * 100.0 / lookups);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
+bool Console::cmdFrameOutBenchmark(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not use frameOut\n");
+		return true;
+	}
+
+	if (argc > 2) {
+		debugPrintf("Renders the current scene repeatedly, redrawing all screen items and\n");
+		debugPrintf("getting their cels again for every frame, and shows how long it took.\n");
+		debugPrintf("Usage: %s [<frames>]\n", argv[0]);
+		return true;
+	}
+
+	const int frameCount = argc == 2 ? atoi(argv[1]) : 100;
+	_engine->_gfxFrameout->benchmarkFrameOut(this, MAX(frameCount, 0));
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
 
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	debugPrintf("Parse grammar, in strict GNF:\n");
@@ -3432,7 +3556,31 @@ bool Console::cmdViewAccumulatorObject(int argc, const char **argv) {
 }
 
 bool Console::cmdScriptSteps(int argc, const char **argv) {
-	debugPrintf("Number of executed SCI operations: %d\n", _engine->_gamestate->scriptStepCounter);
+	EngineState *s = _engine->_gamestate;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		s->scriptStepCounter = 0;
+		s->scriptFusedStepCounter = 0;
+		s->scriptRunTime = 0;
+		s->scriptClockEnabled = true;
+		return true;
+	}
+
+	if (argc != 1) {
+		debugPrintf("Shows the number of executed SCI operations.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Number of executed SCI operations: %d\n", s->scriptStepCounter);
+	debugPrintf("Executed as part of a superinstruction: %d\n", s->scriptFusedStepCounter);
+	if (!s->scriptClockEnabled) {
+		debugPrintf("Time spent in scripts is measured after \"%s reset\"\n", argv[0]);
+		return true;
+	}
+	debugPrintf("Time spent in scripts, without kernel calls: %u ms\n", s->scriptRunTime);
+	if (s->scriptRunTime)
+		debugPrintf("Operations per second: %u\n", (uint32)((uint64)s->scriptStepCounter * 1000 / s->scriptRunTime));
 	return true;
 }
 
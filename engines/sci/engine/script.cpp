@@ -74,6 +74,26 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	_decodedIndex.clear();
+	_decodedInstructions.clear();
+}
+
+const Script::DecodedInstruction &Script::decodeInstruction(uint32 offset) {
+	if (_decodedIndex.empty())
+		_decodedIndex.resize(getBufSize());
+
+	DecodedInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+
+	if (_decodedInstructions.size() >= 0xFFFF) {
+		_decodedOverflow = instruction;
+		return _decodedOverflow;
+	}
+
+	_decodedInstructions.push_back(instruction);
+	_decodedIndex[offset] = _decodedInstructions.size();
+	return _decodedInstructions.back();
 }
 
 enum {
@@ -93,6 +93,28 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+public:
+	/**
+	 * An instruction of the script, as read by readPMachineInstruction().
+	 */
+	struct DecodedInstruction {
+		uint16 size; /**< Size of the instruction in bytes */
+		byte extOpcode;
+		int16 opparams[4];
+	};
+
+private:
+	/**
+	 * Index + 1 into _decodedInstructions of the instruction at each offset of
+	 * the buffer, or 0 if it has not been decoded yet. Empty until the VM
+	 * runs code of the script.
+	 */
+	Common::Array<uint16> _decodedIndex;
+	Common::Array<DecodedInstruction> _decodedInstructions;
+	DecodedInstruction _decodedOverflow; /**< Used once the index is full */
+
+	const DecodedInstruction &decodeInstruction(uint32 offset);
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -131,6 +153,18 @@ public:
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
 	}
 
+	/**
+	 * Returns the instruction at the given offset, which is decoded on the
+	 * first call and kept until the script is freed. Used by the VM, so that
+	 * instructions which run repeatedly are only decoded once.
+	 * The reference is only valid until the next call.
+	 */
+	const DecodedInstruction &getDecodedInstruction(uint32 offset) {
+		if (offset < _decodedIndex.size() && _decodedIndex[offset])
+			return _decodedInstructions[_decodedIndex[offset] - 1];
+		return decodeInstruction(offset);
+	}
+
 public:
 	Script();
 	~Script() override;
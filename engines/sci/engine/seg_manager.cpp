@@ -42,6 +42,9 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_saveDirPtr = NULL_REG;
 	_parserPtr = NULL_REG;
 
+	_selectorLookupHits = 0;
+	_selectorLookupMisses = 0;
+
 #ifdef ENABLE_SCI32
 	_arraysSegId = 0;
 	_bitmapSegId = 0;
@@ -79,6 +82,8 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	invalidateSelectorLookups();
 }
 
 void SegManager::initSysStrings() {
@@ -96,6 +101,27 @@ void SegManager::initSysStrings() {
 	}
 }
 
+const SegManager::SelectorLookup *SegManager::findSelectorLookup(reg_t objPos, Selector selectorId) {
+	SelectorLookupKey key = { objPos, selectorId };
+	SelectorLookupCache::const_iterator it = _selectorLookupCache.find(key);
+	if (it == _selectorLookupCache.end()) {
+		++_selectorLookupMisses;
+		return nullptr;
+	}
+
+	++_selectorLookupHits;
+	return &it->_value;
+}
+
+void SegManager::cacheSelectorLookup(reg_t objPos, Selector selectorId, const SelectorLookup &lookup) {
+	SelectorLookupKey key = { objPos, selectorId };
+	_selectorLookupCache[key] = lookup;
+}
+
+void SegManager::invalidateSelectorLookups() {
+	_selectorLookupCache.clear();
+}
+
 SegmentId SegManager::findFreeSegment() const {
 	// The following is a very crude approach: We find a free segment id by
 	// scanning from the start. This can be slow if the number of segments
@@ -165,6 +191,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		invalidateSelectorLookups();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -1102,6 +1129,7 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 	scr->load(scriptNum, _resMan, _scriptPatcher, applyScriptPatches);
 	scr->initializeLocals(this);
 	scr->initializeObjects(this, segmentId, applyScriptPatches);
+	invalidateSelectorLookups();
 #ifdef ENABLE_SCI32
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
@@ -1133,6 +1161,8 @@ void SegManager::uninstantiateScript(int script_nr) {
 		uninstantiateScriptSci0(script_nr);
 	// FIXME: Add proper script uninstantiation for SCI 1.1
 
+	invalidateSelectorLookups();
+
 	if (!scr->getLockers()) {
 		// The actual script deletion seems to be done by SCI scripts themselves
 		scr->markDeleted();
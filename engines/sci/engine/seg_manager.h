@@ -460,7 +460,56 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	// 10. Selector lookup cache
+
+	/**
+	 * The result of looking up a selector in an object and its superclasses.
+	 * Clones keep the position of the object they were cloned from, so the
+	 * result only depends on that position and the selector.
+	 */
+	struct SelectorLookup {
+		SelectorType type;
+		int varIndex;  ///< index of the variable, for kSelectorVariable
+		reg_t funcAddr; ///< address of the method, for kSelectorMethod
+	};
+
+	/**
+	 * Return the cached lookup of a selector in the object at the given
+	 * position, or nullptr if it has not been cached yet.
+	 */
+	const SelectorLookup *findSelectorLookup(reg_t objPos, Selector selectorId);
+
+	/** Cache the lookup of a selector in the object at the given position. */
+	void cacheSelectorLookup(reg_t objPos, Selector selectorId, const SelectorLookup &lookup);
+
+	/**
+	 * Forget all cached selector lookups. This must be done whenever
+	 * scripts are loaded or unloaded, as their objects move.
+	 */
+	void invalidateSelectorLookups();
+
 private:
+	struct SelectorLookupKey {
+		reg_t objPos;
+		Selector selectorId;
+
+		bool operator==(const SelectorLookupKey &other) const {
+			return objPos == other.objPos && selectorId == other.selectorId;
+		}
+	};
+
+	struct SelectorLookupKey_Hash {
+		uint operator()(const SelectorLookupKey &x) const {
+			return (x.objPos.getSegment() << 3) ^ x.objPos.getOffset() ^ (x.selectorId << 18);
+		}
+	};
+
+	typedef Common::HashMap<SelectorLookupKey, SelectorLookup, SelectorLookupKey_Hash> SelectorLookupCache;
+
+	SelectorLookupCache _selectorLookupCache;
+	uint32 _selectorLookupHits;
+	uint32 _selectorLookupMisses;
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
@@ -336,31 +336,49 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x", PRINT_REG(obj_location));
 	}
 
-	int index = obj->locateVarSelector(segMan, selectorId);
-
-	if (index >= 0) {
-		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
+	// The lookup only depends on where the object is defined, and on the
+	// selector, so it is cached for the following sends.
+	SegManager::SelectorLookup lookup;
+	const SegManager::SelectorLookup *cached = segMan->findSelectorLookup(obj->getPos(), selectorId);
+	if (cached) {
+		lookup = *cached;
 	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
+		lookup.type = kSelectorNone;
+		lookup.funcAddr = NULL_REG;
+
+		lookup.varIndex = obj->locateVarSelector(segMan, selectorId);
+		if (lookup.varIndex >= 0) {
+			// Found it as a variable
+			lookup.type = kSelectorVariable;
+		} else {
+			// Check if it's a method, with recursive lookup in superclasses
+			const Object *cls = obj;
+			while (cls) {
+				int index = cls->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					lookup.type = kSelectorMethod;
+					lookup.funcAddr = cls->getFunction(index);
+					break;
+				} else {
+					cls = segMan->getObject(cls->getSuperClassSelector());
+				}
 			}
 		}
 
-		return kSelectorNone;
+		segMan->cacheSelectorLookup(obj->getPos(), selectorId, lookup);
+	}
+
+	if (lookup.type == kSelectorVariable) {
+		if (varp) {
+			varp->obj = obj_location;
+			varp->varindex = lookup.varIndex;
+		}
+	} else if (lookup.type == kSelectorMethod) {
+		if (fptr)
+			*fptr = lookup.funcAddr;
 	}
+
+	return lookup.type;
 }
 
 } // End of namespace Sci
@@ -83,6 +83,7 @@ void EngineState::reset(bool isRestoring) {
 		_memorySegmentSize = 0;
 		_fileHandles.resize(5);
 		abortScriptProcessing = kAbortNone;
+		scriptClockEnabled = false;
 	} else {
 		g_sci->_guestAdditions->reset();
 	}
@@ -118,6 +119,8 @@ void EngineState::reset(bool isRestoring) {
 	_cursorWorkaroundActive = false;
 
 	scriptStepCounter = 0;
+	scriptFusedStepCounter = 0;
+	scriptRunTime = 0;
 	scriptGCInterval = GC_INTERVAL;
 }
 
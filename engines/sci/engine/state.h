@@ -171,6 +171,10 @@ struct EngineState : public Common::Serializable {
 	int16 gameIsRestarting; // is set when restarting (=1) or restoring the game (=2)
 
 	int scriptStepCounter; // Counts the number of steps executed
+	int scriptFusedStepCounter; // Counts the steps which ran as part of a superinstruction
+	uint32 scriptRunTime; // Real time spent interpreting scripts, excluding kernel calls, in ms
+	bool scriptClockEnabled; // Whether scriptRunTime is measured, see the script_steps console command
+	int scriptStepLimit; // Number of steps after which the game quits, for the sci_benchmark_steps option, or 0
 	int scriptGCInterval; // Number of steps in between gcs
 
 	uint16 currentRoomNumber() const;
@@ -22,6 +22,7 @@
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/system.h"
 
 #include "sci/sci.h"
 #include "sci/console.h"
@@ -312,9 +313,59 @@ static void addKernelCallToExecStack(EngineState *s, int kernelCallNr, int kerne
 	s->_executionStack.push_back(xstack);
 }
 
+/**
+ * Starts or stops the script clock, and restores its previous state when it
+ * goes out of scope. The clock measures the real time spent interpreting
+ * scripts, without the kernel calls, for the script_steps command. It only
+ * runs if EngineState::scriptClockEnabled is set, as reading the time around
+ * every kernel call is not free.
+ */
+class ScriptClock {
+public:
+	ScriptClock(EngineState *s, bool running) : _s(s), _enabled(s->scriptClockEnabled), _wasRunning(_running) {
+		if (_enabled)
+			set(running);
+	}
+	~ScriptClock() {
+		if (_enabled)
+			set(_wasRunning);
+	}
+
+private:
+	void set(bool running) {
+		if (running == _running)
+			return;
+
+		const uint32 time = g_system->getMillis(true);
+		if (running)
+			_start = time;
+		else
+			_s->scriptRunTime += time - _start;
+		_running = running;
+	}
+
+	EngineState *_s;
+	bool _enabled;
+	bool _wasRunning;
+
+	static bool _running;
+	static uint32 _start;
+};
+
+bool ScriptClock::_running = false;
+uint32 ScriptClock::_start = 0;
+
 static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
+	ScriptClock scriptClock(s, false);
 	Kernel *kernel = g_sci->getKernel();
 
+	// Checked here rather than for every step, the game only quits once
+	// it polls for events anyway
+	if (s->scriptStepLimit && s->scriptStepCounter >= s->scriptStepLimit) {
+		s->scriptStepLimit = 0;
+		g_sci->quitGame();
+	}
+
 	if (kernelCallNr >= (int)kernel->_kernelFuncs.size())
 		error("Invalid kernel function 0x%x requested", kernelCallNr);
 
@@ -537,9 +588,84 @@ uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffse
 	return offset;
 }
 
+static inline void fetchInstruction(EngineState *s, Script *scr, byte &extOpcode, int16 opparams[4]) {
+	const Script::DecodedInstruction &instruction = scr->getDecodedInstruction(s->xs->addr.pc.getOffset());
+	extOpcode = instruction.extOpcode;
+	memcpy(opparams, instruction.opparams, sizeof(instruction.opparams));
+	s->xs->addr.pc.incOffset(instruction.size);
+}
+
+/**
+ * The sequences of instructions which run as superinstructions, i.e. without
+ * going back to the head of the loop in run_vm() in between.
+ */
+enum FusedSequence {
+	kFuseComparison, ///< ldi, followed by a comparison
+	kFuseBranch,     ///< a comparison, followed by bt or bnt
+	kFuseLofsa,      ///< a push, followed by lofsa
+	kFuseSend        ///< lofsa, followed by send
+};
+
+/**
+ * Fetches the next instruction, if the debugger doesn't need to see it and
+ * it continues the given sequence. This does the work of the head of the
+ * loop in run_vm() that the instructions of the sequences need.
+ */
+static bool fetchFusedInstruction(EngineState *s, Script *scr, FusedSequence sequence, byte &extOpcode, int16 opparams[4]) {
+	// Stepping and address breakpoints need to stop at every instruction
+	if (g_sci->_debugState.debugging || (g_sci->_debugState._activeBreakpointTypes & BREAK_ADDRESS))
+		return false;
+
+	// Leave the errors to the head of the loop
+	const uint32 offset = s->xs->addr.pc.getOffset();
+	if (offset >= scr->getBufSize() || s->xs->sp < s->xs->fp)
+		return false;
+
+	const Script::DecodedInstruction &instruction = scr->getDecodedInstruction(offset);
+	const byte opcode = instruction.extOpcode >> 1;
+	bool fuse = false;
+	switch (sequence) {
+	case kFuseComparison:
+		fuse = opcode >= op_eq_ && opcode <= op_ule_;
+		break;
+	case kFuseBranch:
+		fuse = opcode == op_bt || opcode == op_bnt;
+		break;
+	case kFuseLofsa:
+		fuse = opcode == op_lofsa;
+		break;
+	case kFuseSend:
+		fuse = opcode == op_send;
+		break;
+	default:
+		break;
+	}
+	if (!fuse)
+		return false;
+
+	// The step of the previous instruction is done
+	++s->scriptStepCounter;
+	++s->scriptFusedStepCounter;
+	g_sci->_debugState.old_pc_offset = offset;
+	g_sci->_debugState.old_sp = s->xs->sp;
+
+	fetchInstruction(s, scr, extOpcode, opparams);
+	return true;
+}
+
+// Continues with the next instruction without going through the head of the
+// loop, if it continues the given sequence
+#define FUSE_NEXT(sequence) \
+	if (fetchFusedInstruction(s, scr, sequence, extOpcode, opparams)) { \
+		opcode = extOpcode >> 1; \
+		goto dispatch; \
+	}
+
 void run_vm(EngineState *s) {
 	assert(s);
 
+	ScriptClock scriptClock(s, true);
+
 	int temp;
 	reg_t r_temp; // Temporary register
 	StackPtr s_temp; // Temporary stack pointer
@@ -622,8 +748,9 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
-		const byte opcode = extOpcode >> 1;
+		fetchInstruction(s, scr, extOpcode, opparams);
+		byte opcode = extOpcode >> 1;
+dispatch:
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
 #ifdef ABORT_ON_INFINITE_LOOP
@@ -704,55 +831,65 @@ void run_vm(EngineState *s) {
 		case op_eq_: // 0x0d (13)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() == s->r_acc);
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_ne_: // 0x0e (14)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() != s->r_acc);
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_gt_: // 0x0f (15)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() > s->r_acc);
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_ge_: // 0x10 (16)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() >= s->r_acc);
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_lt_: // 0x11 (17)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() < s->r_acc);
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_le_: // 0x12 (18)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() <= s->r_acc);
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_ugt_: // 0x13 (19)
 			// > (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().gtU(s->r_acc));
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_uge_: // 0x14 (20)
 			// >= (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().geU(s->r_acc));
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_ult_: // 0x15 (21)
 			// < (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().ltU(s->r_acc));
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_ule_: // 0x16 (22)
 			// <= (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().leU(s->r_acc));
+			FUSE_NEXT(kFuseBranch);
 			break;
 
 		case op_bt: // 0x17 (23)
@@ -786,16 +923,19 @@ void run_vm(EngineState *s) {
 		case op_ldi: // 0x1a (26)
 			// Load data immediate
 			s->r_acc = make_reg(0, opparams[0]);
+			FUSE_NEXT(kFuseComparison);
 			break;
 
 		case op_push: // 0x1b (27)
 			// Push to stack
 			PUSH32(s->r_acc);
+			FUSE_NEXT(kFuseLofsa);
 			break;
 
 		case op_pushi: // 0x1c (28)
 			// Push immediate
 			PUSH(opparams[0]);
+			FUSE_NEXT(kFuseLofsa);
 			break;
 
 		case op_toss: // 0x1d (29)
@@ -1200,23 +1340,28 @@ void run_vm(EngineState *s) {
 				error("VM: lofsa/lofss operation overflowed: %04x:%04x beyond end"
 						  " of script (at %04x)", PRINT_REG(r_temp), scr->getBufSize());
 
-			if (opcode == op_lofsa)
+			if (opcode == op_lofsa) {
 				s->r_acc = r_temp;
-			else
+				FUSE_NEXT(kFuseSend);
+			} else {
 				PUSH32(r_temp);
+			}
 			break;
 		}
 
 		case op_push0: // 0x3b (59)
 			PUSH(0);
+			FUSE_NEXT(kFuseLofsa);
 			break;
 
 		case op_push1: // 0x3c (60)
 			PUSH(1);
+			FUSE_NEXT(kFuseLofsa);
 			break;
 
 		case op_push2: // 0x3d (61)
 			PUSH(2);
+			FUSE_NEXT(kFuseLofsa);
 			break;
 
 		case op_pushSelf: // 0x3e (62)
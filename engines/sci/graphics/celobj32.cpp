@@ -35,6 +35,122 @@
 #include "common/gui_options.h"
 
 namespace Sci {
+#pragma mark CelCache
+
+CelCache::CelCache(const uint capacity) :
+	_mostRecent(-1),
+	_leastRecent(-1),
+	_free(-1),
+	_hits(0),
+	_misses(0) {
+	setCapacity(capacity);
+}
+
+CelCache::~CelCache() {
+	clear();
+}
+
+const CelObj *CelCache::find(const CelInfo32 &celInfo) {
+	IndexMap::const_iterator it = _map.find(celInfo);
+	if (it == _map.end()) {
+		++_misses;
+		return nullptr;
+	}
+
+	++_hits;
+	const int index = it->_value;
+	if (index != _mostRecent) {
+		removeFromList(index);
+		addToFront(index);
+	}
+	return _entries[index].celObj;
+}
+
+void CelCache::insert(CelObj *const celObj) {
+	if (_entries.empty()) {
+		delete celObj;
+		return;
+	}
+
+	int index;
+	IndexMap::const_iterator it = _map.find(celObj->_info);
+	if (it != _map.end()) {
+		index = it->_value;
+		removeFromList(index);
+		delete _entries[index].celObj;
+	} else if (_free != -1) {
+		index = _free;
+		_free = _entries[index].next;
+	} else {
+		index = _leastRecent;
+		removeFromList(index);
+		_map.erase(_entries[index].celObj->_info);
+		delete _entries[index].celObj;
+	}
+
+	_entries[index].celObj = celObj;
+	_map[celObj->_info] = index;
+	addToFront(index);
+}
+
+void CelCache::setCapacity(const uint capacity) {
+	// Keep the most recently used cel objects which still fit
+	Common::Array<CelObj *> kept;
+	for (int i = _mostRecent; i != -1 && kept.size() < capacity; i = _entries[i].next) {
+		kept.push_back(_entries[i].celObj);
+		_entries[i].celObj = nullptr;
+	}
+
+	clear();
+	_entries.resize(capacity);
+	for (uint i = 0; i < capacity; ++i) {
+		_entries[i].celObj = nullptr;
+		_entries[i].prev = -1;
+		_entries[i].next = i + 1 < capacity ? (int)i + 1 : -1;
+	}
+	_free = capacity ? 0 : -1;
+
+	for (uint i = kept.size(); i > 0; --i) {
+		insert(kept[i - 1]);
+	}
+}
+
+void CelCache::removeFromList(const int index) {
+	const Entry &entry = _entries[index];
+	if (entry.prev != -1) {
+		_entries[entry.prev].next = entry.next;
+	} else {
+		_mostRecent = entry.next;
+	}
+	if (entry.next != -1) {
+		_entries[entry.next].prev = entry.prev;
+	} else {
+		_leastRecent = entry.prev;
+	}
+}
+
+void CelCache::addToFront(const int index) {
+	Entry &entry = _entries[index];
+	entry.prev = -1;
+	entry.next = _mostRecent;
+	if (_mostRecent != -1) {
+		_entries[_mostRecent].prev = index;
+	} else {
+		_leastRecent = index;
+	}
+	_mostRecent = index;
+}
+
+void CelCache::clear() {
+	for (uint i = 0; i < _entries.size(); ++i) {
+		delete _entries[i].celObj;
+		_entries[i].celObj = nullptr;
+	}
+	_map.clear();
+	_mostRecent = _leastRecent = _free = -1;
+}
+
+#pragma mark -
 #pragma mark CelScaler
 
 CelScaler *CelObj::_scaler = nullptr;
@@ -88,9 +204,15 @@ bool CelObj::_drawBlackLines = false;
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
 	_scaler = new CelScaler();
-	_cache = new CelCache(100);
+
+	// SSCI cached 100 cel objects, which busy scenes can draw more of in a
+	// single frame
+	int cacheSize = 100;
+	if (ConfMan.hasKey("cel_cache_size")) {
+		cacheSize = MAX(ConfMan.getInt("cel_cache_size"), 0);
+	}
+	_cache = new CelCache(cacheSize);
 }
 
 void CelObj::deinit() {
@@ -698,45 +820,10 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
-
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
-
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
-		}
-	}
-
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
-	}
-
-	return -1;
-}
-
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
-	}
-
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+void CelObj::putCopyInCache() const {
+	_cache->insert(duplicate());
 }
 
 #pragma mark -
@@ -983,16 +1070,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj.get());
+	const CelObj *const cachedEntry = _cache->find(_info);
+	if (cachedEntry != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<const CelObjView *>(cachedEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in the cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1090,7 +1174,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1191,16 +1275,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj.get());
+	const CelObj *const cachedEntry = _cache->find(_info);
+	if (cachedEntry != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<const CelObjPic *>(cachedEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in the cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1264,7 +1345,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
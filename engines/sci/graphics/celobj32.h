@@ -22,6 +22,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -105,7 +106,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -115,7 +116,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -135,18 +136,74 @@ struct CelInfo32 {
 	}
 };
 
+struct CelInfo32Hash {
+	// Hashes the same fields as CelInfo32::operator==
+	inline uint operator()(const CelInfo32 &info) const {
+		return (info.type << 28) ^ (info.resourceId << 12) ^ (info.loopNo << 6) ^ info.celNo ^
+			(info.bitmap.getSegment() << 3) ^ info.bitmap.getOffset();
+	}
+};
+
 class CelObj;
-struct CelCacheEntry {
+
+/**
+ * A cache of cel objects, used to avoid reinitialisation overhead for cels
+ * with the same CelInfo32. When the cache is full, the least recently used
+ * cel object is replaced.
+ *
+ * SSCI searched a fixed array of cel objects linearly; this cache finds cel
+ * objects by hashing their CelInfo32 instead, which matters for frames with
+ * many screen items.
+ */
+class CelCache {
+public:
+	CelCache(const uint capacity);
+	~CelCache();
+
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * Returns the cached cel object matching the given CelInfo32, or nullptr.
+	 * A found cel object becomes the most recently used one.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
-};
+	const CelObj *find(const CelInfo32 &celInfo);
+
+	/**
+	 * Adds a cel object to the cache, which takes ownership of it.
+	 */
+	void insert(CelObj *celObj);
 
-typedef Common::Array<CelCacheEntry> CelCache;
+	/**
+	 * Changes the maximum number of cel objects in the cache, dropping the
+	 * least recently used ones which do not fit anymore.
+	 */
+	void setCapacity(const uint capacity);
+
+	uint getCapacity() const { return _entries.size(); }
+	uint size() const { return _map.size(); }
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	void resetStats() { _hits = _misses = 0; }
+
+private:
+	struct Entry {
+		CelObj *celObj;
+		// The neighbours of the entry in the list of used entries, from the
+		// most to the least recently used one, or in the list of free ones
+		int prev, next;
+	};
+
+	typedef Common::HashMap<CelInfo32, int, CelInfo32Hash> IndexMap;
+
+	Common::Array<Entry> _entries;
+	IndexMap _map;
+	int _mostRecent, _leastRecent;
+	int _free;
+	uint32 _hits, _misses;
+
+	void removeFromList(const int index);
+	void addToFront(const int index);
+	void clear();
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -450,12 +507,6 @@ private:
 #pragma mark -
 #pragma mark CelObj - Caching
 protected:
-	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
-	 */
-	static int _nextCacheId;
-
 	/**
 	 * A cache of cel objects used to avoid reinitialisation overhead for cels
 	 * with the same CelInfo32.
@@ -463,17 +514,12 @@ protected:
 	static CelCache *_cache;
 
 	/**
-	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * Puts a copy of this CelObj into the cache.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	void putCopyInCache() const;
 
-	/**
-	 * Puts a copy of this CelObj into the cache at the given cache index.
-	 */
-	void putCopyInCache(int index) const;
+public:
+	static CelCache *getCache() { return _cache; }
 };
 
 #pragma mark -
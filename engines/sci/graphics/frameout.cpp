@@ -1496,4 +1496,37 @@ void GfxFrameout::printVisiblePlaneItemList(Console *con, const reg_t planeObjec
 	printPlaneItemListInternal(con, p->_screenItemList);
 }
 
+void GfxFrameout::benchmarkFrameOut(Console *con, const int frameCount) {
+	CelCache &cache = *CelObj::getCache();
+	const uint32 hits = cache.getHits();
+	const uint32 misses = cache.getMisses();
+	uint screenItemCount = 0;
+
+	const uint32 startTime = g_system->getMillis();
+	for (int i = 0; i < frameCount; ++i) {
+		for (PlaneList::iterator plane = _planes.begin(); plane != _planes.end(); ++plane) {
+			(*plane)->_redrawAllCount = getScreenCount();
+
+			ScreenItemList &screenItemList = (*plane)->_screenItemList;
+			for (ScreenItemList::iterator it = screenItemList.begin(); it != screenItemList.end(); ++it) {
+				if (*it != nullptr) {
+					// Pic cels are only created together with their plane,
+					// so getCelObj() cannot get them again
+					if ((*it)->_celInfo.type == kCelTypeView)
+						(*it)->_celObj.reset();
+					++screenItemCount;
+				}
+			}
+		}
+
+		frameOut(false);
+	}
+	const uint32 duration = g_system->getMillis() - startTime;
+
+	con->debugPrintf("Rendered %d frames of %u screen items in %u ms (%.2f ms per frame)\n",
+		frameCount, frameCount ? screenItemCount / frameCount : 0, duration,
+		frameCount ? (double)duration / frameCount : 0.0);
+	con->debugPrintf("Cel cache: %u hits, %u misses\n", cache.getHits() - hits, cache.getMisses() - misses);
+}
+
 } // End of namespace Sci
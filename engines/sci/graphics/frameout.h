@@ -442,6 +442,13 @@ public:
 	void printPlaneItemList(Console *con, const reg_t planeObject) const;
 	void printVisiblePlaneItemList(Console *con, const reg_t planeObject) const;
 	void printPlaneItemListInternal(Console *con, const ScreenItemList &screenItemList) const;
+
+	/**
+	 * Renders the current scene the given number of times, getting the cel
+	 * objects of all view screen items again and redrawing all screen items
+	 * for each frame, and prints how long it took.
+	 */
+	void benchmarkFrameOut(Console *con, const int frameCount);
 };
 
 } // End of namespace Sci
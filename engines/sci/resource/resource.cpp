@@ -25,6 +25,7 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -210,6 +211,8 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_compressed = false;
+	_evicted = false;
 }
 
 Resource::~Resource() {
@@ -421,10 +424,12 @@ void ResourceManager::disposeVolumeFileStream(Common::SeekableReadStream *fileSt
 }
 
 void ResourceManager::loadResource(Resource *res) {
+	const uint32 startTime = g_system->getMillis();
 	res->_source->loadResource(this, res);
 	if (_patcher) {
 		_patcher->applyPatch(*res);
 	};
+	_cacheStats.loadTime += g_system->getMillis() - startTime;
 }
 
 
@@ -1005,9 +1010,13 @@ ResourceManager::ResourceManager(const bool detectionMode) :
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
+	_maxMemoryLRULimit = 4096 * 1024; // 4MiB
+	_refaultMemory = 0;
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_prefetchQueue.clear();
+	resetCacheStats();
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1079,6 +1088,18 @@ void ResourceManager::init() {
 	// and making the renderer very slow.
 	if (getSciVersion() >= SCI_VERSION_2) {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
+		_maxMemoryLRULimit = 32 * 1024 * 1024; // 32MiB
+	}
+
+	// The budget can be raised by users with memory to spare, in KiB
+	if (!_detectionMode) {
+		int maxMemory = _maxMemoryLRU;
+		int limit = _maxMemoryLRULimit;
+		if (ConfMan.hasKey("resource_cache_size"))
+			maxMemory = ConfMan.getInt("resource_cache_size") * 1024;
+		if (ConfMan.hasKey("resource_cache_limit"))
+			limit = ConfMan.getInt("resource_cache_limit") * 1024;
+		setMaxMemoryLRU(maxMemory, limit);
 	}
 
 	switch (_viewType) {
@@ -1147,12 +1168,57 @@ void ResourceManager::addToLRU(Resource *res) {
 	res->_status = kResStatusEnqueued;
 }
 
+void ResourceManager::setMaxMemoryLRU(int maxMemory, int limit) {
+	_maxMemoryLRU = MAX(maxMemory, 0);
+	_maxMemoryLRULimit = MAX(limit, _maxMemoryLRU);
+	_refaultMemory = 0;
+	freeOldResources();
+}
+
+void ResourceManager::resetCacheStats() {
+	_cacheStats.hits = 0;
+	_cacheStats.misses = 0;
+	_cacheStats.refaults = 0;
+	_cacheStats.evictions = 0;
+	_cacheStats.prefetches = 0;
+	_cacheStats.loadTime = 0;
+}
+
+Resource *ResourceManager::selectEvictionVictim() const {
+	// Of the least recently used resources, the one which is cheapest to
+	// load again for the memory it frees is evicted. This keeps small and
+	// compressed resources in memory for longer than big uncompressed ones.
+	const int kCandidates = 8;
+	// Rough costs of locating a resource, and of decompressing a byte, in
+	// bytes read
+	const uint64 kLoadOverhead = 4096;
+	const uint64 kDecompressCost = 4;
+
+	Resource *victim = nullptr;
+	uint64 victimCost = 0, victimSize = 0;
+	int candidates = 0;
+	for (Common::List<Resource *>::const_iterator it = _LRU.reverse_begin(); it != _LRU.end() && candidates < kCandidates; --it, ++candidates) {
+		Resource *res = *it;
+		const uint64 size = res->size() + 1;
+		const uint64 cost = kLoadOverhead + size * (res->_compressed ? kDecompressCost + 1 : 1);
+		if (!victim || cost * victimSize < victimCost * size) {
+			victim = res;
+			victimCost = cost;
+			victimSize = size;
+		}
+	}
+
+	return victim;
+}
+
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		Resource *goner = selectEvictionVictim();
 		removeFromLRU(goner);
 		goner->unalloc();
+		goner->_evicted = true;
+		_cacheStats.evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
@@ -1195,15 +1261,32 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats.misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+
+		if (retval->_evicted) {
+			// The game reloads resources soon after they were freed if
+			// the budget is too small for its working set, so grow it
+			_cacheStats.refaults++;
+			_refaultMemory += retval->size();
+			if (_refaultMemory > _maxMemoryLRU / 2 && _maxMemoryLRU < _maxMemoryLRULimit) {
+				_maxMemoryLRU = MIN(_maxMemoryLRU + _maxMemoryLRU / 2, _maxMemoryLRULimit);
+				_refaultMemory = 0;
+				debugC(1, kDebugLevelResMan, "resMan: Raised the LRU budget to %d bytes", _maxMemoryLRU);
+			}
+			retval->_evicted = false;
+		}
+	} else {
+		_cacheStats.hits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
@@ -1230,6 +1313,50 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	}
 }
 
+void ResourceManager::prefetchResource(const ResourceId &id) {
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc)
+		return;
+
+	if (Common::find(_prefetchQueue.begin(), _prefetchQueue.end(), id) == _prefetchQueue.end())
+		_prefetchQueue.push_back(id);
+}
+
+bool ResourceManager::loadNextPrefetch(uint32 maxSize) {
+	while (!_prefetchQueue.empty()) {
+		Resource *res = testResource(_prefetchQueue.front());
+		_prefetchQueue.pop_front();
+
+		// The game may have loaded it already
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		// Big resources are left for the game to load, as they may take
+		// longer than the time left to sleep
+		if (res->size() > maxSize)
+			continue;
+
+		// Prefetching never evicts anything, as callers of SciEngine::sleep()
+		// may still use unlocked resources
+		if (_memoryLRU + (int)res->size() > _maxMemoryLRU)
+			continue;
+
+		loadResource(res);
+		if (res->_status == kResStatusAllocated) {
+			if (_memoryLRU + (int)res->size() > _maxMemoryLRU) {
+				res->unalloc();
+			} else {
+				res->_evicted = false;
+				_cacheStats.prefetches++;
+				addToLRU(res);
+			}
+		}
+		return true;
+	}
+
+	return false;
+}
+
 void ResourceManager::unlockResource(Resource *res) {
 	assert(res);
 
@@ -2403,6 +2530,7 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 	byte *ptr = new byte[_size];
 	_data = ptr;
 	_status = kResStatusAllocated;
+	_compressed = (compression != kCompNone);
 	errorNum = ptr ? dec->unpack(file, ptr, szPacked, _size) : SCI_ERROR_RESOURCE_TOO_BIG;
 	if (errorNum) {
 		unalloc();
@@ -311,6 +311,8 @@ protected:
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
+	bool _compressed; /**< Whether loading the resource has to decompress it */
+	bool _evicted; /**< Whether the resource was freed by the LRU before */
 
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
@@ -394,6 +396,50 @@ public:
 	 */
 	Resource *testResource(const ResourceId &id) const;
 
+	/**
+	 * Queues a resource to be loaded ahead of its use, while the engine
+	 * would otherwise be sleeping. Game scripts announce the resources of a
+	 * room with kLoad before they use them.
+	 * @param id	Id of the resource to load
+	 */
+	void prefetchResource(const ResourceId &id);
+
+	/**
+	 * Loads the next resource queued by prefetchResource(), on the calling
+	 * thread. Queued resources bigger than maxSize are dropped instead, so
+	 * that a single call does not take much longer than loading maxSize
+	 * bytes.
+	 * @param maxSize	Size of the biggest resource to load
+	 * @return false if there was nothing left to load
+	 */
+	bool loadNextPrefetch(uint32 maxSize);
+
+	/** Statistics of the resource cache, for the debugger. */
+	struct CacheStats {
+		uint32 hits;       ///< Requests for resources which were in memory
+		uint32 misses;     ///< Requests which had to load their resource
+		uint32 refaults;   ///< Misses for resources the LRU had freed before
+		uint32 evictions;  ///< Resources freed by the LRU
+		uint32 prefetches; ///< Resources loaded by loadNextPrefetch()
+		uint32 loadTime;   ///< Milliseconds spent reading and decompressing resources
+	};
+
+	const CacheStats &getCacheStats() const { return _cacheStats; }
+	void resetCacheStats();
+
+	/** Returns the number of bytes of unlocked resources kept in memory. */
+	int getMemoryLRU() const { return _memoryLRU; }
+	/** Returns the number of bytes of locked resources. */
+	int getMemoryLocked() const { return _memoryLocked; }
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMaxMemoryLRULimit() const { return _maxMemoryLRULimit; }
+
+	/**
+	 * Sets the budget for unlocked resources, and the limit up to which it
+	 * may grow when the game keeps reloading resources it freed.
+	 */
+	void setMaxMemoryLRU(int maxMemory, int limit);
+
 	/**
 	 * Returns a list of all resources of the specified type.
 	 * @param type		The resource type to look for
@@ -496,6 +542,14 @@ protected:
 	// issued whenever this limit is exceeded.
 	int _maxMemoryLRU;
 
+	// Upper bound for _maxMemoryLRU, which grows when the game reloads
+	// resources soon after they were freed, because of a too small budget.
+	int _maxMemoryLRULimit;
+	int _refaultMemory; ///< Bytes reloaded after eviction since _maxMemoryLRU last grew
+
+	CacheStats _cacheStats;
+	Common::List<ResourceId> _prefetchQueue; ///< Resources to load ahead of time
+
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	typedef Common::List<ResourceSource *> SourcesList;
 	SourcesList _sources;
@@ -563,6 +617,7 @@ protected:
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
 	void loadResource(Resource *res);
 	void freeOldResources();
+	Resource *selectEvictionVictim() const;
 	bool validateResource(const ResourceId &resourceId, const Common::Path &sourceMapLocation, const Common::Path &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
 	Resource *addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
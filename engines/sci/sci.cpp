@@ -337,6 +337,13 @@ Common::Error SciEngine::run() {
 	_vocabulary = hasParser() ? new Vocabulary(_resMan, false) : nullptr;
 
 	_gamestate = new EngineState(segMan);
+	// Benchmark the VM by running the game scripts for the given number of
+	// operations, then quitting. Input can come from a recording played back
+	// with --record-mode=playback.
+	const int benchmarkSteps = ConfMan.hasKey("sci_benchmark_steps") ? ConfMan.getInt("sci_benchmark_steps") : 0;
+	_gamestate->scriptStepLimit = MAX(benchmarkSteps, 0);
+	// Only measure the speed of the VM if it is reported at the end
+	_gamestate->scriptClockEnabled = benchmarkSteps > 0 || DebugMan.isDebugChannelEnabled(kDebugLevelVM);
 	_guestAdditions = new GuestAdditions(_gamestate, _features, _kernel);
 	_eventMan = new EventManager(_resMan->detectFontExtended());
 #ifdef ENABLE_SCI32
@@ -455,7 +462,20 @@ Common::Error SciEngine::run() {
 		suggestDownloadGK2SubTitlesPatch();
 	}
 
+	const uint32 startTime = _system->getMillis();
 	runGame();
+	const uint32 elapsed = _system->getMillis() - startTime;
+
+	if (benchmarkSteps > 0) {
+		const uint32 runTime = MAX<uint32>(_gamestate->scriptRunTime, 1);
+		debug("SCI benchmark: %d operations, %d of them in superinstructions, in %u ms of script time and %u ms in total, %u operations per second",
+			_gamestate->scriptStepCounter, _gamestate->scriptFusedStepCounter, _gamestate->scriptRunTime, elapsed,
+			(uint32)((uint64)_gamestate->scriptStepCounter * 1000 / runTime));
+	} else if (_gamestate->scriptRunTime) {
+		debugC(1, kDebugLevelVM, "Executed %d SCI operations in %u ms, %u operations per second",
+			_gamestate->scriptStepCounter, _gamestate->scriptRunTime,
+			(uint32)((uint64)_gamestate->scriptStepCounter * 1000 / _gamestate->scriptRunTime));
+	}
 
 	ConfMan.flushToDisk();
 
@@ -970,6 +990,11 @@ void SciEngine::showQfgImportMessageBox() const {
 			"for Quest for Glory 2. Example: 'qfg2-thief.sav'."));
 }
 
+/** Milliseconds which must be left to sleep to load a prefetched resource. */
+static const uint32 kPrefetchMinSleepTime = 20;
+/** Size of the biggest resource loaded while sleeping. */
+static const uint32 kPrefetchMaxSize = 64 * 1024;
+
 void SciEngine::sleep(uint32 msecs) {
 	if (!msecs) {
 		return;
@@ -996,6 +1021,10 @@ void SciEngine::sleep(uint32 msecs) {
 #endif
 		uint32 time = _system->getMillis();
 		if (time + 10 < wakeUpTime) {
+			// Use the time to load the resources the game asked for ahead,
+			// one small resource at a time while enough of it is left
+			if (time + kPrefetchMinSleepTime < wakeUpTime && _resMan->loadNextPrefetch(kPrefetchMaxSize))
+				continue;
 			_system->delayMillis(10);
 		} else {
 			if (time < wakeUpTime)
@@ -30,6 +30,7 @@ struct Point;
 }
 
 class BlendBlitUnfilteredTestSuite;
+class TransBlitTestSuite;
 
 namespace Graphics {
 
@@ -372,6 +373,87 @@ public:
 
 }; // End of class BlendBlit
 
+/**
+ * Row functions for the color keyed and masked blits, using SIMD
+ * instructions where the CPU has them.
+ */
+class TransBlit {
+public:
+	/** The parameters for keyRow32(). */
+	struct Key32 {
+		uint32 keyMask;   /*!< Bits compared with the key. */
+		uint32 key;       /*!< Source pixels matching the key are skipped. */
+		uint32 alphaMask; /*!< Alpha bits, or 0 to treat all pixels as opaque. */
+		uint32 outMask;   /*!< Bits of the opaque source pixels which are copied. */
+	};
+
+	/** Copy the pixels of a row which do not match the key. */
+	static void keyRow8(byte *dst, const byte *src, uint width, byte key) {
+		getFuncs().keyRow8(dst, src, width, key);
+	}
+
+	/**
+	 * Copy the opaque pixels of a row which do not match the key, and skip
+	 * the transparent ones.
+	 *
+	 * @return Whether the row has partially transparent pixels, which
+	 *         are left for the caller to blend.
+	 */
+	static bool keyRow32(uint32 *dst, const uint32 *src, uint width, const Key32 &key) {
+		return getFuncs().keyRow32(dst, src, width, key);
+	}
+
+	/** Copy the pixels of a row whose mask is not zero. */
+	static void maskRow8(byte *dst, const byte *src, const byte *mask, uint width) {
+		getFuncs().maskRow8(dst, src, mask, width);
+	}
+
+	/** Copy the pixels of a row whose mask is not zero. */
+	static void maskRow32(uint32 *dst, const uint32 *src, const byte *mask, uint width) {
+		getFuncs().maskRow32(dst, src, mask, width);
+	}
+
+private:
+	struct Funcs {
+		void (*keyRow8)(byte *dst, const byte *src, uint width, byte key);
+		bool (*keyRow32)(uint32 *dst, const uint32 *src, uint width, const Key32 &key);
+		void (*maskRow8)(byte *dst, const byte *src, const byte *mask, uint width);
+		void (*maskRow32)(uint32 *dst, const uint32 *src, const byte *mask, uint width);
+	};
+
+	static const Funcs &getFuncs() {
+		if (!_funcs)
+			selectFuncs();
+		return *_funcs;
+	}
+
+	static void selectFuncs();
+
+	static void keyRow8Generic(byte *dst, const byte *src, uint width, byte key);
+	static bool keyRow32Generic(uint32 *dst, const uint32 *src, uint width, const Key32 &key);
+	static void maskRow8Generic(byte *dst, const byte *src, const byte *mask, uint width);
+	static void maskRow32Generic(uint32 *dst, const uint32 *src, const byte *mask, uint width);
+
+	static const Funcs _funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs _funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs _funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Funcs _funcsAVX2;
+#endif
+
+	/** The row functions in use, selected on first use. */
+	static const Funcs *_funcs;
+
+	friend class TransBlitImpl_NEON;
+	friend class TransBlitImpl_SSE2;
+	friend class TransBlitImpl_AVX2;
+	friend class ::TransBlitTestSuite;
+}; // End of class TransBlit
+
 /** @} */
 } // End of namespace Graphics
 
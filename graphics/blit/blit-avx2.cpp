@@ -321,6 +321,73 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+class TransBlitImpl_AVX2 {
+public:
+	static void keyRow8(byte *dst, const byte *src, uint width, byte key) {
+		const __m256i keyVec = _mm256_set1_epi8((char)key);
+		uint x = 0;
+		for (; x + 32 <= width; x += 32) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+			__m256i d = _mm256_loadu_si256((const __m256i *)(dst + x));
+			_mm256_storeu_si256((__m256i *)(dst + x), _mm256_blendv_epi8(s, d, _mm256_cmpeq_epi8(s, keyVec)));
+		}
+		TransBlit::keyRow8Generic(dst + x, src + x, width - x, key);
+	}
+
+	static bool keyRow32(uint32 *dst, const uint32 *src, uint width, const TransBlit::Key32 &key) {
+		const __m256i keyMask = _mm256_set1_epi32(key.keyMask);
+		const __m256i keyVec = _mm256_set1_epi32(key.key);
+		const __m256i alphaMask = _mm256_set1_epi32(key.alphaMask);
+		const __m256i outMask = _mm256_set1_epi32(key.outMask);
+		const __m256i hasAlpha = _mm256_set1_epi32(key.alphaMask ? -1 : 0);
+		const __m256i zero = _mm256_setzero_si256();
+
+		__m256i partial = zero;
+		uint x = 0;
+		for (; x + 8 <= width; x += 8) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+			__m256i d = _mm256_loadu_si256((const __m256i *)(dst + x));
+			__m256i alpha = _mm256_and_si256(s, alphaMask);
+			__m256i opaque = _mm256_cmpeq_epi32(alpha, alphaMask);
+			__m256i skip = _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_and_si256(s, keyMask), keyVec),
+			                               _mm256_and_si256(_mm256_cmpeq_epi32(alpha, zero), hasAlpha));
+			__m256i copy = _mm256_andnot_si256(skip, opaque);
+			partial = _mm256_or_si256(partial, _mm256_andnot_si256(_mm256_or_si256(skip, opaque), _mm256_set1_epi32(-1)));
+			_mm256_storeu_si256((__m256i *)(dst + x), _mm256_blendv_epi8(d, _mm256_and_si256(s, outMask), copy));
+		}
+		bool tailPartial = TransBlit::keyRow32Generic(dst + x, src + x, width - x, key);
+		return !_mm256_testz_si256(partial, partial) || tailPartial;
+	}
+
+	static void maskRow8(byte *dst, const byte *src, const byte *mask, uint width) {
+		const __m256i zero = _mm256_setzero_si256();
+		uint x = 0;
+		for (; x + 32 <= width; x += 32) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+			__m256i d = _mm256_loadu_si256((const __m256i *)(dst + x));
+			__m256i skip = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(mask + x)), zero);
+			_mm256_storeu_si256((__m256i *)(dst + x), _mm256_blendv_epi8(s, d, skip));
+		}
+		TransBlit::maskRow8Generic(dst + x, src + x, mask + x, width - x);
+	}
+
+	static void maskRow32(uint32 *dst, const uint32 *src, const byte *mask, uint width) {
+		const __m256i zero = _mm256_setzero_si256();
+		uint x = 0;
+		for (; x + 8 <= width; x += 8) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)(src + x));
+			__m256i d = _mm256_loadu_si256((const __m256i *)(dst + x));
+			__m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(mask + x)));
+			_mm256_storeu_si256((__m256i *)(dst + x), _mm256_blendv_epi8(s, d, _mm256_cmpeq_epi32(m, zero)));
+		}
+		TransBlit::maskRow32Generic(dst + x, src + x, mask + x, width - x);
+	}
+}; // End of class TransBlitImpl_AVX2
+
+const TransBlit::Funcs TransBlit::_funcsAVX2 = {
+	TransBlitImpl_AVX2::keyRow8, TransBlitImpl_AVX2::keyRow32, TransBlitImpl_AVX2::maskRow8, TransBlitImpl_AVX2::maskRow32
+};
+
 } // End of namespace Graphics
 
 #if defined(__clang__)
@@ -23,6 +23,8 @@
 
 #ifdef SCUMMVM_NEON
 
+#include "common/endian.h"
+
 #include "graphics/blit/blit-alpha.h"
 #include "graphics/pixelformat.h"
 
@@ -324,6 +326,72 @@ void BlendBlit::blitNEON(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_NEON>(args, blendMode, alphaType);
 }
 
+class TransBlitImpl_NEON {
+public:
+	static void keyRow8(byte *dst, const byte *src, uint width, byte key) {
+		const uint8x16_t keyVec = vdupq_n_u8(key);
+		uint x = 0;
+		for (; x + 16 <= width; x += 16) {
+			uint8x16_t s = vld1q_u8(src + x);
+			uint8x16_t d = vld1q_u8(dst + x);
+			vst1q_u8(dst + x, vbslq_u8(vceqq_u8(s, keyVec), d, s));
+		}
+		TransBlit::keyRow8Generic(dst + x, src + x, width - x, key);
+	}
+
+	static bool keyRow32(uint32 *dst, const uint32 *src, uint width, const TransBlit::Key32 &key) {
+		const uint32x4_t keyMask = vdupq_n_u32(key.keyMask);
+		const uint32x4_t keyVec = vdupq_n_u32(key.key);
+		const uint32x4_t alphaMask = vdupq_n_u32(key.alphaMask);
+		const uint32x4_t outMask = vdupq_n_u32(key.outMask);
+		const uint32x4_t hasAlpha = vdupq_n_u32(key.alphaMask ? 0xFFFFFFFF : 0);
+		const uint32x4_t zero = vdupq_n_u32(0);
+
+		uint32x4_t partial = zero;
+		uint x = 0;
+		for (; x + 4 <= width; x += 4) {
+			uint32x4_t s = vld1q_u32(src + x);
+			uint32x4_t d = vld1q_u32(dst + x);
+			uint32x4_t alpha = vandq_u32(s, alphaMask);
+			uint32x4_t opaque = vceqq_u32(alpha, alphaMask);
+			uint32x4_t skip = vorrq_u32(vceqq_u32(vandq_u32(s, keyMask), keyVec),
+			                            vandq_u32(vceqq_u32(alpha, zero), hasAlpha));
+			uint32x4_t copy = vbicq_u32(opaque, skip);
+			partial = vorrq_u32(partial, vmvnq_u32(vorrq_u32(skip, opaque)));
+			vst1q_u32(dst + x, vbslq_u32(copy, vandq_u32(s, outMask), d));
+		}
+		bool tailPartial = TransBlit::keyRow32Generic(dst + x, src + x, width - x, key);
+		uint32x2_t anyPartial = vorr_u32(vget_low_u32(partial), vget_high_u32(partial));
+		return (vget_lane_u32(anyPartial, 0) | vget_lane_u32(anyPartial, 1)) != 0 || tailPartial;
+	}
+
+	static void maskRow8(byte *dst, const byte *src, const byte *mask, uint width) {
+		uint x = 0;
+		for (; x + 16 <= width; x += 16) {
+			uint8x16_t s = vld1q_u8(src + x);
+			uint8x16_t d = vld1q_u8(dst + x);
+			vst1q_u8(dst + x, vbslq_u8(vceqq_u8(vld1q_u8(mask + x), vdupq_n_u8(0)), d, s));
+		}
+		TransBlit::maskRow8Generic(dst + x, src + x, mask + x, width - x);
+	}
+
+	static void maskRow32(uint32 *dst, const uint32 *src, const byte *mask, uint width) {
+		uint x = 0;
+		for (; x + 4 <= width; x += 4) {
+			uint32x4_t s = vld1q_u32(src + x);
+			uint32x4_t d = vld1q_u32(dst + x);
+			// Widen the mask bytes to one per pixel
+			uint32x4_t m = vmovl_u16(vget_low_u16(vmovl_u8(vcreate_u8(READ_LE_UINT32(mask + x)))));
+			vst1q_u32(dst + x, vbslq_u32(vceqq_u32(m, vdupq_n_u32(0)), d, s));
+		}
+		TransBlit::maskRow32Generic(dst + x, src + x, mask + x, width - x);
+	}
+}; // End of class TransBlitImpl_NEON
+
+const TransBlit::Funcs TransBlit::_funcsNEON = {
+	TransBlitImpl_NEON::keyRow8, TransBlitImpl_NEON::keyRow32, TransBlitImpl_NEON::maskRow8, TransBlitImpl_NEON::maskRow32
+};
+
 } // end of namespace Graphics
 
 #if !defined(__aarch64__) && !defined(__ARM_NEON)
@@ -20,6 +20,7 @@
  */
 
 #include "common/scummsys.h"
+#include "common/endian.h"
 
 #include "graphics/blit/blit-alpha.h"
 #include "graphics/pixelformat.h"
@@ -326,6 +327,77 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+class TransBlitImpl_SSE2 {
+public:
+	static void keyRow8(byte *dst, const byte *src, uint width, byte key) {
+		const __m128i keyVec = _mm_set1_epi8((char)key);
+		uint x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			__m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+			__m128i skip = _mm_cmpeq_epi8(s, keyVec);
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, s)));
+		}
+		TransBlit::keyRow8Generic(dst + x, src + x, width - x, key);
+	}
+
+	static bool keyRow32(uint32 *dst, const uint32 *src, uint width, const TransBlit::Key32 &key) {
+		const __m128i keyMask = _mm_set1_epi32(key.keyMask);
+		const __m128i keyVec = _mm_set1_epi32(key.key);
+		const __m128i alphaMask = _mm_set1_epi32(key.alphaMask);
+		const __m128i outMask = _mm_set1_epi32(key.outMask);
+		const __m128i hasAlpha = _mm_set1_epi32(key.alphaMask ? -1 : 0);
+		const __m128i zero = _mm_setzero_si128();
+
+		__m128i partial = zero;
+		uint x = 0;
+		for (; x + 4 <= width; x += 4) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			__m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+			__m128i alpha = _mm_and_si128(s, alphaMask);
+			__m128i opaque = _mm_cmpeq_epi32(alpha, alphaMask);
+			__m128i skip = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(s, keyMask), keyVec),
+			                            _mm_and_si128(_mm_cmpeq_epi32(alpha, zero), hasAlpha));
+			__m128i copy = _mm_andnot_si128(skip, opaque);
+			partial = _mm_or_si128(partial, _mm_andnot_si128(_mm_or_si128(skip, opaque), _mm_set1_epi32(-1)));
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_and_si128(copy, _mm_and_si128(s, outMask)), _mm_andnot_si128(copy, d)));
+		}
+		bool tailPartial = TransBlit::keyRow32Generic(dst + x, src + x, width - x, key);
+		return _mm_movemask_epi8(partial) != 0 || tailPartial;
+	}
+
+	static void maskRow8(byte *dst, const byte *src, const byte *mask, uint width) {
+		const __m128i zero = _mm_setzero_si128();
+		uint x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			__m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+			__m128i skip = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(mask + x)), zero);
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, s)));
+		}
+		TransBlit::maskRow8Generic(dst + x, src + x, mask + x, width - x);
+	}
+
+	static void maskRow32(uint32 *dst, const uint32 *src, const byte *mask, uint width) {
+		const __m128i zero = _mm_setzero_si128();
+		uint x = 0;
+		for (; x + 4 <= width; x += 4) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			__m128i d = _mm_loadu_si128((const __m128i *)(dst + x));
+			// Spread each mask byte over a pixel
+			__m128i m = _mm_cvtsi32_si128((int)READ_LE_UINT32(mask + x));
+			m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, m), _mm_unpacklo_epi8(m, m));
+			__m128i skip = _mm_cmpeq_epi32(m, zero);
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, s)));
+		}
+		TransBlit::maskRow32Generic(dst + x, src + x, mask + x, width - x);
+	}
+}; // End of class TransBlitImpl_SSE2
+
+const TransBlit::Funcs TransBlit::_funcsSSE2 = {
+	TransBlitImpl_SSE2::keyRow8, TransBlitImpl_SSE2::keyRow32, TransBlitImpl_SSE2::maskRow8, TransBlitImpl_SSE2::maskRow32
+};
+
 } // End of namespace Graphics
 
 #if !defined(__x86_64__)
@@ -22,6 +22,7 @@
 #include "graphics/blit.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -93,13 +94,22 @@ bool keyBlit(byte *dst, const byte *src,
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
 
 	if (bytesPerPixel == 1) {
-		keyBlitLogic<uint8, 1>(dst, src, w, h, srcDelta, dstDelta, key);
+		for (uint y = 0; y < h; ++y) {
+			TransBlit::keyRow8(dst, src, w, key);
+			src += srcPitch;
+			dst += dstPitch;
+		}
 	} else if (bytesPerPixel == 2) {
 		keyBlitLogic<uint16, 2>(dst, src, w, h, srcDelta, dstDelta, key);
 	} else if (bytesPerPixel == 3) {
 		keyBlitLogic<uint8, 3>(dst, src, w, h, srcDelta, dstDelta, key);
 	} else if (bytesPerPixel == 4) {
-		keyBlitLogic<uint32, 4>(dst, src, w, h, srcDelta, dstDelta, key);
+		const TransBlit::Key32 key32 = { 0xFFFFFFFF, key, 0, 0xFFFFFFFF };
+		for (uint y = 0; y < h; ++y) {
+			TransBlit::keyRow32((uint32 *)dst, (const uint32 *)src, w, key32);
+			src += srcPitch;
+			dst += dstPitch;
+		}
 	} else {
 		return false;
 	}
@@ -149,13 +159,23 @@ bool maskBlit(byte *dst, const byte *src, const byte *mask,
 	const uint maskDelta = (maskPitch - w);
 
 	if (bytesPerPixel == 1) {
-		maskBlitLogic<uint8, 1>(dst, src, mask, w, h, srcDelta, dstDelta, maskDelta);
+		for (uint y = 0; y < h; ++y) {
+			TransBlit::maskRow8(dst, src, mask, w);
+			src  += srcPitch;
+			dst  += dstPitch;
+			mask += maskPitch;
+		}
 	} else if (bytesPerPixel == 2) {
 		maskBlitLogic<uint16, 2>(dst, src, mask, w, h, srcDelta, dstDelta, maskDelta);
 	} else if (bytesPerPixel == 3) {
 		maskBlitLogic<uint8, 3>(dst, src, mask, w, h, srcDelta, dstDelta, maskDelta);
 	} else if (bytesPerPixel == 4) {
-		maskBlitLogic<uint32, 4>(dst, src, mask, w, h, srcDelta, dstDelta, maskDelta);
+		for (uint y = 0; y < h; ++y) {
+			TransBlit::maskRow32((uint32 *)dst, (const uint32 *)src, mask, w);
+			src  += srcPitch;
+			dst  += dstPitch;
+			mask += maskPitch;
+		}
 	} else {
 		return false;
 	}
@@ -163,6 +183,65 @@ bool maskBlit(byte *dst, const byte *src, const byte *mask,
 	return true;
 }
 
+void TransBlit::keyRow8Generic(byte *dst, const byte *src, uint width, byte key) {
+	for (uint x = 0; x < width; ++x) {
+		if (src[x] != key)
+			dst[x] = src[x];
+	}
+}
+
+bool TransBlit::keyRow32Generic(uint32 *dst, const uint32 *src, uint width, const Key32 &key) {
+	bool partial = false;
+	for (uint x = 0; x < width; ++x) {
+		const uint32 color = src[x];
+		if ((color & key.keyMask) == key.key)
+			continue;
+
+		const uint32 alpha = color & key.alphaMask;
+		if (alpha == key.alphaMask)
+			dst[x] = color & key.outMask;
+		else if (alpha != 0)
+			partial = true;
+	}
+	return partial;
+}
+
+void TransBlit::maskRow8Generic(byte *dst, const byte *src, const byte *mask, uint width) {
+	for (uint x = 0; x < width; ++x) {
+		if (mask[x])
+			dst[x] = src[x];
+	}
+}
+
+void TransBlit::maskRow32Generic(uint32 *dst, const uint32 *src, const byte *mask, uint width) {
+	for (uint x = 0; x < width; ++x) {
+		if (mask[x])
+			dst[x] = src[x];
+	}
+}
+
+const TransBlit::Funcs TransBlit::_funcsGeneric = {
+	keyRow8Generic, keyRow32Generic, maskRow8Generic, maskRow32Generic
+};
+
+const TransBlit::Funcs *TransBlit::_funcs = nullptr;
+
+void TransBlit::selectFuncs() {
+	_funcs = &_funcsGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		_funcs = &_funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_funcs = &_funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		_funcs = &_funcsAVX2;
+#endif
+}
+
 namespace {
 
 template<typename SrcColor, int SrcSize, typename DstColor, int DstSize, bool backward, bool hasKey, bool hasMask>
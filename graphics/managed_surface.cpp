@@ -905,6 +905,134 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	delete[] lookup;
 }
 
+template<typename TDEST>
+static void transBlitMapped(const Surface &src, ManagedSurface &dest,
+		const Common::Rect &clipRect, int srcX, int srcY, byte transColor, const Palette *srcPalette) {
+	// Convert the palette once instead of every pixel
+	TDEST map[256];
+	byte r, g, b;
+	for (uint i = 0; i < 256; i++) {
+		if (i < srcPalette->size()) {
+			srcPalette->get(i, r, g, b);
+			map[i] = dest.format.ARGBToColor(0xff, r, g, b);
+		} else {
+			map[i] = 0;
+		}
+	}
+
+	for (int y = clipRect.top; y < clipRect.bottom; ++y) {
+		const byte *srcLine = (const byte *)src.getBasePtr(srcX, srcY + y - clipRect.top);
+		TDEST *destLine = (TDEST *)dest.getBasePtr(clipRect.left, y);
+		for (int x = 0; x < clipRect.width(); ++x) {
+			if (srcLine[x] != transColor)
+				destLine[x] = map[srcLine[x]];
+		}
+	}
+}
+
+/**
+ * Handle the unscaled and unflipped transparent blits of the most common
+ * pixel formats with the row functions of TransBlit, which give the same
+ * results as transBlit().
+ *
+ * @return False if the blit has to be done by transBlit().
+ */
+static bool transBlitRows(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		uint32 transColor, bool flipped, uint32 srcAlpha, const Palette *srcPalette, const Palette *dstPalette) {
+	if (flipped || srcRect.width() != destRect.width() || srcRect.height() != destRect.height())
+		return false;
+
+	const PixelFormat &srcFormat = src.format;
+	const PixelFormat &destFormat = dest.format;
+
+	Common::Rect clipRect = destRect;
+	clipRect.clip(Common::Rect(dest.w, dest.h));
+	const int srcX = srcRect.left + clipRect.left - destRect.left;
+	const int srcY = srcRect.top + clipRect.top - destRect.top;
+
+	if (srcFormat.bytesPerPixel == 1 && destFormat.bytesPerPixel == 1) {
+		if (srcAlpha == 0)
+			return false;
+
+		byte *lookup = nullptr;
+		if (srcPalette && dstPalette)
+			lookup = createPaletteLookup(srcPalette, dstPalette);
+
+		for (int y = clipRect.top; y < clipRect.bottom; ++y) {
+			const byte *srcLine = (const byte *)src.getBasePtr(srcX, srcY + y - clipRect.top);
+			byte *destLine = (byte *)dest.getBasePtr(clipRect.left, y);
+			if (lookup) {
+				for (int x = 0; x < clipRect.width(); ++x) {
+					if (srcLine[x] != (byte)transColor)
+						destLine[x] = lookup[srcLine[x]];
+				}
+			} else {
+				TransBlit::keyRow8(destLine, srcLine, clipRect.width(), transColor);
+			}
+		}
+
+		delete[] lookup;
+		return true;
+	}
+
+	if (srcAlpha != 0xff)
+		return false;
+
+	if (srcFormat.isCLUT8()) {
+		if (!srcPalette || srcPalette->size() == 0)
+			return false;
+
+		if (destFormat.bytesPerPixel == 2)
+			transBlitMapped<uint16>(src, dest, clipRect, srcX, srcY, transColor, srcPalette);
+		else if (destFormat.bytesPerPixel == 4)
+			transBlitMapped<uint32>(src, dest, clipRect, srcX, srcY, transColor, srcPalette);
+		else
+			return false;
+		return true;
+	}
+
+	if (srcFormat != destFormat || srcFormat.bytesPerPixel != 4 ||
+			srcFormat.rLoss != 0 || srcFormat.gLoss != 0 || srcFormat.bLoss != 0 ||
+			(srcFormat.aBits() != 0 && srcFormat.aBits() != 8))
+		return false;
+
+	// Fully transparent pixels would clear the transparent color of the destination
+	if (srcFormat.aBits() != 0 && dest.hasTransparentColor())
+		return false;
+
+	const uint32 rgbMask = srcFormat.ARGBToColor(0, 0xff, 0xff, 0xff);
+	TransBlit::Key32 key;
+	if (srcFormat.aBits() != 0) {
+		// Like transBlit(), ignore the alpha of the source when comparing with the key
+		const bool keyRGB = transColor != (uint32)-1 && transColor > 0;
+		key.keyMask = keyRGB ? rgbMask : 0xFFFFFFFF;
+		key.key = transColor & key.keyMask;
+		key.alphaMask = srcFormat.ARGBToColor(0xff, 0, 0, 0);
+		key.outMask = 0xFFFFFFFF;
+	} else {
+		key.keyMask = 0xFFFFFFFF;
+		key.key = transColor;
+		key.alphaMask = 0;
+		key.outMask = rgbMask;
+	}
+
+	for (int y = clipRect.top; y < clipRect.bottom; ++y) {
+		const uint32 *srcLine = (const uint32 *)src.getBasePtr(srcX, srcY + y - clipRect.top);
+		uint32 *destLine = (uint32 *)dest.getBasePtr(clipRect.left, y);
+		if (!TransBlit::keyRow32(destLine, srcLine, clipRect.width(), key))
+			continue;
+
+		// Blend the partially transparent pixels the row functions left over
+		for (int x = 0; x < clipRect.width(); ++x) {
+			const uint32 alpha = srcLine[x] & key.alphaMask;
+			if ((srcLine[x] & key.keyMask) != key.key && alpha != 0 && alpha != key.alphaMask)
+				transBlitPixel<uint32, uint32>(srcLine[x], destLine[x], srcFormat, destFormat, srcAlpha, srcPalette, nullptr);
+		}
+	}
+
+	return true;
+}
+
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
 	if (src.format.bytesPerPixel == SRC_BYTES && format.bytesPerPixel == DEST_BYTES) \
 		transBlit<SRC_TYPE, DEST_TYPE>(src, srcRect, *this, destRect, transColor, flipped, srcAlpha, srcPalette, dstPalette); \
@@ -916,16 +1044,18 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 	if (src.w == 0 || src.h == 0 || destRect.width() == 0 || destRect.height() == 0)
 		return;
 
-	HANDLE_BLIT(1, 1, uint8,  uint8)
-	HANDLE_BLIT(1, 2, uint8,  uint16)
-	HANDLE_BLIT(1, 4, uint8,  uint32)
-	HANDLE_BLIT(2, 1, uint16, uint8)
-	HANDLE_BLIT(2, 2, uint16, uint16)
-	HANDLE_BLIT(2, 4, uint16, uint32)
-	HANDLE_BLIT(4, 1, uint32, uint8)
-	HANDLE_BLIT(4, 2, uint32, uint16)
-	HANDLE_BLIT(4, 4, uint32, uint32)
-	error("Surface::transBlitFrom: bytesPerPixel must be 1, 2, or 4");
+	if (!transBlitRows(src, srcRect, *this, destRect, transColor, flipped, srcAlpha, srcPalette, dstPalette)) {
+		HANDLE_BLIT(1, 1, uint8,  uint8)
+		HANDLE_BLIT(1, 2, uint8,  uint16)
+		HANDLE_BLIT(1, 4, uint8,  uint32)
+		HANDLE_BLIT(2, 1, uint16, uint8)
+		HANDLE_BLIT(2, 2, uint16, uint16)
+		HANDLE_BLIT(2, 4, uint16, uint32)
+		HANDLE_BLIT(4, 1, uint32, uint8)
+		HANDLE_BLIT(4, 2, uint32, uint16)
+		HANDLE_BLIT(4, 4, uint32, uint32)
+		error("Surface::transBlitFrom: bytesPerPixel must be 1, 2, or 4");
+	}
 
 	// Mark the affected area
 	addDirtyRect(destRect);
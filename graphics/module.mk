@@ -96,7 +96,8 @@ MODULE_OBJS += \
 	tinygl/zmath.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
-	tinygl/zdirtyrect.o
+	tinygl/zdirtyrect.o \
+	tinygl/zspan.o
 endif
 
 ifdef USE_ASPECT
@@ -130,6 +131,16 @@ MODULE_OBJS += \
 	scaler/hq3x_i386.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	scaler/hq-neon.o
+endif
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	scaler/hq-sse2.o
+endif
+
 endif
 
 ifdef USE_EDGE_SCALERS
@@ -146,15 +157,33 @@ endif
 
 ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	blit/blit-neon.o
+	blit/blit-neon.o \
+	yuv_to_rgb-neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	blit/blit-sse2.o \
+	yuv_to_rgb-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	blit/blit-avx2.o \
+	yuv_to_rgb-avx2.o
+endif
+
+ifdef USE_TINYGL
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan-neon.o
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	tinygl/zspan-sse2.o
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
-	blit/blit-avx2.o
+	tinygl/zspan-avx2.o
+endif
 endif
 
 # Include common rules
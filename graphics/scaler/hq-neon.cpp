@@ -0,0 +1,85 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/scaler/hq.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+// The same test as diffYUV(), for 4 YUV values at a time. The Y, U and V
+// bytes differ by more than 0x30, 7 and 6 if their absolute difference
+// is greater than those thresholds.
+static inline uint32x4_t diffYUV_NEON(uint32x4_t yuv1, uint32x4_t yuv2) {
+	const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(0x00300706));
+	uint8x16_t diff = vcgtq_u8(vabdq_u8(vreinterpretq_u8_u32(yuv1), vreinterpretq_u8_u32(yuv2)), thresholds);
+	return vtstq_u32(vreinterpretq_u32_u8(diff), vreinterpretq_u32_u8(diff));
+}
+
+static inline uint32x4_t patternBit(uint32x4_t yuv5, const uint32 *yuv, uint32 bit) {
+	return vandq_u32(diffYUV_NEON(yuv5, vld1q_u32(yuv)), vdupq_n_u32(bit));
+}
+
+void HQScaler::patternRowNEON(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width) {
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		uint32x4_t pattern[2];
+		for (int i = 0; i < 2; i++) {
+			const int o = x + i * 4;
+			const uint32x4_t yuv5 = vld1q_u32(yuv + o + 1);
+			pattern[i] = vorrq_u32(
+			             vorrq_u32(vorrq_u32(patternBit(yuv5, yuvAbove + o, 0x01), patternBit(yuv5, yuvAbove + o + 1, 0x02)),
+			                       vorrq_u32(patternBit(yuv5, yuvAbove + o + 2, 0x04), patternBit(yuv5, yuv + o, 0x08))),
+			             vorrq_u32(vorrq_u32(patternBit(yuv5, yuv + o + 2, 0x10), patternBit(yuv5, yuvBelow + o, 0x20)),
+			                       vorrq_u32(patternBit(yuv5, yuvBelow + o + 1, 0x40), patternBit(yuv5, yuvBelow + o + 2, 0x80))));
+		}
+		uint16x8_t packed = vcombine_u16(vmovn_u32(pattern[0]), vmovn_u32(pattern[1]));
+		vst1_u8(patterns + x, vmovn_u16(packed));
+	}
+
+	if (x < width)
+		patternRowGeneric(yuvAbove + x, yuv + x, yuvBelow + x, patterns + x, width - x);
+}
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
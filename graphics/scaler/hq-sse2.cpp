@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/scaler/hq.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+// The same test as diffYUV(), for 4 YUV values at a time. The Y, U and V
+// bytes differ by more than 0x30, 7 and 6 if their absolute difference
+// still has bits left after a saturated subtraction of those thresholds.
+static inline __m128i diffYUV_SSE2(__m128i yuv1, __m128i yuv2) {
+	const __m128i thresholds = _mm_set1_epi32(0x00300706);
+	__m128i diff = _mm_or_si128(_mm_subs_epu8(yuv1, yuv2), _mm_subs_epu8(yuv2, yuv1));
+	diff = _mm_subs_epu8(diff, thresholds);
+	return _mm_xor_si128(_mm_cmpeq_epi32(diff, _mm_setzero_si128()), _mm_set1_epi32(-1));
+}
+
+static inline __m128i patternBit(__m128i yuv5, const uint32 *yuv, int bit) {
+	return _mm_and_si128(diffYUV_SSE2(yuv5, _mm_loadu_si128((const __m128i *)yuv)), _mm_set1_epi32(bit));
+}
+
+void HQScaler::patternRowSSE2(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width) {
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i pattern[2];
+		for (int i = 0; i < 2; i++) {
+			const int o = x + i * 4;
+			const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(yuv + o + 1));
+			pattern[i] = _mm_or_si128(
+			             _mm_or_si128(_mm_or_si128(patternBit(yuv5, yuvAbove + o, 0x01), patternBit(yuv5, yuvAbove + o + 1, 0x02)),
+			                          _mm_or_si128(patternBit(yuv5, yuvAbove + o + 2, 0x04), patternBit(yuv5, yuv + o, 0x08))),
+			             _mm_or_si128(_mm_or_si128(patternBit(yuv5, yuv + o + 2, 0x10), patternBit(yuv5, yuvBelow + o, 0x20)),
+			                          _mm_or_si128(patternBit(yuv5, yuvBelow + o + 1, 0x40), patternBit(yuv5, yuvBelow + o + 2, 0x80))));
+		}
+		// The patterns fit in a byte, so packing can't saturate them
+		__m128i packed = _mm_packs_epi32(pattern[0], pattern[1]);
+		_mm_storel_epi64((__m128i *)(patterns + x), _mm_packus_epi16(packed, packed));
+	}
+
+	if (x < width)
+		patternRowGeneric(yuvAbove + x, yuv + x, yuvBelow + x, patterns + x, width - x);
+}
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -18,6 +18,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "common/system.h"
+
 #include "graphics/scaler/hq.h"
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
@@ -193,13 +195,45 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+/**
+ * Convert a row of pixels to YUV values.
+ */
+template<typename ColorMask>
+static void convertRowYUV(const typename ColorMask::PixelType *p, uint32 *yuv, int count, const uint32 *RGBtoYUV) {
+	for (int i = 0; i < count; i++) {
+		if (sizeof(typename ColorMask::PixelType) == 2)
+			yuv[i] = RGBtoYUV[p[i]];
+		else
+			yuv[i] = ConvertYUV<ColorMask>(p[i], RGBtoYUV);
+	}
+}
+
+void HQScaler::patternRowGeneric(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width) {
+	for (int x = 0; x < width; x++) {
+		// Equal pixels have equal YUV values, which diffYUV() never
+		// reports as different
+		const int yuv5 = yuv[x + 1];
+		int pattern = 0;
+		if (diffYUV(yuv5, yuvAbove[x])) pattern |= 0x0001;
+		if (diffYUV(yuv5, yuvAbove[x + 1])) pattern |= 0x0002;
+		if (diffYUV(yuv5, yuvAbove[x + 2])) pattern |= 0x0004;
+		if (diffYUV(yuv5, yuv[x])) pattern |= 0x0008;
+		if (diffYUV(yuv5, yuv[x + 2])) pattern |= 0x0010;
+		if (diffYUV(yuv5, yuvBelow[x])) pattern |= 0x0020;
+		if (diffYUV(yuv5, yuvBelow[x + 1])) pattern |= 0x0040;
+		if (diffYUV(yuv5, yuvBelow[x + 2])) pattern |= 0x0080;
+		patterns[x] = pattern;
+	}
+}
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (https://web.archive.org/web/20090204033742/http://www.hiend3d.com/hq2x.html).
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV,
+                                HQScaler::PatternRowFunc patternRow, uint32 *yuvRows, uint8 *patterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -221,7 +255,22 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	uint32 *yuvAbove = yuvRows;
+	uint32 *yuv = yuvRows + (width + 2);
+	uint32 *yuvBelow = yuvRows + 2 * (width + 2);
+	convertRowYUV<ColorMask>(p - 1 - nextlineSrc, yuvAbove, width + 2, RGBtoYUV);
+	convertRowYUV<ColorMask>(p - 1, yuv, width + 2, RGBtoYUV);
+
 	while (height--) {
+		convertRowYUV<ColorMask>(p - 1 + nextlineSrc, yuvBelow, width + 2, RGBtoYUV);
+		patternRow(yuvAbove, yuv, yuvBelow, patterns, width);
+		const uint8 *pat = patterns;
+
+		uint32 *tmp = yuvAbove;
+		yuvAbove = yuv;
+		yuv = yuvBelow;
+		yuvBelow = tmp;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -238,16 +287,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *pat++;
 
 			switch (pattern) {
 			case 0:
@@ -2116,7 +2156,8 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
  * Adapted for ScummVM to 16 bit output and optimized by Max Horn.
  */
 template<typename ColorMask>
-static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV) {
+static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height, const uint32 *RGBtoYUV,
+                                HQScaler::PatternRowFunc patternRow, uint32 *yuvRows, uint8 *patterns) {
 	typedef typename ColorMask::PixelType Pixel;
 
 	int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
@@ -2139,7 +2180,22 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+	uint32 *yuvAbove = yuvRows;
+	uint32 *yuv = yuvRows + (width + 2);
+	uint32 *yuvBelow = yuvRows + 2 * (width + 2);
+	convertRowYUV<ColorMask>(p - 1 - nextlineSrc, yuvAbove, width + 2, RGBtoYUV);
+	convertRowYUV<ColorMask>(p - 1, yuv, width + 2, RGBtoYUV);
+
 	while (height--) {
+		convertRowYUV<ColorMask>(p - 1 + nextlineSrc, yuvBelow, width + 2, RGBtoYUV);
+		patternRow(yuvAbove, yuv, yuvBelow, patterns, width);
+		const uint8 *pat = patterns;
+
+		uint32 *tmp = yuvAbove;
+		yuvAbove = yuv;
+		yuv = yuvBelow;
+		yuvBelow = tmp;
+
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
 		w7 = *(p - 1 + nextlineSrc);
@@ -2156,16 +2212,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = *pat++;
 
 			switch (pattern) {
 			case 0:
@@ -4947,6 +4994,20 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	}
 }
 
+HQScaler::PatternRowFunc HQScaler::_patternRow = nullptr;
+
+void HQScaler::selectPatternRow() {
+	_patternRow = patternRowGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		_patternRow = patternRowNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_patternRow = patternRowSSE2;
+#endif
+}
+
 HQScaler::HQScaler(const Graphics::PixelFormat &format) : Scaler(format),
 #ifdef USE_NASM
 	_hqx_params(nullptr),
@@ -4987,19 +5048,19 @@ void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 void HQScaler::HQ2x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 }
 
 void HQScaler::HQ3x16(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (_format.gLoss == 2)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 }
 #endif
 
@@ -5007,15 +5068,15 @@ void HQScaler::HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ2x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 		} else {
 			HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ2x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 	}
 }
 
@@ -5023,20 +5084,25 @@ void HQScaler::HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint3
 	if (_format.aLoss == 0) {
 		if (_format.aShift == 0) {
 			HQ3x_implementation<Graphics::ColorMasks<-8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 		} else {
 			HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr,
-					dstPitch, width, height, _RGBtoYUV);
+					dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 		}
 	} else {
 		assert((_format.rMax() | _format.gMax() | _format.bMax()) <= 0xffffff);
 		HQ3x_implementation<Graphics::ColorMasks<888> >(srcPtr, srcPitch, dstPtr,
-				dstPitch, width, height, _RGBtoYUV);
+				dstPitch, width, height, _RGBtoYUV, _patternRow, _yuvRows.begin(), _patterns.begin());
 	}
 }
 
 void HQScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	if (!_patternRow)
+		selectPatternRow();
+	_yuvRows.resize(3 * (width + 2));
+	_patterns.resize(width);
+
 	if (_format.bytesPerPixel == 2) {
 		switch (_factor) {
 		case 2:
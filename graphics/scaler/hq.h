@@ -21,18 +21,30 @@
 #ifndef GRAPHICS_SCALER_HQ_H
 #define GRAPHICS_SCALER_HQ_H
 
+#include "common/array.h"
+
 #include "graphics/scalerplugin.h"
 
 #ifdef USE_NASM
 struct hqx_parameters;
 #endif
 
+class HQScalerTestSuite;
+
 class HQScaler : public Scaler {
 public:
 	HQScaler(const Graphics::PixelFormat &format);
 	~HQScaler();
 	uint increaseFactor() override;
 	uint decreaseFactor() override;
+
+	/**
+	 * Compute the pattern of each pixel in a row, which has a bit for each
+	 * of the 8 neighbours that differs from the pixel. The YUV rows of the
+	 * row and of the rows above and below it start one pixel to the left.
+	 */
+	typedef void (*PatternRowFunc)(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width);
+
 protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch,
 							uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) override;
@@ -43,11 +55,34 @@ protected:
 	inline void HQ2x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 	inline void HQ3x32(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 
+	static void patternRowGeneric(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width);
+#ifdef SCUMMVM_NEON
+	static void patternRowNEON(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void patternRowSSE2(const uint32 *yuvAbove, const uint32 *yuv, const uint32 *yuvBelow, uint8 *patterns, int width);
+#endif
+
 	uint32 *_RGBtoYUV;
+	Common::Array<uint32> _yuvRows;
+	Common::Array<uint8> _patterns;
+
+	/**
+	 * The pattern function in use, selected on first use.
+	 *
+	 * Only computing the patterns has SSE2 and NEON versions. The
+	 * interpolation of the scaled pixels which follows is scalar, since each
+	 * pixel picks its own case by its pattern.
+	 */
+	static PatternRowFunc _patternRow;
+	static void selectPatternRow();
+
 #ifdef USE_NASM
 	hqx_parameters *_hqx_params;
 #endif
 
+	friend class ::HQScalerTestSuite;
+
 };
 
 
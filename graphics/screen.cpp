@@ -26,15 +26,18 @@
 
 namespace Graphics {
 
-Screen::Screen(): ManagedSurface() {
+Screen::Screen(): ManagedSurface(), _dirtyTileSize(0), _dirtyTilesPerRow(0),
+		_dirtyTileRows(0), _hasDirtyTiles(false), _uploadedBytes(0) {
 	create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 }
 
-Screen::Screen(int width, int height): ManagedSurface() {
+Screen::Screen(int width, int height): ManagedSurface(), _dirtyTileSize(0), _dirtyTilesPerRow(0),
+		_dirtyTileRows(0), _hasDirtyTiles(false), _uploadedBytes(0) {
 	create(width, height);
 }
 
-Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface() {
+Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface(), _dirtyTileSize(0),
+		_dirtyTilesPerRow(0), _dirtyTileRows(0), _hasDirtyTiles(false), _uploadedBytes(0) {
 	create(width, height, pixelFormat);
 }
 
@@ -43,12 +46,14 @@ void Screen::update() {
 	mergeDirtyRects();
 
 	// Loop through copying dirty areas to the physical screen
+	_uploadedBytes = 0;
 	Common::List<Common::Rect>::iterator i;
 	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
 		const Common::Rect &r = *i;
 		const byte *srcP = (const byte *)getBasePtr(r.left, r.top);
 		g_system->copyRectToScreen(srcP, pitch, r.left, r.top,
 			r.width(), r.height());
+		_uploadedBytes += r.width() * r.height() * format.bytesPerPixel;
 	}
 
 	// Signal the physical screen to update
@@ -66,16 +71,129 @@ void Screen::addDirtyRect(const Common::Rect &r) {
 	bounds.clip(getBounds());
 	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
 
-	if (bounds.width() > 0 && bounds.height() > 0)
+	if (bounds.width() <= 0 || bounds.height() <= 0)
+		return;
+
+	if (!_dirtyTileSize) {
 		_dirtyRects.push_back(bounds);
+		return;
+	}
+
+	// The screen may have been recreated with another size
+	const int tilesPerRow = (this->w + _dirtyTileSize - 1) / _dirtyTileSize;
+	const int tileRows = (this->h + _dirtyTileSize - 1) / _dirtyTileSize;
+	if (tilesPerRow != _dirtyTilesPerRow || tileRows != _dirtyTileRows) {
+		_dirtyTilesPerRow = tilesPerRow;
+		_dirtyTileRows = tileRows;
+		_dirtyTiles.clear();
+		_dirtyTiles.resize(tilesPerRow * tileRows);
+		_hasDirtyTiles = false;
+	}
+
+	bounds.clip(Common::Rect(this->w, this->h));
+	if (bounds.isEmpty())
+		return;
+
+	const int left = bounds.left / _dirtyTileSize;
+	const int right = (bounds.right - 1) / _dirtyTileSize;
+	const int top = bounds.top / _dirtyTileSize;
+	const int bottom = (bounds.bottom - 1) / _dirtyTileSize;
+	for (int y = top; y <= bottom; ++y) {
+		for (int x = left; x <= right; ++x)
+			_dirtyTiles[y * _dirtyTilesPerRow + x] = true;
+	}
+	_hasDirtyTiles = true;
 }
 
-void Screen::makeAllDirty() {
+void Screen::clearDirtyRects() {
 	_dirtyRects.clear();
+
+	if (_hasDirtyTiles) {
+		Common::fill(_dirtyTiles.begin(), _dirtyTiles.end(), false);
+		_hasDirtyTiles = false;
+	}
+}
+
+void Screen::setDirtyTileSize(int tileSize) {
+	if (tileSize == _dirtyTileSize)
+		return;
+
+	// Keep what is already dirty
+	dirtyTilesToRects();
+
+	_dirtyTileSize = tileSize;
+	_dirtyTilesPerRow = _dirtyTileRows = 0;
+	_dirtyTiles.clear();
+
+	if (_dirtyTileSize) {
+		Common::List<Common::Rect> dirtyRects;
+		SWAP(dirtyRects, _dirtyRects);
+		for (Common::List<Common::Rect>::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i)
+			addDirtyRect(*i);
+	}
+}
+
+void Screen::makeAllDirty() {
+	clearDirtyRects();
 	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
 }
 
+void Screen::dirtyTilesToRects() {
+	if (!_hasDirtyTiles)
+		return;
+
+	// Rects covering runs of tiles on the previous tile row, which grow
+	// downwards while the next rows have runs with the same extent
+	Common::Array<Common::Rect> openRects, rowRects, tileRects;
+
+	for (int y = 0; y < _dirtyTileRows; ++y) {
+		const bool *row = &_dirtyTiles[y * _dirtyTilesPerRow];
+		rowRects.clear();
+
+		for (int x = 0; x < _dirtyTilesPerRow; ) {
+			if (!row[x]) {
+				++x;
+				continue;
+			}
+
+			const int start = x;
+			while (x < _dirtyTilesPerRow && row[x])
+				++x;
+
+			Common::Rect r(start, y, x, y + 1);
+			for (uint i = 0; i < openRects.size(); ++i) {
+				if (openRects[i].left == r.left && openRects[i].right == r.right) {
+					r.top = openRects[i].top;
+					openRects.remove_at(i);
+					break;
+				}
+			}
+			rowRects.push_back(r);
+		}
+
+		// Rects which did not grow into this row are finished
+		tileRects.push_back(openRects);
+		SWAP(openRects, rowRects);
+	}
+	tileRects.push_back(openRects);
+
+	// Scale the rects from tiles to pixels
+	for (uint i = 0; i < tileRects.size(); ++i) {
+		const Common::Rect &r = tileRects[i];
+		_dirtyRects.push_back(Common::Rect(r.left * _dirtyTileSize, r.top * _dirtyTileSize,
+			MIN<int>(r.right * _dirtyTileSize, this->w), MIN<int>(r.bottom * _dirtyTileSize, this->h)));
+	}
+
+	Common::fill(_dirtyTiles.begin(), _dirtyTiles.end(), false);
+	_hasDirtyTiles = false;
+}
+
 void Screen::mergeDirtyRects() {
+	if (_dirtyTileSize) {
+		dirtyTilesToRects();
+		return;
+	}
+
 	Common::List<Common::Rect>::iterator rOuter, rInner;
 
 	// Process the dirty rect list to find any rects to merge
@@ -25,6 +25,7 @@
 #include "graphics/managed_surface.h"
 #include "graphics/palette.h"
 #include "graphics/pixelformat.h"
+#include "common/array.h"
 #include "common/list.h"
 #include "common/rect.h"
 
@@ -51,12 +52,36 @@ protected:
 	 * List of affected areas of the screen
 	 */
 	Common::List<Common::Rect> _dirtyRects;
+
+	/**
+	 * Size of the dirty tiles in pixels, or 0 to keep a list of dirty rects
+	 */
+	int _dirtyTileSize;
+
+	/**
+	 * Dirty flags of the tiles, row by row, when tracking dirty tiles
+	 */
+	Common::Array<bool> _dirtyTiles;
+	int _dirtyTilesPerRow, _dirtyTileRows;
+	bool _hasDirtyTiles;
+
+	/**
+	 * Number of bytes copied to the system by the last update
+	 */
+	uint _uploadedBytes;
 protected:
 	/**
-	 * Merges together overlapping dirty areas of the screen
+	 * Merges together overlapping dirty areas of the screen. When tracking
+	 * dirty tiles, this turns the dirty tiles into the fewest rects that
+	 * cover runs of adjacent tiles.
 	 */
 	void mergeDirtyRects();
 
+	/**
+	 * Turns the dirty tiles into rects in the dirty rects list
+	 */
+	void dirtyTilesToRects();
+
 	/**
 	 * Returns the union of two dirty area rectangles
 	 */
@@ -69,7 +94,23 @@ public:
 	/**
 	 * Returns true if there are any pending screen updates (dirty areas)
 	 */
-	bool isDirty() const { return !_dirtyRects.empty(); }
+	bool isDirty() const { return !_dirtyRects.empty() || _hasDirtyTiles; }
+
+	/**
+	 * Sets how modified areas are tracked. By default, a list of dirty rects
+	 * is kept, and overlapping ones are merged before updating. With a tile
+	 * size, the screen is split into tiles of that many pixels square
+	 * instead, and only the tiles touched by the dirty rects are copied.
+	 * This avoids copying the area between small, far apart changes.
+	 *
+	 * @param tileSize	Size of the tiles in pixels, or 0 to keep a rect list
+	 */
+	void setDirtyTileSize(int tileSize);
+
+	/**
+	 * Returns the number of bytes copied to the system by the last update
+	 */
+	uint getUploadedBytes() const { return _uploadedBytes; }
 
 	/**
 	 * Marks the whole screen as dirty. This forces the next call to update
@@ -80,7 +121,7 @@ public:
 	/**
 	 * Clear the current dirty rects list
 	 */
-	virtual void clearDirtyRects() { _dirtyRects.clear(); }
+	virtual void clearDirtyRects();
 
 	/**
 	 * Adds a rectangle to the list of modified areas of the screen during the
@@ -39,6 +39,9 @@ void destroyContext(ContextHandle *handle);
 void setContext(ContextHandle *handle);
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
+// Render queued draw calls tile by tile, 0 disables tiling.
+// Set it between frames, as draw calls record their region when issued.
+void setTileSize(int tileSize);
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyFromFrameBuffer(const Graphics::PixelFormat &dstFormat);
 
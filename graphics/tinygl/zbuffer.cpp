@@ -42,6 +42,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_pbufFormat = format;
 	_pbufBpp = _pbufFormat.bytesPerPixel;
 	_pbufPitch = (_pbufWidth * _pbufBpp + 3) & ~3;
+	_spanFormatSupported = TexturedSpan::getFormat(_pbufFormat, _spanFormat);
 
 	_pbuf = (byte *)gl_zalloc(_pbufHeight * _pbufPitch * sizeof(byte));
 	_zbuf = (uint *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(uint));
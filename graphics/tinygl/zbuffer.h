@@ -31,6 +31,7 @@
 #include "graphics/surface.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 
 #include "common/rect.h"
 #include "common/textconsole.h"
@@ -761,6 +762,8 @@ private:
 	int _pbufPitch;
 	Graphics::PixelFormat _pbufFormat;
 	int _pbufBpp;
+	TexturedSpan::Format _spanFormat;
+	bool _spanFormatSupported;
 
 	uint *_zbuf;
 	byte *_sbuf;
@@ -801,6 +804,8 @@ private:
 	float _fogColorR;
 	float _fogColorG;
 	float _fogColorB;
+
+	friend class ::TinyGLSpanTestSuite;
 };
 
 // memory.c
@@ -192,12 +192,18 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		if (_tileSize > 0) {
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				renderTiles((*itRect).rectangle);
+			}
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -239,8 +245,14 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
+	if (_tileSize > 0) {
+		renderTiles(renderRect);
+	}
+
 	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
+		if (_tileSize == 0) {
+			(*it)->execute(true);
+		}
 		delete *it;
 	}
 
@@ -251,6 +263,79 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+void GLContext::renderTiles(const Common::Rect &region) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	DrawCallIterator it = _drawCallsQueue.begin();
+	while (it != _drawCallsQueue.end()) {
+		DrawCallIterator last = it;
+		while (last != _drawCallsQueue.end() && (*last)->isTileable()) {
+			++last;
+		}
+		renderTiles(region, it, last);
+		if (last == _drawCallsQueue.end())
+			break;
+
+		// Draw calls which can't be split are drawn on the whole region, in order.
+		if ((*last)->getDirtyRegion().intersects(region)) {
+			(*last)->execute(region, true);
+		}
+		it = ++last;
+	}
+}
+
+void GLContext::renderTiles(const Common::Rect &region, Common::List<DrawCall *>::const_iterator first,
+                            Common::List<DrawCall *>::const_iterator last) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	const int tilesX = (region.width() + _tileSize - 1) / _tileSize;
+	const int tilesY = (region.height() + _tileSize - 1) / _tileSize;
+	if (first == last || tilesX <= 0 || tilesY <= 0)
+		return;
+
+	// Bin the draw calls by the tiles their dirty region touches.
+	// Bins keep their storage from one frame to the next.
+	_tileBins.resize(tilesX * tilesY);
+	for (int i = 0; i < tilesX * tilesY; i++) {
+		_tileBins[i].resize(0);
+	}
+
+	for (DrawCallIterator it = first; it != last; ++it) {
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		drawCallRegion.clip(region);
+		if (drawCallRegion.isEmpty())
+			continue;
+
+		int firstX = (drawCallRegion.left - region.left) / _tileSize;
+		int lastX = (drawCallRegion.right - 1 - region.left) / _tileSize;
+		int firstY = (drawCallRegion.top - region.top) / _tileSize;
+		int lastY = (drawCallRegion.bottom - 1 - region.top) / _tileSize;
+		for (int y = firstY; y <= lastY; y++) {
+			for (int x = firstX; x <= lastX; x++) {
+				_tileBins[y * tilesX + x].push_back(*it);
+			}
+		}
+	}
+
+	// Tiles do not overlap, so rendering them one after the other gives the
+	// same result as rendering each draw call on the whole region, while the
+	// color and depth buffer of a tile stay in the cache.
+	for (int y = 0; y < tilesY; y++) {
+		for (int x = 0; x < tilesX; x++) {
+			const Common::Array<DrawCall *> &bin = _tileBins[y * tilesX + x];
+			if (bin.empty())
+				continue;
+
+			Common::Rect tile(_tileSize, _tileSize);
+			tile.moveTo(region.left + x * _tileSize, region.top + y * _tileSize);
+			tile.clip(region);
+			for (uint i = 0; i < bin.size(); i++) {
+				bin[i]->execute(tile, true);
+			}
+		}
+	}
+}
+
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	GLContext *c = gl_get_context();
 	if (c->_enableDirtyRectangles) {
@@ -265,6 +350,14 @@ void presentBuffer() {
 	presentBuffer(dirtyAreas);
 }
 
+void setTileSize(int tileSize) {
+	GLContext *c = gl_get_context();
+	c->_tileSize = MAX(tileSize, 0);
+	if (c->_tileSize == 0) {
+		c->_tileBins.clear();
+	}
+}
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -294,7 +387,7 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
 	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	if (c->needsDirtyRegions()) {
 		computeDirtyRegion();
 	}
 }
@@ -556,6 +649,11 @@ void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool
 	c->fb->resetScissorRectangle();
 }
 
+bool RasterizationDrawCall::isTileable() const {
+	// Quad strips shift their vertices while they are drawn.
+	return _state.beginType != TGL_QUAD_STRIP;
+}
+
 bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const {
 	if (_vertexCount == other._vertexCount &&
 		_drawTriangleFront == other._drawTriangleFront &&
@@ -576,7 +674,7 @@ BlittingDrawCall::BlittingDrawCall(BlitImage *image, const BlitTransform &transf
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (gl_get_context()->_enableDirtyRectangles) {
+	if (gl_get_context()->needsDirtyRegions()) {
 		computeDirtyRegion();
 	}
 }
@@ -610,6 +708,14 @@ void BlittingDrawCall::execute(bool restoreState) const {
 	}
 }
 
+bool BlittingDrawCall::isTileable() const {
+	// Scaled, rotated and flipped blits are not clipped exactly the way they are drawn.
+	if (_mode != BlitMode_Regular)
+		return true;
+	return _transform._destinationRectangle.width() == 0 && _transform._destinationRectangle.height() == 0 &&
+	       _transform._rotation == 0 && !_transform._flipHorizontally && !_transform._flipVertically;
+}
+
 void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
 	Internal::tglBlitSetScissorRect(clippingRectangle);
 	execute(restoreState);
@@ -693,7 +799,7 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	  _rValue(rValue), _gValue(gValue), _bValue(bValue), _clearStencilBuffer(clearStencilBuffer),
 	  _stencilValue(stencilValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->needsDirtyRegions()) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -57,6 +57,8 @@ public:
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
+	// Whether clipping the draw call to tiles gives the same pixels as drawing it whole.
+	virtual bool isTileable() const { return true; }
 protected:
 	Common::Rect _dirtyRegion;
 private:
@@ -89,6 +91,7 @@ public:
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual bool isTileable() const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -170,6 +173,7 @@ public:
 	bool operator==(const BlittingDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual bool isTileable() const;
 
 	BlittingMode getBlittingMode() const { return _mode; }
 
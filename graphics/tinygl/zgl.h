@@ -452,6 +452,10 @@ struct GLContext {
 
 	bool _enableDirtyRectangles;
 
+	// Tiled rendering: 0 when disabled, otherwise the size of a square tile.
+	int _tileSize;
+	Common::Array<Common::Array<DrawCall *> > _tileBins;
+
 	// stipple
 	bool polygon_stipple_enabled;
 	byte polygon_stipple_pattern[128];
@@ -523,6 +527,10 @@ public:
 
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
+	void renderTiles(const Common::Rect &region);
+	void renderTiles(const Common::Rect &region, Common::List<DrawCall *>::const_iterator first,
+	                 Common::List<DrawCall *>::const_iterator last);
+	bool needsDirtyRegions() const { return _enableDirtyRectangles || _tileSize > 0; }
 
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
@@ -0,0 +1,152 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+class TexturedSpanImpl_AVX2 {
+public:
+	// The values of the 8 pixels of a block
+	static FORCEINLINE __m256i interpolate(uint value, int step) {
+		return _mm256_add_epi32(_mm256_set1_epi32(value),
+		                        _mm256_mullo_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+	}
+
+	// Lanes of the pixels which are set in mask
+	static FORCEINLINE __m256i laneMask(uint mask) {
+		const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(mask), bits), bits);
+	}
+
+	// ((c * (l >> 8)) >> 8) & 0xFF, where c is a byte
+	static FORCEINLINE __m256i light(__m256i c, __m256i l) {
+		l = _mm256_and_si256(_mm256_srli_epi32(l, 8), _mm256_set1_epi32(0xFFFF));
+		return _mm256_and_si256(_mm256_srli_epi32(_mm256_mullo_epi16(c, l), 8), _mm256_set1_epi32(0xFF));
+	}
+
+	static uint depthTest(const uint *pz, uint z, int dzdx, int depthFunc) {
+		const __m256i src = interpolate(z, dzdx);
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)pz);
+		// Unsigned comparisons, using max(a, b) == a for a >= b
+		__m256i pass;
+		switch (depthFunc) {
+		case TGL_LESS:
+			pass = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(dst, src), dst), _mm256_set1_epi32(-1));
+			break;
+		case TGL_EQUAL:
+			pass = _mm256_cmpeq_epi32(src, dst);
+			break;
+		case TGL_LEQUAL:
+			pass = _mm256_cmpeq_epi32(_mm256_max_epu32(dst, src), src);
+			break;
+		case TGL_GREATER:
+			pass = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_max_epu32(dst, src), src), _mm256_set1_epi32(-1));
+			break;
+		case TGL_NOTEQUAL:
+			pass = _mm256_xor_si256(_mm256_cmpeq_epi32(src, dst), _mm256_set1_epi32(-1));
+			break;
+		case TGL_GEQUAL:
+			pass = _mm256_cmpeq_epi32(_mm256_max_epu32(dst, src), dst);
+			break;
+		case TGL_ALWAYS:
+			return 0xFF;
+		default:
+			return 0;
+		}
+		return _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+	}
+
+	static void shade(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const TexturedSpan::Block &block,
+	                  const TexturedSpan::Format &format, TexturedSpan::BlendMode blendMode, bool depthWrite) {
+		const __m256i z = interpolate(block.z, block.dzdx);
+		if (depthWrite && _mm256_movemask_ps(_mm256_castsi256_ps(z)) != 0) {
+			// Depths of 2^31 and up don't fit the signed float conversion
+			TexturedSpan::shadeGeneric(dst, pz, texels, mask, block, format, blendMode, depthWrite);
+			return;
+		}
+
+		const __m256i byteMask = _mm256_set1_epi32(0xFF);
+		const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+		const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+		const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+		const __m128i aShift = _mm_cvtsi32_si128(format.aShift);
+		const __m256i aMask = _mm256_set1_epi32(format.aMask);
+		const __m256i lanes = laneMask(mask);
+
+		if (depthWrite) {
+			// The depth goes through a float on its way to the z buffer
+			__m256i zf = _mm256_cvttps_epi32(_mm256_cvtepi32_ps(z));
+			_mm256_maskstore_epi32((int *)pz, lanes, zf);
+		}
+
+		const __m256i t = _mm256_loadu_si256((const __m256i *)texels);
+		__m256i ca = light(_mm256_srli_epi32(t, 24), interpolate(block.a, block.dadx));
+		__m256i cr = light(_mm256_and_si256(_mm256_srli_epi32(t, 16), byteMask), interpolate(block.r, block.drdx));
+		__m256i cg = light(_mm256_and_si256(_mm256_srli_epi32(t, 8), byteMask), interpolate(block.g, block.dgdx));
+		__m256i cb = light(_mm256_and_si256(t, byteMask), interpolate(block.b, block.dbdx));
+
+		__m256i color;
+		if (blendMode == TexturedSpan::kBlendNone) {
+			color = _mm256_or_si256(_mm256_and_si256(_mm256_sll_epi32(ca, aShift), aMask),
+			        _mm256_or_si256(_mm256_sll_epi32(cr, rShift),
+			        _mm256_or_si256(_mm256_sll_epi32(cg, gShift), _mm256_sll_epi32(cb, bShift))));
+		} else {
+			const __m256i d = _mm256_loadu_si256((const __m256i *)dst);
+			const __m256i invA = _mm256_sub_epi32(byteMask, ca);
+			__m256i dr = _mm256_and_si256(_mm256_srl_epi32(d, rShift), byteMask);
+			__m256i dg = _mm256_and_si256(_mm256_srl_epi32(d, gShift), byteMask);
+			__m256i db = _mm256_and_si256(_mm256_srl_epi32(d, bShift), byteMask);
+			cr = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(cr, ca), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dr, invA), 8));
+			cg = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(cg, ca), 8), _mm256_srli_epi32(_mm256_mullo_epi16(dg, invA), 8));
+			cb = _mm256_add_epi32(_mm256_srli_epi32(_mm256_mullo_epi16(cb, ca), 8), _mm256_srli_epi32(_mm256_mullo_epi16(db, invA), 8));
+			color = _mm256_or_si256(aMask,
+			        _mm256_or_si256(_mm256_sll_epi32(_mm256_min_epu32(cr, byteMask), rShift),
+			        _mm256_or_si256(_mm256_sll_epi32(_mm256_min_epu32(cg, byteMask), gShift),
+			                        _mm256_sll_epi32(_mm256_min_epu32(cb, byteMask), bShift))));
+		}
+		_mm256_maskstore_epi32((int *)dst, lanes, color);
+	}
+}; // End of class TexturedSpanImpl_AVX2
+
+const TexturedSpan::Funcs TexturedSpan::_funcsAVX2 = {
+	TexturedSpanImpl_AVX2::depthTest, TexturedSpanImpl_AVX2::shade
+};
+
+} // end of namespace TinyGL
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
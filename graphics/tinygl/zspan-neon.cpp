@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace TinyGL {
+
+class TexturedSpanImpl_NEON {
+public:
+	// The values of the 4 pixels starting at pixel i of a block
+	static FORCEINLINE uint32x4_t interpolate(uint value, int step, int i) {
+		static const uint32 offsets[4] = { 0, 1, 2, 3 };
+		return vmlaq_n_u32(vdupq_n_u32(value + i * step), vld1q_u32(offsets), (uint32)step);
+	}
+
+	// Lanes of the pixels which are set in mask
+	static FORCEINLINE uint32x4_t laneMask(uint mask, int i) {
+		static const uint32 bits[4] = { 1, 2, 4, 8 };
+		return vtstq_u32(vdupq_n_u32(mask >> i), vld1q_u32(bits));
+	}
+
+	// ((c * (l >> 8)) >> 8) & 0xFF
+	static FORCEINLINE uint32x4_t light(uint32x4_t c, uint32x4_t l) {
+		return vandq_u32(vshrq_n_u32(vmulq_u32(c, vshrq_n_u32(l, 8)), 8), vdupq_n_u32(0xFF));
+	}
+
+	static FORCEINLINE uint movemask(uint32x4_t v) {
+		static const uint32 bits[4] = { 1, 2, 4, 8 };
+		uint32x4_t b = vandq_u32(v, vld1q_u32(bits));
+		uint32x2_t s = vorr_u32(vget_low_u32(b), vget_high_u32(b));
+		return vget_lane_u32(s, 0) | vget_lane_u32(s, 1);
+	}
+
+	static uint depthTest(const uint *pz, uint z, int dzdx, int depthFunc) {
+		uint mask = 0;
+		for (int i = 0; i < TexturedSpan::kBlockSize; i += 4) {
+			uint32x4_t src = interpolate(z, dzdx, i);
+			uint32x4_t dst = vld1q_u32((const uint32 *)pz + i);
+			uint32x4_t pass;
+			switch (depthFunc) {
+			case TGL_LESS:
+				pass = vcltq_u32(dst, src);
+				break;
+			case TGL_EQUAL:
+				pass = vceqq_u32(dst, src);
+				break;
+			case TGL_LEQUAL:
+				pass = vcleq_u32(dst, src);
+				break;
+			case TGL_GREATER:
+				pass = vcgtq_u32(dst, src);
+				break;
+			case TGL_NOTEQUAL:
+				pass = vmvnq_u32(vceqq_u32(dst, src));
+				break;
+			case TGL_GEQUAL:
+				pass = vcgeq_u32(dst, src);
+				break;
+			case TGL_ALWAYS:
+				pass = vdupq_n_u32(0xFFFFFFFF);
+				break;
+			default:
+				pass = vdupq_n_u32(0);
+				break;
+			}
+			mask |= movemask(pass) << i;
+		}
+		return mask;
+	}
+
+	static void shade(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const TexturedSpan::Block &block,
+	                  const TexturedSpan::Format &format, TexturedSpan::BlendMode blendMode, bool depthWrite) {
+		const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+		const int32x4_t rShift = vdupq_n_s32(format.rShift);
+		const int32x4_t gShift = vdupq_n_s32(format.gShift);
+		const int32x4_t bShift = vdupq_n_s32(format.bShift);
+		const int32x4_t aShift = vdupq_n_s32(format.aShift);
+		const uint32x4_t aMask = vdupq_n_u32(format.aMask);
+
+		for (int i = 0; i < TexturedSpan::kBlockSize; i += 4) {
+			if (((mask >> i) & 0xF) == 0)
+				continue;
+
+			const uint32x4_t lanes = laneMask(mask, i);
+			if (depthWrite) {
+				// The depth goes through a float on its way to the z buffer
+				uint32x4_t zf = vcvtq_u32_f32(vcvtq_f32_u32(interpolate(block.z, block.dzdx, i)));
+				uint32x4_t oldZ = vld1q_u32((const uint32 *)pz + i);
+				vst1q_u32((uint32 *)pz + i, vbslq_u32(lanes, zf, oldZ));
+			}
+
+			const uint32x4_t t = vld1q_u32(texels + i);
+			uint32x4_t ca = light(vshrq_n_u32(t, 24), interpolate(block.a, block.dadx, i));
+			uint32x4_t cr = light(vandq_u32(vshrq_n_u32(t, 16), byteMask), interpolate(block.r, block.drdx, i));
+			uint32x4_t cg = light(vandq_u32(vshrq_n_u32(t, 8), byteMask), interpolate(block.g, block.dgdx, i));
+			uint32x4_t cb = light(vandq_u32(t, byteMask), interpolate(block.b, block.dbdx, i));
+
+			const uint32x4_t d = vld1q_u32(dst + i);
+			uint32x4_t color;
+			if (blendMode == TexturedSpan::kBlendNone) {
+				color = vorrq_u32(vandq_u32(vshlq_u32(ca, aShift), aMask),
+				        vorrq_u32(vshlq_u32(cr, rShift),
+				        vorrq_u32(vshlq_u32(cg, gShift), vshlq_u32(cb, bShift))));
+			} else {
+				const uint32x4_t invA = vsubq_u32(byteMask, ca);
+				uint32x4_t dr = vandq_u32(vshlq_u32(d, vnegq_s32(rShift)), byteMask);
+				uint32x4_t dg = vandq_u32(vshlq_u32(d, vnegq_s32(gShift)), byteMask);
+				uint32x4_t db = vandq_u32(vshlq_u32(d, vnegq_s32(bShift)), byteMask);
+				cr = vaddq_u32(vshrq_n_u32(vmulq_u32(cr, ca), 8), vshrq_n_u32(vmulq_u32(dr, invA), 8));
+				cg = vaddq_u32(vshrq_n_u32(vmulq_u32(cg, ca), 8), vshrq_n_u32(vmulq_u32(dg, invA), 8));
+				cb = vaddq_u32(vshrq_n_u32(vmulq_u32(cb, ca), 8), vshrq_n_u32(vmulq_u32(db, invA), 8));
+				color = vorrq_u32(aMask,
+				        vorrq_u32(vshlq_u32(vminq_u32(cr, byteMask), rShift),
+				        vorrq_u32(vshlq_u32(vminq_u32(cg, byteMask), gShift),
+				                  vshlq_u32(vminq_u32(cb, byteMask), bShift))));
+			}
+			vst1q_u32(dst + i, vbslq_u32(lanes, color, d));
+		}
+	}
+}; // End of class TexturedSpanImpl_NEON
+
+const TexturedSpan::Funcs TexturedSpan::_funcsNEON = {
+	TexturedSpanImpl_NEON::depthTest, TexturedSpanImpl_NEON::shade
+};
+
+} // end of namespace TinyGL
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,184 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace TinyGL {
+
+class TexturedSpanImpl_SSE2 {
+public:
+	// The values of the 4 pixels starting at pixel i of a block
+	static FORCEINLINE __m128i interpolate(uint value, int step, int i) {
+		return _mm_setr_epi32(value + i * step, value + (i + 1) * step, value + (i + 2) * step, value + (i + 3) * step);
+	}
+
+	// Lanes of the pixels which are set in mask
+	static FORCEINLINE __m128i laneMask(uint mask, int i) {
+		const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+		return _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(mask >> i), bits), bits);
+	}
+
+	static FORCEINLINE __m128i select(__m128i mask, __m128i a, __m128i b) {
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	// ((c * (l >> 8)) >> 8) & 0xFF, where c is a byte
+	static FORCEINLINE __m128i light(__m128i c, __m128i l) {
+		l = _mm_and_si128(_mm_srli_epi32(l, 8), _mm_set1_epi32(0xFFFF));
+		return _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi16(c, l), 8), _mm_set1_epi32(0xFF));
+	}
+
+	static uint depthTest(const uint *pz, uint z, int dzdx, int depthFunc) {
+		const __m128i sign = _mm_set1_epi32((int)0x80000000);
+		uint mask = 0;
+		for (int i = 0; i < TexturedSpan::kBlockSize; i += 4) {
+			__m128i src = _mm_xor_si128(interpolate(z, dzdx, i), sign);
+			__m128i dst = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pz + i)), sign);
+			__m128i pass;
+			switch (depthFunc) {
+			case TGL_LESS:
+				pass = _mm_cmpgt_epi32(src, dst);
+				break;
+			case TGL_EQUAL:
+				pass = _mm_cmpeq_epi32(src, dst);
+				break;
+			case TGL_LEQUAL:
+				pass = _mm_xor_si128(_mm_cmpgt_epi32(dst, src), _mm_set1_epi32(-1));
+				break;
+			case TGL_GREATER:
+				pass = _mm_cmpgt_epi32(dst, src);
+				break;
+			case TGL_NOTEQUAL:
+				pass = _mm_xor_si128(_mm_cmpeq_epi32(src, dst), _mm_set1_epi32(-1));
+				break;
+			case TGL_GEQUAL:
+				pass = _mm_xor_si128(_mm_cmpgt_epi32(src, dst), _mm_set1_epi32(-1));
+				break;
+			case TGL_ALWAYS:
+				pass = _mm_set1_epi32(-1);
+				break;
+			default:
+				pass = _mm_setzero_si128();
+				break;
+			}
+			mask |= _mm_movemask_ps(_mm_castsi128_ps(pass)) << i;
+		}
+		return mask;
+	}
+
+	static void shade(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const TexturedSpan::Block &block,
+	                  const TexturedSpan::Format &format, TexturedSpan::BlendMode blendMode, bool depthWrite) {
+		const __m128i byteMask = _mm_set1_epi32(0xFF);
+		const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+		const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+		const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+		const __m128i aShift = _mm_cvtsi32_si128(format.aShift);
+		const __m128i aMask = _mm_set1_epi32(format.aMask);
+
+		for (int i = 0; i < TexturedSpan::kBlockSize; i += 4) {
+			if (((mask >> i) & 0xF) == 0)
+				continue;
+
+			const __m128i lanes = laneMask(mask, i);
+			const __m128i z = interpolate(block.z, block.dzdx, i);
+			if (depthWrite) {
+				// The depth goes through a float on its way to the z buffer
+				if (_mm_movemask_ps(_mm_castsi128_ps(z)) != 0) {
+					TexturedSpan::shadeGeneric(dst + i, pz + i, texels + i, (mask >> i) & 0xF, shiftBlock(block, i),
+					                           format, blendMode, depthWrite);
+					continue;
+				}
+				__m128i zf = _mm_cvttps_epi32(_mm_cvtepi32_ps(z));
+				__m128i oldZ = _mm_loadu_si128((const __m128i *)(pz + i));
+				_mm_storeu_si128((__m128i *)(pz + i), select(lanes, zf, oldZ));
+			}
+
+			const __m128i t = _mm_loadu_si128((const __m128i *)(texels + i));
+			__m128i ca = light(_mm_srli_epi32(t, 24), interpolate(block.a, block.dadx, i));
+			__m128i cr = light(_mm_and_si128(_mm_srli_epi32(t, 16), byteMask), interpolate(block.r, block.drdx, i));
+			__m128i cg = light(_mm_and_si128(_mm_srli_epi32(t, 8), byteMask), interpolate(block.g, block.dgdx, i));
+			__m128i cb = light(_mm_and_si128(t, byteMask), interpolate(block.b, block.dbdx, i));
+
+			const __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+			__m128i color;
+			if (blendMode == TexturedSpan::kBlendNone) {
+				color = _mm_or_si128(_mm_and_si128(_mm_sll_epi32(ca, aShift), aMask),
+				        _mm_or_si128(_mm_sll_epi32(cr, rShift),
+				        _mm_or_si128(_mm_sll_epi32(cg, gShift), _mm_sll_epi32(cb, bShift))));
+			} else {
+				const __m128i invA = _mm_sub_epi32(byteMask, ca);
+				__m128i dr = _mm_and_si128(_mm_srl_epi32(d, rShift), byteMask);
+				__m128i dg = _mm_and_si128(_mm_srl_epi32(d, gShift), byteMask);
+				__m128i db = _mm_and_si128(_mm_srl_epi32(d, bShift), byteMask);
+				cr = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(cr, ca), 8), _mm_srli_epi32(_mm_mullo_epi16(dr, invA), 8));
+				cg = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(cg, ca), 8), _mm_srli_epi32(_mm_mullo_epi16(dg, invA), 8));
+				cb = _mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(cb, ca), 8), _mm_srli_epi32(_mm_mullo_epi16(db, invA), 8));
+				color = _mm_or_si128(aMask,
+				        _mm_or_si128(_mm_sll_epi32(_mm_min_epi16(cr, byteMask), rShift),
+				        _mm_or_si128(_mm_sll_epi32(_mm_min_epi16(cg, byteMask), gShift),
+				                     _mm_sll_epi32(_mm_min_epi16(cb, byteMask), bShift))));
+			}
+			_mm_storeu_si128((__m128i *)(dst + i), select(lanes, color, d));
+		}
+	}
+
+	static TexturedSpan::Block shiftBlock(const TexturedSpan::Block &block, int i) {
+		TexturedSpan::Block shifted = block;
+		shifted.z += i * block.dzdx;
+		shifted.r += i * block.drdx;
+		shifted.g += i * block.dgdx;
+		shifted.b += i * block.dbdx;
+		shifted.a += i * block.dadx;
+		return shifted;
+	}
+}; // End of class TexturedSpanImpl_SSE2
+
+const TexturedSpan::Funcs TexturedSpan::_funcsSSE2 = {
+	TexturedSpanImpl_SSE2::depthTest, TexturedSpanImpl_SSE2::shade
+};
+
+} // end of namespace TinyGL
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
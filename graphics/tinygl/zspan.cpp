@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+bool TexturedSpan::getFormat(const Graphics::PixelFormat &pf, Format &format) {
+	if (pf.bytesPerPixel != 4 || pf.rLoss != 0 || pf.gLoss != 0 || pf.bLoss != 0)
+		return false;
+	if (pf.aLoss != 0 && pf.aLoss != 8)
+		return false;
+
+	format.rShift = pf.rShift;
+	format.gShift = pf.gShift;
+	format.bShift = pf.bShift;
+	format.aShift = pf.aLoss == 0 ? pf.aShift : 0;
+	format.aMask = pf.aLoss == 0 ? 0xFF << pf.aShift : 0;
+	return true;
+}
+
+int TexturedSpan::getBlendMode(bool blendingEnabled, int sfactor, int dfactor) {
+	if (!blendingEnabled)
+		return kBlendNone;
+	if (sfactor == TGL_SRC_ALPHA && dfactor == TGL_ONE_MINUS_SRC_ALPHA)
+		return kBlendSrcAlpha;
+	return -1;
+}
+
+uint TexturedSpan::depthTestGeneric(const uint *pz, uint z, int dzdx, int depthFunc) {
+	uint mask = 0;
+	for (int i = 0; i < kBlockSize; i++) {
+		bool pass;
+		switch (depthFunc) {
+		case TGL_LESS:
+			pass = pz[i] < z;
+			break;
+		case TGL_EQUAL:
+			pass = pz[i] == z;
+			break;
+		case TGL_LEQUAL:
+			pass = pz[i] <= z;
+			break;
+		case TGL_GREATER:
+			pass = pz[i] > z;
+			break;
+		case TGL_NOTEQUAL:
+			pass = pz[i] != z;
+			break;
+		case TGL_GEQUAL:
+			pass = pz[i] >= z;
+			break;
+		case TGL_ALWAYS:
+			pass = true;
+			break;
+		default:
+			pass = false;
+			break;
+		}
+		if (pass)
+			mask |= 1 << i;
+		z += dzdx;
+	}
+	return mask;
+}
+
+void TexturedSpan::shadeGeneric(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const Block &block,
+                                const Format &format, BlendMode blendMode, bool depthWrite) {
+	uint z = block.z, r = block.r, g = block.g, b = block.b, a = block.a;
+	for (int i = 0; i < kBlockSize; i++) {
+		if (mask & (1 << i)) {
+			// Same as the lighting in FrameBuffer::putPixelTexture()
+			uint8 c_a = (((texels[i] >> 24) & 0xFF) * (a >> 8)) >> 8;
+			uint8 c_r = (((texels[i] >> 16) & 0xFF) * (r >> 8)) >> 8;
+			uint8 c_g = (((texels[i] >> 8) & 0xFF) * (g >> 8)) >> 8;
+			uint8 c_b = ((texels[i] & 0xFF) * (b >> 8)) >> 8;
+
+			if (depthWrite)
+				pz[i] = (uint)(float)z;
+
+			if (blendMode == kBlendNone) {
+				dst[i] = (c_a << format.aShift & format.aMask) | (c_r << format.rShift) |
+				         (c_g << format.gShift) | (c_b << format.bShift);
+			} else {
+				uint finalR = ((c_r * c_a) >> 8) + ((((dst[i] >> format.rShift) & 0xFF) * (255 - c_a)) >> 8);
+				uint finalG = ((c_g * c_a) >> 8) + ((((dst[i] >> format.gShift) & 0xFF) * (255 - c_a)) >> 8);
+				uint finalB = ((c_b * c_a) >> 8) + ((((dst[i] >> format.bShift) & 0xFF) * (255 - c_a)) >> 8);
+				dst[i] = format.aMask | (MIN<uint>(finalR, 255) << format.rShift) |
+				         (MIN<uint>(finalG, 255) << format.gShift) | (MIN<uint>(finalB, 255) << format.bShift);
+			}
+		}
+		z += block.dzdx;
+		r += block.drdx;
+		g += block.dgdx;
+		b += block.dbdx;
+		a += block.dadx;
+	}
+}
+
+const TexturedSpan::Funcs TexturedSpan::_funcsGeneric = {
+	depthTestGeneric, shadeGeneric
+};
+
+const TexturedSpan::Funcs *TexturedSpan::_funcs = nullptr;
+
+void TexturedSpan::selectFuncs() {
+	_funcs = &_funcsGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		_funcs = &_funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_funcs = &_funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		_funcs = &_funcsAVX2;
+#endif
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+
+#include "graphics/pixelformat.h"
+
+class TinyGLSpanTestSuite;
+class TinyGLTilesTestSuite;
+
+namespace TinyGL {
+
+/**
+ * Block functions for the textured spans of FrameBuffer::fillTriangle(),
+ * using SIMD instructions where the CPU has them.
+ *
+ * A block is the kBlockSize pixels which share the same perspective
+ * corrected texture steps. The block functions give the same results as
+ * FrameBuffer::putPixelTexture(), for the cases without stencil, alpha
+ * test and fog, and for a 32-bit frame buffer with 8-bit channels. They do
+ * not scissor, so only blocks inside the scissor rectangle may use them.
+ */
+class TexturedSpan {
+public:
+	enum {
+		kBlockSize = 8
+	};
+
+	enum BlendMode {
+		kBlendNone,    /*!< Blending disabled. */
+		kBlendSrcAlpha /*!< TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA. */
+	};
+
+	/** The layout of the frame buffer pixels. */
+	struct Format {
+		uint rShift, gShift, bShift, aShift;
+		uint32 aMask; /*!< 0 when the frame buffer has no alpha channel. */
+	};
+
+	/** The interpolated values at the first pixel of a block, and their steps. */
+	struct Block {
+		uint z;
+		int dzdx;
+		uint r, g, b, a;
+		int drdx, dgdx, dbdx; /*!< 0 when flat shaded. */
+		uint dadx;
+	};
+
+	/** Fill @p format and return true if the block functions handle @p pf. */
+	static bool getFormat(const Graphics::PixelFormat &pf, Format &format);
+
+	/** Return the blend mode matching the given factors, or -1 if there is none. */
+	static int getBlendMode(bool blendingEnabled, int sfactor, int dfactor);
+
+	/**
+	 * Depth test a block. A disabled depth test is passed as TGL_ALWAYS.
+	 *
+	 * @return A bit for each pixel which passes the test.
+	 */
+	static uint depthTest(const uint *pz, uint z, int dzdx, int depthFunc) {
+		return getFuncs().depthTest(pz, z, dzdx, depthFunc);
+	}
+
+	/**
+	 * Light, blend and write the pixels of a block which are set in @p mask.
+	 *
+	 * @param texels The A8R8G8B8 texture colors of the pixels in @p mask.
+	 */
+	static void shade(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const Block &block,
+	                  const Format &format, BlendMode blendMode, bool depthWrite) {
+		getFuncs().shade(dst, pz, texels, mask, block, format, blendMode, depthWrite);
+	}
+
+private:
+	struct Funcs {
+		uint (*depthTest)(const uint *pz, uint z, int dzdx, int depthFunc);
+		void (*shade)(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const Block &block,
+		              const Format &format, BlendMode blendMode, bool depthWrite);
+	};
+
+	static const Funcs &getFuncs() {
+		if (!_funcs)
+			selectFuncs();
+		return *_funcs;
+	}
+
+	static void selectFuncs();
+
+	static uint depthTestGeneric(const uint *pz, uint z, int dzdx, int depthFunc);
+	static void shadeGeneric(uint32 *dst, uint *pz, const uint32 *texels, uint mask, const Block &block,
+	                         const Format &format, BlendMode blendMode, bool depthWrite);
+
+	static const Funcs _funcsGeneric;
+#ifdef SCUMMVM_NEON
+	static const Funcs _funcsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Funcs _funcsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Funcs _funcsAVX2;
+#endif
+
+	/** The block functions in use, selected on first use. */
+	static const Funcs *_funcs;
+
+	friend class TexturedSpanImpl_NEON;
+	friend class TexturedSpanImpl_SSE2;
+	friend class TexturedSpanImpl_AVX2;
+	friend class ::TinyGLSpanTestSuite;
+	friend class ::TinyGLTilesTestSuite;
+}; // End of class TexturedSpan
+
+} // end of namespace TinyGL
+
+#endif
@@ -51,6 +51,18 @@ void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int &dzdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
                                     uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
+		// Keep interpolating, so that redrawing a dirty rectangle gives the
+		// same pixels as drawing the whole span, without seams at its edges.
+		z += dzdx;
+		if (kFogMode) {
+			fog += dfdx;
+		}
+		if (kSmoothMode) {
+			r += drdx;
+			g += dgdx;
+			b += dbdx;
+			a += dadx;
+		}
 		return;
 	}
 
@@ -99,6 +111,20 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
                                   int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
                                   uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
+		// Keep interpolating, so that redrawing a dirty rectangle gives the
+		// same pixels as drawing the whole span, without seams at its edges.
+		z += dzdx;
+		s += dsdx;
+		t += dtdx;
+		if (kFogMode) {
+			fog += dfdx;
+		}
+		if (kSmoothMode) {
+			a += dadx;
+			r += drdx;
+			g += dgdx;
+			b += dbdx;
+		}
 		return;
 	}
 
@@ -150,6 +176,7 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
 template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kStippleEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx) {
 	if (kEnableScissor && scissorPixel(x + _a, y)) {
+		z += dzdx;
 		return;
 	}
 
@@ -347,6 +374,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	// The textured blocks can go through the TexturedSpan block functions when
+	// nothing needs per pixel state which those don't handle. With scissoring,
+	// only the blocks entirely inside the scissor rectangle do.
+	STATIC_ASSERT(NB_INTERP == TexturedSpan::kBlockSize, TexturedSpan_blocks_must_match_the_interpolation_blocks);
+	int spanBlendMode = -1;
+	if (kInterpZ && !kStencilEnabled && !kFogMode && !kAlphaTestEnabled && _spanFormatSupported)
+		spanBlendMode = TexturedSpan::getBlendMode(kBlendingEnabled, _sourceBlendingFactor, _destinationBlendingFactor);
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -446,7 +481,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && y >= _clipRectangle.bottom) {
+				// The remaining lines are all below the scissor rectangle.
+				return;
+			}
+			if (kEnableScissor && (y < _clipRectangle.top || x1 >= _clipRectangle.right || (x2 >> 16) < _clipRectangle.left)) {
+				// The span is entirely outside the scissor rectangle, only step the edges.
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -579,9 +620,42 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					if (spanBlendMode >= 0 && (!kEnableScissor || (x >= _clipRectangle.left && x + NB_INTERP <= _clipRectangle.right))) {
+						uint mask = TexturedSpan::depthTest(pz, z, dzdx, kDepthTestEnabled ? _depthFunc : TGL_ALWAYS);
+						if (mask) {
+							TexturedSpan::Block block;
+							uint32 texels[TexturedSpan::kBlockSize];
+							for (int _a = 0; _a < NB_INTERP; _a++) {
+								uint8 c_a = 0, c_r = 0, c_g = 0, c_b = 0;
+								if (mask & (1 << _a))
+									texture->getARGBAt(_wrapS, _wrapT, s + _a * dsdx, t + _a * dtdx, c_a, c_r, c_g, c_b);
+								texels[_a] = (c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+							}
+							block.z = z;
+							block.dzdx = dzdx;
+							block.r = r;
+							block.g = g;
+							block.b = b;
+							block.a = a;
+							block.drdx = kSmoothMode ? drdx : 0;
+							block.dgdx = kSmoothMode ? dgdx : 0;
+							block.dbdx = kSmoothMode ? dbdx : 0;
+							block.dadx = kSmoothMode ? dadx : 0;
+							TexturedSpan::shade((uint32 *)_pbuf + pp, pz, texels, mask, block, _spanFormat,
+							                    (TexturedSpan::BlendMode)spanBlendMode, kDepthWrite);
+						}
+						z += NB_INTERP * dzdx;
+						if (kSmoothMode) {
+							r += NB_INTERP * drdx;
+							g += NB_INTERP * dgdx;
+							b += NB_INTERP * dbdx;
+							a += NB_INTERP * dadx;
+						}
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
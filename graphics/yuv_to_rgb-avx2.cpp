@@ -0,0 +1,120 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+// Map the sums of luminance and chroma to color values like the clip table does
+template<bool itu>
+static FORCEINLINE __m256i avx2_clip(__m256i x, __m128i loss) {
+	if (itu) {
+		x = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(235)), _mm256_set1_epi16(16));
+		// x * 255 / 219, exact for 0 <= x <= 219
+		x = _mm256_mulhi_epu16(_mm256_slli_epi16(x, 3), _mm256_set1_epi16(9539));
+	} else {
+		x = _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+	}
+	return _mm256_srl_epi16(x, loss);
+}
+
+// Load the chroma offsets for 16 pixels
+template<bool subsampled>
+static FORCEINLINE __m256i avx2_loadChroma(const int16 *src, int x) {
+	if (subsampled) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(src + (x >> 1)));
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(c, c)), _mm_unpackhi_epi16(c, c), 1);
+	}
+	return _mm256_loadu_si256((const __m256i *)(src + x));
+}
+
+// Widen 16 color values to 32 bits and move them into place
+static FORCEINLINE void avx2_place32(__m256i x, __m128i shift, __m256i &p0, __m256i &p1) {
+	p0 = _mm256_or_si256(p0, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(x)), shift));
+	p1 = _mm256_or_si256(p1, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(x, 1)), shift));
+}
+
+struct YUVToRGBKernelAVX2 {
+	template<typename PixelInt, bool subsampled, bool alpha, bool itu>
+	static int convert(const YUVToRGBManager::Row &row, const PixelFormat &format) {
+		const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss);
+		const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss);
+		const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss);
+		const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss);
+		const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+		const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+		const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+		const __m128i aShift = _mm_cvtsi32_si128(format.aShift);
+		const uint32 aMask = (0xFF >> format.aLoss) << format.aShift;
+
+		int x = 0;
+		for (; x + 16 <= row.width; x += 16) {
+			const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(row.ySrc + x)));
+			const __m256i r = avx2_clip<itu>(_mm256_add_epi16(y, avx2_loadChroma<subsampled>(row.crR, x)), rLoss);
+			const __m256i g = avx2_clip<itu>(_mm256_add_epi16(y, avx2_loadChroma<subsampled>(row.crbG, x)), gLoss);
+			const __m256i b = avx2_clip<itu>(_mm256_add_epi16(y, avx2_loadChroma<subsampled>(row.cbB, x)), bLoss);
+			__m256i a = _mm256_setzero_si256();
+			if (alpha)
+				a = _mm256_srl_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(row.aSrc + x))), aLoss);
+
+			if (sizeof(PixelInt) == 2) {
+				__m256i p = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift)), _mm256_sll_epi16(b, bShift));
+				p = _mm256_or_si256(p, alpha ? _mm256_sll_epi16(a, aShift) : _mm256_set1_epi16((int16)aMask));
+				_mm256_storeu_si256((__m256i *)(row.dst + x * 2), p);
+			} else {
+				__m256i p0 = alpha ? _mm256_setzero_si256() : _mm256_set1_epi32(aMask);
+				__m256i p1 = p0;
+				avx2_place32(r, rShift, p0, p1);
+				avx2_place32(g, gShift, p0, p1);
+				avx2_place32(b, bShift, p0, p1);
+				if (alpha)
+					avx2_place32(a, aShift, p0, p1);
+				_mm256_storeu_si256((__m256i *)(row.dst + x * 4), p0);
+				_mm256_storeu_si256((__m256i *)(row.dst + x * 4 + 32), p1);
+			}
+		}
+
+		return x;
+	}
+};
+
+int YUVToRGBManager::convertRowAVX2(const Row &row, const PixelFormat &format, LuminanceScale scale) {
+	return convertYUVToRGBRow<YUVToRGBKernelAVX2>(row, format, scale);
+}
+
+} // End of namespace Graphics
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Graphics {
+
+// Map the sums of luminance and chroma to color values like the clip table does.
+// The loss is passed negated, as NEON shifts right by negative amounts.
+template<bool itu>
+static inline uint16x8_t neon_clip(int16x8_t x, int16x8_t negLoss) {
+	uint16x8_t c;
+	if (itu) {
+		c = vreinterpretq_u16_s16(vsubq_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(16)), vdupq_n_s16(235)), vdupq_n_s16(16)));
+		// x * 255 / 219, exact for 0 <= x <= 219
+		const uint16x4_t k = vdup_n_u16(9539);
+		c = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(c), k), 13), vshrn_n_u32(vmull_u16(vget_high_u16(c), k), 13));
+	} else {
+		c = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(0)), vdupq_n_s16(255)));
+	}
+	return vshlq_u16(c, negLoss);
+}
+
+// Load the chroma offsets for 8 pixels
+template<bool subsampled>
+static inline int16x8_t neon_loadChroma(const int16 *src, int x) {
+	if (subsampled) {
+		const int16x4_t c = vld1_s16(src + (x >> 1));
+		const int16x4x2_t z = vzip_s16(c, c);
+		return vcombine_s16(z.val[0], z.val[1]);
+	}
+	return vld1q_s16(src + x);
+}
+
+struct YUVToRGBKernelNEON {
+	template<typename PixelInt, bool subsampled, bool alpha, bool itu>
+	static int convert(const YUVToRGBManager::Row &row, const PixelFormat &format) {
+		const int16x8_t rLoss = vdupq_n_s16(-format.rLoss);
+		const int16x8_t gLoss = vdupq_n_s16(-format.gLoss);
+		const int16x8_t bLoss = vdupq_n_s16(-format.bLoss);
+		const int16x8_t aLoss = vdupq_n_s16(-format.aLoss);
+		const uint32 aMask = (0xFF >> format.aLoss) << format.aShift;
+
+		int x = 0;
+		for (; x + 8 <= row.width; x += 8) {
+			const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(row.ySrc + x)));
+			const uint16x8_t r = neon_clip<itu>(vaddq_s16(y, neon_loadChroma<subsampled>(row.crR, x)), rLoss);
+			const uint16x8_t g = neon_clip<itu>(vaddq_s16(y, neon_loadChroma<subsampled>(row.crbG, x)), gLoss);
+			const uint16x8_t b = neon_clip<itu>(vaddq_s16(y, neon_loadChroma<subsampled>(row.cbB, x)), bLoss);
+			uint16x8_t a = vdupq_n_u16(0);
+			if (alpha)
+				a = vshlq_u16(vmovl_u8(vld1_u8(row.aSrc + x)), aLoss);
+
+			if (sizeof(PixelInt) == 2) {
+				uint16x8_t p = vorrq_u16(vshlq_u16(r, vdupq_n_s16(format.rShift)), vshlq_u16(g, vdupq_n_s16(format.gShift)));
+				p = vorrq_u16(p, vshlq_u16(b, vdupq_n_s16(format.bShift)));
+				p = vorrq_u16(p, alpha ? vshlq_u16(a, vdupq_n_s16(format.aShift)) : vdupq_n_u16((uint16)aMask));
+				vst1q_u16((uint16 *)(row.dst + x * 2), p);
+			} else {
+				const int32x4_t rShift = vdupq_n_s32(format.rShift);
+				const int32x4_t gShift = vdupq_n_s32(format.gShift);
+				const int32x4_t bShift = vdupq_n_s32(format.bShift);
+				uint32x4_t p0 = vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(g)), gShift));
+				uint32x4_t p1 = vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(g)), gShift));
+				p0 = vorrq_u32(p0, vshlq_u32(vmovl_u16(vget_low_u16(b)), bShift));
+				p1 = vorrq_u32(p1, vshlq_u32(vmovl_u16(vget_high_u16(b)), bShift));
+				if (alpha) {
+					const int32x4_t aShift = vdupq_n_s32(format.aShift);
+					p0 = vorrq_u32(p0, vshlq_u32(vmovl_u16(vget_low_u16(a)), aShift));
+					p1 = vorrq_u32(p1, vshlq_u32(vmovl_u16(vget_high_u16(a)), aShift));
+				} else {
+					p0 = vorrq_u32(p0, vdupq_n_u32(aMask));
+					p1 = vorrq_u32(p1, vdupq_n_u32(aMask));
+				}
+				vst1q_u32((uint32 *)(row.dst + x * 4), p0);
+				vst1q_u32((uint32 *)(row.dst + x * 4 + 16), p1);
+			}
+		}
+
+		return x;
+	}
+};
+
+int YUVToRGBManager::convertRowNEON(const Row &row, const PixelFormat &format, LuminanceScale scale) {
+	return convertYUVToRGBRow<YUVToRGBKernelNEON>(row, format, scale);
+}
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+// Map the sums of luminance and chroma to color values like the clip table does
+template<bool itu>
+static FORCEINLINE __m128i sse2_clip(__m128i x, __m128i loss) {
+	if (itu) {
+		x = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(235)), _mm_set1_epi16(16));
+		// x * 255 / 219, exact for 0 <= x <= 219
+		x = _mm_mulhi_epu16(_mm_slli_epi16(x, 3), _mm_set1_epi16(9539));
+	} else {
+		x = _mm_min_epi16(_mm_max_epi16(x, _mm_setzero_si128()), _mm_set1_epi16(255));
+	}
+	return _mm_srl_epi16(x, loss);
+}
+
+struct YUVToRGBKernelSSE2 {
+	template<typename PixelInt, bool subsampled, bool alpha, bool itu>
+	static int convert(const YUVToRGBManager::Row &row, const PixelFormat &format) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss);
+		const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss);
+		const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss);
+		const __m128i aLoss = _mm_cvtsi32_si128(format.aLoss);
+		const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+		const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+		const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+		const __m128i aShift = _mm_cvtsi32_si128(format.aShift);
+		const uint32 aMask = (0xFF >> format.aLoss) << format.aShift;
+
+		int x = 0;
+		for (; x + 8 <= row.width; x += 8) {
+			__m128i crR, crbG, cbB;
+			if (subsampled) {
+				crR = _mm_loadl_epi64((const __m128i *)(row.crR + (x >> 1)));
+				crbG = _mm_loadl_epi64((const __m128i *)(row.crbG + (x >> 1)));
+				cbB = _mm_loadl_epi64((const __m128i *)(row.cbB + (x >> 1)));
+				crR = _mm_unpacklo_epi16(crR, crR);
+				crbG = _mm_unpacklo_epi16(crbG, crbG);
+				cbB = _mm_unpacklo_epi16(cbB, cbB);
+			} else {
+				crR = _mm_loadu_si128((const __m128i *)(row.crR + x));
+				crbG = _mm_loadu_si128((const __m128i *)(row.crbG + x));
+				cbB = _mm_loadu_si128((const __m128i *)(row.cbB + x));
+			}
+
+			const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(row.ySrc + x)), zero);
+			const __m128i r = sse2_clip<itu>(_mm_add_epi16(y, crR), rLoss);
+			const __m128i g = sse2_clip<itu>(_mm_add_epi16(y, crbG), gLoss);
+			const __m128i b = sse2_clip<itu>(_mm_add_epi16(y, cbB), bLoss);
+			__m128i a = zero;
+			if (alpha)
+				a = _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(row.aSrc + x)), zero), aLoss);
+
+			if (sizeof(PixelInt) == 2) {
+				__m128i p = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift)), _mm_sll_epi16(b, bShift));
+				p = _mm_or_si128(p, alpha ? _mm_sll_epi16(a, aShift) : _mm_set1_epi16((int16)aMask));
+				_mm_storeu_si128((__m128i *)(row.dst + x * 2), p);
+			} else {
+				__m128i p0 = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift));
+				__m128i p1 = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift));
+				p0 = _mm_or_si128(p0, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift));
+				p1 = _mm_or_si128(p1, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift));
+				if (alpha) {
+					p0 = _mm_or_si128(p0, _mm_sll_epi32(_mm_unpacklo_epi16(a, zero), aShift));
+					p1 = _mm_or_si128(p1, _mm_sll_epi32(_mm_unpackhi_epi16(a, zero), aShift));
+				} else {
+					p0 = _mm_or_si128(p0, _mm_set1_epi32(aMask));
+					p1 = _mm_or_si128(p1, _mm_set1_epi32(aMask));
+				}
+				_mm_storeu_si128((__m128i *)(row.dst + x * 4), p0);
+				_mm_storeu_si128((__m128i *)(row.dst + x * 4 + 16), p1);
+			}
+		}
+
+		return x;
+	}
+};
+
+int YUVToRGBManager::convertRowSSE2(const Row &row, const PixelFormat &format, LuminanceScale scale) {
+	return convertYUVToRGBRow<YUVToRGBKernelSSE2>(row, format, scale);
+}
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -82,6 +82,8 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
@@ -99,12 +101,14 @@ public:
 	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
 	const int16 *getColorTable() const { return _colorTab; }
 	const byte *getClipTable() const { return _clipTable; }
+	const int *getClipOffsets() const { return _clipOffsets; }
 
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	byte _clipTable[3 * 768];
+	int _clipOffsets[3]; // Where value 0 of each channel is in the clip table
 };
 
 YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
@@ -122,6 +126,10 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	byte *g_2_pix_alloc = &_clipTable[g_offset];
 	byte *b_2_pix_alloc = &_clipTable[b_offset];
 
+	_clipOffsets[0] = r_offset + 256;
+	_clipOffsets[1] = g_offset + 256;
+	_clipOffsets[2] = b_offset + 256;
+
 	if (scale == YUVToRGBManager::kScaleFull) {
 		// Set up entries 0-255 in rgb-to-pixel value tables.
 		for (int i = 0; i < 256; i++) {
@@ -181,10 +189,30 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
+YUVToRGBManager::RowFunc YUVToRGBManager::_rowFunc = nullptr;
+bool YUVToRGBManager::_rowFuncSelected = false;
+
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 }
 
+void YUVToRGBManager::selectRowFunc() {
+	_rowFunc = nullptr;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		_rowFunc = convertRowNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_rowFunc = convertRowSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		_rowFunc = convertRowAVX2;
+#endif
+	_rowFuncSelected = true;
+}
+
 YUVToRGBManager::~YUVToRGBManager() {
 	delete _lookup;
 }
@@ -238,6 +266,188 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+// Precompute what the chroma samples add to each color channel, as offsets
+// from value 0 of the channel in the clip table.
+static void buildChromaRow(const YUVToRGBLookup *lookup, const byte *uSrc, const byte *vSrc, int count, int16 *crR, int16 *crbG, int16 *cbB) {
+	const int16 *Cr_r_tab = lookup->getColorTable();
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const int *clipOffsets = lookup->getClipOffsets();
+
+	for (int i = 0; i < count; i++) {
+		crR[i]  = Cr_r_tab[vSrc[i]] - clipOffsets[0];
+		crbG[i] = Cr_g_tab[vSrc[i]] + Cb_g_tab[uSrc[i]] - clipOffsets[1];
+		cbB[i]  = Cb_b_tab[uSrc[i]] - clipOffsets[2];
+	}
+}
+
+// Convert the pixels the SIMD row converter left over with the lookup tables
+template<typename PixelInt>
+static void convertRowTail(const YUVToRGBManager::Row &row, int start, const YUVToRGBLookup *lookup) {
+	const byte *clipTable = lookup->getClipTable();
+	const int *clipOffsets = lookup->getClipOffsets();
+	const Graphics::PixelFormat &format = lookup->getFormat();
+	const PixelInt a_mask = (0xFF >> format.aLoss) << format.aShift;
+
+	PixelInt *dst = (PixelInt *)row.dst;
+	for (int x = start; x < row.width; x++) {
+		const int c = row.subsampled ? (x >> 1) : x;
+		const byte *L = &clipTable[row.ySrc[x]];
+
+		PixelInt pixel = (L[clipOffsets[0] + row.crR[c]] << format.rShift) |
+		                 (L[clipOffsets[1] + row.crbG[c]] << format.gShift) |
+		                 (L[clipOffsets[2] + row.cbB[c]] << format.bShift);
+		if (row.aSrc)
+			pixel |= (row.aSrc[x] >> format.aLoss) << format.aShift;
+		else
+			pixel |= a_mask;
+		dst[x] = pixel;
+	}
+}
+
+template<typename PixelInt>
+void YUVToRGBManager::convertRows444(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	_chroma.resize(yWidth * 3);
+
+	int16 *crR = _chroma.data();
+	int16 *crbG = crR + yWidth;
+	int16 *cbB = crbG + yWidth;
+
+	Row row;
+	row.crR = crR;
+	row.crbG = crbG;
+	row.cbB = cbB;
+	row.aSrc = nullptr;
+	row.width = yWidth;
+	row.subsampled = false;
+
+	for (int h = 0; h < yHeight; h++) {
+		buildChromaRow(lookup, uSrc, vSrc, yWidth, crR, crbG, cbB);
+
+		row.dst = dstPtr;
+		row.ySrc = ySrc;
+		convertRowTail<PixelInt>(row, _rowFunc(row, lookup->getFormat(), scale), lookup);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void YUVToRGBManager::convertRows422(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int halfWidth = yWidth >> 1;
+	_chroma.resize(halfWidth * 3);
+
+	int16 *crR = _chroma.data();
+	int16 *crbG = crR + halfWidth;
+	int16 *cbB = crbG + halfWidth;
+
+	Row row;
+	row.crR = crR;
+	row.crbG = crbG;
+	row.cbB = cbB;
+	row.aSrc = nullptr;
+	row.width = yWidth;
+	row.subsampled = true;
+
+	for (int h = 0; h < yHeight; h++) {
+		buildChromaRow(lookup, uSrc, vSrc, halfWidth, crR, crbG, cbB);
+
+		row.dst = dstPtr;
+		row.ySrc = ySrc;
+		convertRowTail<PixelInt>(row, _rowFunc(row, lookup->getFormat(), scale), lookup);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void YUVToRGBManager::convertRows420(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int halfWidth = yWidth >> 1;
+	_chroma.resize(halfWidth * 3);
+
+	int16 *crR = _chroma.data();
+	int16 *crbG = crR + halfWidth;
+	int16 *cbB = crbG + halfWidth;
+
+	Row row;
+	row.crR = crR;
+	row.crbG = crbG;
+	row.cbB = cbB;
+	row.width = yWidth;
+	row.subsampled = true;
+
+	for (int h = 0; h < yHeight; h++) {
+		// Each row of chroma samples is shared by two rows of pixels
+		if ((h & 1) == 0) {
+			buildChromaRow(lookup, uSrc, vSrc, halfWidth, crR, crbG, cbB);
+			uSrc += uvPitch;
+			vSrc += uvPitch;
+		}
+
+		row.dst = dstPtr;
+		row.ySrc = ySrc;
+		row.aSrc = aSrc;
+		convertRowTail<PixelInt>(row, _rowFunc(row, lookup->getFormat(), scale), lookup);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		if (aSrc)
+			aSrc += yPitch;
+	}
+}
+
+template<typename PixelInt>
+void YUVToRGBManager::convertRows410(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	_chroma.resize(yWidth * 5);
+
+	int16 *crR = _chroma.data();
+	int16 *crbG = crR + yWidth;
+	int16 *cbB = crbG + yWidth;
+
+	Row row;
+	row.crR = crR;
+	row.crbG = crbG;
+	row.cbB = cbB;
+	row.aSrc = nullptr;
+	row.width = yWidth;
+	row.subsampled = false;
+
+	// The bilinearly scaled chroma planes of the current row
+	byte *uRow = (byte *)(cbB + yWidth);
+	byte *vRow = uRow + yWidth;
+
+	for (int y = 0; y < yHeight; y++) {
+		const int yDiff = y & 3;
+		const byte *uLine = uSrc + (y >> 2) * uvPitch;
+		const byte *vLine = vSrc + (y >> 2) * uvPitch;
+
+		for (int x = 0; x < yWidth; x++) {
+			const int index = x >> 2;
+			const int xDiff = x & 3;
+			uRow[x] = (uLine[index] * (4 - xDiff) * (4 - yDiff) + uLine[index + 1] * xDiff * (4 - yDiff) +
+			           uLine[index + uvPitch] * yDiff * (4 - xDiff) + uLine[index + uvPitch + 1] * xDiff * yDiff) >> 4;
+			vRow[x] = (vLine[index] * (4 - xDiff) * (4 - yDiff) + vLine[index + 1] * xDiff * (4 - yDiff) +
+			           vLine[index + uvPitch] * yDiff * (4 - xDiff) + vLine[index + uvPitch + 1] * xDiff * yDiff) >> 4;
+		}
+
+		buildChromaRow(lookup, uRow, vRow, yWidth, crR, crbG, cbB);
+
+		row.dst = dstPtr;
+		row.ySrc = ySrc;
+		convertRowTail<PixelInt>(row, _rowFunc(row, lookup->getFormat(), scale), lookup);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -246,6 +456,17 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (!_rowFuncSelected)
+		selectRowFunc();
+
+	if (_rowFunc) {
+		if (dst->format.bytesPerPixel == 2)
+			convertRows444<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertRows444<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -303,6 +524,17 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (!_rowFuncSelected)
+		selectRowFunc();
+
+	if (_rowFunc) {
+		if (dst->format.bytesPerPixel == 2)
+			convertRows422<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertRows422<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV422ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -364,6 +596,17 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (!_rowFuncSelected)
+		selectRowFunc();
+
+	if (_rowFunc) {
+		if (dst->format.bytesPerPixel == 2)
+			convertRows420<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertRows420<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -433,6 +676,17 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (!_rowFuncSelected)
+		selectRowFunc();
+
+	if (_rowFunc) {
+		if (dst->format.bytesPerPixel == 2)
+			convertRows420<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertRows420<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -523,6 +777,17 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (!_rowFuncSelected)
+		selectRowFunc();
+
+	if (_rowFunc) {
+		if (dst->format.bytesPerPixel == 2)
+			convertRows410<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertRows410<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -37,10 +37,13 @@
 #ifndef GRAPHICS_YUV_TO_RGB_H
 #define GRAPHICS_YUV_TO_RGB_H
 
+#include "common/array.h"
 #include "common/scummsys.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
+class YUVToRGBTestSuite;
+
 namespace Graphics {
 
 class YUVToRGBLookup;
@@ -143,6 +146,63 @@ private:
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
 	YUVToRGBLookup *_lookup;
+
+public:
+	/**
+	 * A row of pixels for the SIMD row converters.
+	 *
+	 * The chroma contributions to each color channel are precomputed from
+	 * the lookup tables, so the row converters produce exactly the same
+	 * pixels as the table based code.
+	 */
+	struct Row {
+		byte *dst;
+		const byte *ySrc;
+		const byte *aSrc;   /*!< Alpha values, or nullptr for opaque pixels. */
+		const int16 *crR;   /*!< Red offset for each chroma sample. */
+		const int16 *crbG;  /*!< Green offset for each chroma sample. */
+		const int16 *cbB;   /*!< Blue offset for each chroma sample. */
+		int width;          /*!< The number of pixels in the row. */
+		bool subsampled;    /*!< Whether each chroma sample covers two pixels. */
+	};
+
+private:
+	/**
+	 * Convert the start of a row with SIMD instructions.
+	 *
+	 * @return The number of pixels converted. The caller converts the rest.
+	 */
+	typedef int (*RowFunc)(const Row &row, const Graphics::PixelFormat &format, LuminanceScale scale);
+
+#ifdef SCUMMVM_NEON
+	static int convertRowNEON(const Row &row, const Graphics::PixelFormat &format, LuminanceScale scale);
+#endif
+#ifdef SCUMMVM_SSE2
+	static int convertRowSSE2(const Row &row, const Graphics::PixelFormat &format, LuminanceScale scale);
+#endif
+#ifdef SCUMMVM_AVX2
+	static int convertRowAVX2(const Row &row, const Graphics::PixelFormat &format, LuminanceScale scale);
+#endif
+
+	static void selectRowFunc();
+
+	/** The SIMD row converter, or nullptr to use the lookup tables for everything. */
+	static RowFunc _rowFunc;
+	static bool _rowFuncSelected;
+
+	/** Buffer for the chroma offsets of a row. */
+	Common::Array<int16> _chroma;
+
+	template<typename PixelInt>
+	void convertRows444(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	template<typename PixelInt>
+	void convertRows422(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	template<typename PixelInt>
+	void convertRows420(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+	template<typename PixelInt>
+	void convertRows410(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
+
+	friend class ::YUVToRGBTestSuite;
 };
  /** @} */
 } // End of namespace Graphics
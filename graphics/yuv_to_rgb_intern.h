@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "graphics/yuv_to_rgb.h"
+
+namespace Graphics {
+
+/**
+ * Call Kernel::convert() with template arguments matching the row and the
+ * pixel format, so the inner loops of the SIMD row converters do not need
+ * any branches.
+ */
+template<class Kernel, typename PixelInt, bool subsampled, bool alpha>
+static inline int convertYUVToRGBRow(const YUVToRGBManager::Row &row, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	if (scale == YUVToRGBManager::kScaleITU)
+		return Kernel::template convert<PixelInt, subsampled, alpha, true>(row, format);
+	else
+		return Kernel::template convert<PixelInt, subsampled, alpha, false>(row, format);
+}
+
+template<class Kernel, typename PixelInt>
+static inline int convertYUVToRGBRow(const YUVToRGBManager::Row &row, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	if (row.subsampled) {
+		if (row.aSrc)
+			return convertYUVToRGBRow<Kernel, PixelInt, true, true>(row, format, scale);
+		else
+			return convertYUVToRGBRow<Kernel, PixelInt, true, false>(row, format, scale);
+	} else {
+		if (row.aSrc)
+			return convertYUVToRGBRow<Kernel, PixelInt, false, true>(row, format, scale);
+		else
+			return convertYUVToRGBRow<Kernel, PixelInt, false, false>(row, format, scale);
+	}
+}
+
+template<class Kernel>
+static inline int convertYUVToRGBRow(const YUVToRGBManager::Row &row, const PixelFormat &format, YUVToRGBManager::LuminanceScale scale) {
+	if (format.bytesPerPixel == 2)
+		return convertYUVToRGBRow<Kernel, uint16>(row, format, scale);
+	else
+		return convertYUVToRGBRow<Kernel, uint32>(row, format, scale);
+}
+
+} // End of namespace Graphics
+
+#endif
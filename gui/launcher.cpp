@@ -1656,6 +1656,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// Thumbnails are loaded while the launcher is idle
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
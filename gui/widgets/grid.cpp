@@ -33,6 +33,14 @@
 
 namespace GUI {
 
+enum {
+	// Memory used by the loaded thumbnails before the least recently
+	// visible ones are dropped
+	kThumbnailCacheLimit = 32 * 1024 * 1024,
+	// Time spent loading thumbnails on each GUI tick, in milliseconds
+	kThumbnailLoadBudget = 5
+};
+
 GridItemWidget::GridItemWidget(GridWidget *boss)
 	: ContainerWidget(boss, 0, 0, 0, 0), CommandSender(boss) {
 
@@ -56,6 +64,13 @@ void GridItemWidget::updateThumb() {
 	}
 }
 
+void GridItemWidget::thumbnailLoaded(const Common::String &thumbPath) {
+	if (isVisible() && _activeEntry && _activeEntry->thumbPath == thumbPath) {
+		updateThumb();
+		markAsDirty();
+	}
+}
+
 void GridItemWidget::update() {
 	if (_activeEntry) {
 		updateThumb();
@@ -403,6 +418,11 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
+	setFlags(getFlags() | WIDGET_WANT_TICKLE);
+
+	_thumbnailCacheSize = 0;
+	_thumbnailCacheClock = 0;
+
 	_thumbnailHeight = 0;
 	_thumbnailWidth = 0;
 	_flagIconHeight = 0;
@@ -451,7 +471,7 @@ GridWidget::~GridWidget() {
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
-	unloadSurfaces(_loadedSurfaces);
+	clearThumbnailCache();
 	delete _disabledIconOverlay;
 	_gridItems.clear();
 	_dataEntryList.clear();
@@ -474,12 +494,19 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
 	if (name.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+
+	// Thumbnails which are not loaded yet are drawn as their title
+	Common::HashMap<Common::String, CachedThumbnail>::const_iterator thumb = _thumbnailCache.find(name);
+	if (thumb == _thumbnailCache.end())
+		return nullptr;
+	return thumb->_value.surface.get();
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode, Graphics::AlphaType &alphaType) {
 	if (languageCode == Common::UNK_LANG)
 		return nullptr;
+	if (!_languageIcons.contains(languageCode))
+		loadFlagIcon(languageCode);
 	alphaType = _languageIconsAlpha[languageCode];
 	return _languageIcons[languageCode];
 }
@@ -487,6 +514,8 @@ const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language l
 const Graphics::ManagedSurface *GridWidget::platformToSurface(Common::Platform platformCode, Graphics::AlphaType &alphaType) {
 	if (platformCode == Common::kPlatformUnknown)
 		return nullptr;
+	if (!_platformIcons.contains(platformCode))
+		loadPlatformIcon(platformCode);
 	alphaType = _platformIconsAlpha[platformCode];
 	return _platformIcons[platformCode];
 }
@@ -698,91 +727,164 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 }
 
 void GridWidget::reloadThumbnails() {
-	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
-	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	// Queue the thumbnails of the visible entries, topmost first. Those
+	// of the entries which scrolled out of view are not needed anymore.
+	_thumbnailQueue.clear();
+	_thumbnailCacheClock++;
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					// TODO: Use SharedPtr instead of duplicating the surface
-					Graphics::ManagedSurface *thSurf = new Graphics::ManagedSurface();
-					thSurf->copyFrom(*scSurf);
-					_loadedSurfaces[entry->thumbPath] = thSurf;
-				}
-			}
+		Common::HashMap<Common::String, CachedThumbnail>::iterator thumb = _thumbnailCache.find(entry->thumbPath);
+		if (thumb != _thumbnailCache.end()) {
+			thumb->_value.lastUsed = _thumbnailCacheClock;
+			continue;
+		}
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+		bool queued = false;
+		for (uint i = 0; i < _thumbnailQueue.size() && !queued; ++i)
+			queued = (_thumbnailQueue[i].thumbPath == entry->thumbPath);
 
-				if (path != entry->thumbPath) {
-					// TODO: Use SharedPtr instead of duplicating the surface
-					Graphics::ManagedSurface *thSurf = new Graphics::ManagedSurface();
-					thSurf->copyFrom(*scSurf);
-					_loadedSurfaces[path] = thSurf;
-				}
+		if (!queued) {
+			QueuedThumbnail queuedThumb;
+			queuedThumb.thumbPath = entry->thumbPath;
+			queuedThumb.engineid = entry->engineid;
+			_thumbnailQueue.push_back(queuedThumb);
+		}
+	}
+}
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
+void GridWidget::loadThumbnail(const QueuedThumbnail &thumb) {
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+
+	Common::SharedPtr<const Graphics::ManagedSurface> scSurf;
+	Common::String path = thumb.thumbPath;
+	Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
+	if (!surf) {
+		// Fall back to the engine icon, which is shared by all its games
+		path = Common::String::format("icons/%s.png", thumb.engineid.c_str());
+		Common::HashMap<Common::String, CachedThumbnail>::const_iterator engineThumb = _thumbnailCache.find(path);
+		if (engineThumb != _thumbnailCache.end())
+			scSurf = engineThumb->_value.surface;
+		else
+			surf = loadSurfaceFromFile(path);
+	}
+
+	if (surf) {
+		scSurf = Common::SharedPtr<const Graphics::ManagedSurface>(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
+		if (surf != scSurf.get()) {
+			surf->free();
+			delete surf;
 		}
+
+		if (path != thumb.thumbPath)
+			cacheThumbnail(path, scSurf);
 	}
+
+	cacheThumbnail(thumb.thumbPath, scSurf);
+}
+
+void GridWidget::cacheThumbnail(const Common::String &path, const Common::SharedPtr<const Graphics::ManagedSurface> &surface) {
+	CachedThumbnail &thumb = _thumbnailCache[path];
+	thumb.surface = surface;
+	thumb.lastUsed = _thumbnailCacheClock;
+
+	// Shared surfaces are counted for each of their users, which errs on
+	// the safe side
+	if (surface)
+		_thumbnailCacheSize += surface->pitch * surface->h;
 }
 
-void GridWidget::loadFlagIcons() {
+void GridWidget::trimThumbnailCache() {
+	while (_thumbnailCacheSize > kThumbnailCacheLimit) {
+		// Never drop the thumbnails which are visible right now
+		Common::HashMap<Common::String, CachedThumbnail>::iterator oldest = _thumbnailCache.end();
+		for (Common::HashMap<Common::String, CachedThumbnail>::iterator i = _thumbnailCache.begin(); i != _thumbnailCache.end(); ++i) {
+			if (i->_value.lastUsed != _thumbnailCacheClock && (oldest == _thumbnailCache.end() || i->_value.lastUsed < oldest->_value.lastUsed))
+				oldest = i;
+		}
+
+		if (oldest == _thumbnailCache.end())
+			break;
+
+		if (oldest->_value.surface)
+			_thumbnailCacheSize -= oldest->_value.surface->pitch * oldest->_value.surface->h;
+		_thumbnailCache.erase(oldest);
+	}
+}
+
+void GridWidget::clearThumbnailCache() {
+	_thumbnailCache.clear();
+	_thumbnailCacheSize = 0;
+	_thumbnailQueue.clear();
+}
+
+void GridWidget::handleTickle() {
+	if (_thumbnailQueue.empty())
+		return;
+
+	const uint32 start = g_system->getMillis();
+	do {
+		const QueuedThumbnail thumb = _thumbnailQueue.remove_at(0);
+		if (!_thumbnailCache.contains(thumb.thumbPath))
+			loadThumbnail(thumb);
+
+		for (Common::Array<GridItemWidget *>::iterator i = _gridItems.begin(); i != _gridItems.end(); ++i)
+			(*i)->thumbnailLoaded(thumb.thumbPath);
+	} while (!_thumbnailQueue.empty() && g_system->getMillis() - start < kThumbnailLoadBudget);
+
+	trimThumbnailCache();
+}
+
+void GridWidget::loadFlagIcon(Common::Language languageCode) {
 	const Common::LanguageDescription *l = Common::g_languages;
-	for (; l->code; ++l) {
-		Common::String path = Common::String::format("icons/flags/%s.svg", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path, _flagIconWidth, _flagIconHeight);
-		if (gfx) {
-			_languageIcons[l->id] = gfx;
-			_languageIconsAlpha[l->id] = gfx->detectAlpha();
-			continue;
-		} // if no .svg flag is available, search for a .png
-		path = Common::String::format("icons/flags/%s.png", l->code);
-		gfx = loadSurfaceFromFile(path);
-		if (gfx) {
-			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _flagIconWidth, _flagIconHeight, true);
-			_languageIcons[l->id] = scGfx;
-			_languageIconsAlpha[l->id] = gfx->detectAlpha();
-			if (gfx != scGfx) {
-				gfx->free();
-				delete gfx;
-			}
-		} else {
-			_languageIcons[l->id] = nullptr; // nothing found, set to nullptr
+	while (l->code && l->id != languageCode)
+		++l;
+
+	_languageIcons[languageCode] = nullptr;
+	if (!l->code)
+		return;
+
+	Common::String path = Common::String::format("icons/flags/%s.svg", l->code);
+	Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path, _flagIconWidth, _flagIconHeight);
+	if (gfx) {
+		_languageIcons[l->id] = gfx;
+		_languageIconsAlpha[l->id] = gfx->detectAlpha();
+		return;
+	} // if no .svg flag is available, search for a .png
+	path = Common::String::format("icons/flags/%s.png", l->code);
+	gfx = loadSurfaceFromFile(path);
+	if (gfx) {
+		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _flagIconWidth, _flagIconHeight, true);
+		_languageIcons[l->id] = scGfx;
+		_languageIconsAlpha[l->id] = gfx->detectAlpha();
+		if (gfx != scGfx) {
+			gfx->free();
+			delete gfx;
 		}
 	}
 }
 
-void GridWidget::loadPlatformIcons() {
+void GridWidget::loadPlatformIcon(Common::Platform platformCode) {
 	const Common::PlatformDescription *l = Common::g_platforms;
-	for (; l->code; ++l) {
-		Common::String path = Common::String::format("icons/platforms/%s.png", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path);
-		if (gfx) {
-			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _platformIconWidth, _platformIconHeight, true);
-			_platformIcons[l->id] = scGfx;
-			_platformIconsAlpha[l->id] = scGfx->detectAlpha();
-			if (gfx != scGfx) {
-				gfx->free();
-				delete gfx;
-			}
-		} else {
-			_platformIcons[l->id] = nullptr;
+	while (l->code && l->id != platformCode)
+		++l;
+
+	_platformIcons[platformCode] = nullptr;
+	if (!l->code)
+		return;
+
+	Common::String path = Common::String::format("icons/platforms/%s.png", l->code);
+	Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path);
+	if (gfx) {
+		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _platformIconWidth, _platformIconHeight, true);
+		_platformIcons[l->id] = scGfx;
+		_platformIconsAlpha[l->id] = scGfx->detectAlpha();
+		if (gfx != scGfx) {
+			gfx->free();
+			delete gfx;
 		}
 	}
 }
@@ -1073,14 +1175,13 @@ void GridWidget::reflowLayout() {
 		unloadSurfaces(_extraIcons);
 		unloadSurfaces(_platformIcons);
 		unloadSurfaces(_languageIcons);
-		unloadSurfaces(_loadedSurfaces);
+		clearThumbnailCache();
 		_platformIconsAlpha.clear();
 		_languageIconsAlpha.clear();
 		_extraIconsAlpha.clear();
 		delete _disabledIconOverlay;
+		// Flags and platform icons are loaded when first drawn
 		reloadThumbnails();
-		loadFlagIcons();
-		loadPlatformIcons();
 		loadExtraIcons();
 
 		Graphics::ManagedSurface *gfx = new Graphics::ManagedSurface(_thumbnailWidth, _thumbnailHeight, g_system->getOverlayFormat());
@@ -24,6 +24,7 @@
 
 #include "gui/dialog.h"
 #include "gui/widgets/scrollbar.h"
+#include "common/ptr.h"
 #include "common/str.h"
 
 #include "image/bmp.h"
@@ -106,8 +107,27 @@ protected:
 	Common::HashMap<int, Graphics::AlphaType> _languageIconsAlpha;
 	Common::HashMap<int, Graphics::AlphaType> _extraIconsAlpha;
 	Graphics::ManagedSurface *_disabledIconOverlay;
-	// Images are mapped by filename -> surface.
-	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+
+	/** A loaded thumbnail, without surface if the game has no icon. */
+	struct CachedThumbnail {
+		Common::SharedPtr<const Graphics::ManagedSurface> surface;
+		uint32 lastUsed;
+	};
+
+	/** A thumbnail of a visible entry, waiting to be loaded. */
+	struct QueuedThumbnail {
+		Common::String thumbPath;
+		Common::String engineid;
+	};
+
+	// Images are mapped by filename -> surface. The least recently visible
+	// ones are dropped when the cache grows too big.
+	Common::HashMap<Common::String, CachedThumbnail> _thumbnailCache;
+	uint32 _thumbnailCacheSize;
+	uint32 _thumbnailCacheClock;
+	// Thumbnails are loaded a few at a time while the GUI is idle, the
+	// topmost visible entries first.
+	Common::Array<QueuedThumbnail> _thumbnailQueue;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -198,8 +218,12 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
-	void loadFlagIcons();
-	void loadPlatformIcons();
+	void loadThumbnail(const QueuedThumbnail &thumb);
+	void cacheThumbnail(const Common::String &path, const Common::SharedPtr<const Graphics::ManagedSurface> &surface);
+	void trimThumbnailCache();
+	void clearThumbnailCache();
+	void loadFlagIcon(Common::Language languageCode);
+	void loadPlatformIcon(Common::Platform platformCode);
 	void loadExtraIcons();
 
 	void destroyItems();
@@ -219,6 +243,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -246,6 +271,7 @@ public:
 	void move(int x, int y);
 	void update();
 	void updateThumb();
+	void thumbnailLoaded(const Common::String &thumbPath);
 	void setActiveEntry(GridItemInfo &entry);
 
 	void drawWidget() override;
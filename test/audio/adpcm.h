@@ -0,0 +1,95 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/adpcm.h"
+
+#include "common/memstream.h"
+
+class ADPCMStreamTestSuite : public CxxTest::TestSuite {
+private:
+	/**
+	 * Create pseudo-random ADPCM data with valid block headers. The last
+	 * block is cut short to check the handling of partial blocks.
+	 */
+	static byte *createData(Audio::ADPCMType type, int channels, uint32 blockAlign, int blocks, uint32 &size) {
+		size = blockAlign * blocks - blockAlign / 3;
+		byte *data = (byte *)malloc(size);
+
+		uint32 seed = 12345;
+		for (uint32 i = 0; i < size; i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (byte)(seed >> 16);
+		}
+
+		for (uint32 block = 0; block < size; block += blockAlign) {
+			byte *header = data + block;
+			for (int i = 0; i < channels; i++) {
+				if (type == Audio::kADPCMMSIma) {
+					// The step index is a 16-bit value
+					header[i * 4 + 2] %= 89;
+					header[i * 4 + 3] = 0;
+				} else {
+					header[i] %= 7;
+					// Keep idelta positive and reasonably small
+					header[channels + i * 2 + 1] &= 0x0F;
+				}
+			}
+		}
+
+		return data;
+	}
+
+	static Audio::SeekableAudioStream *createStream(const byte *data, uint32 size, Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		return Audio::makeADPCMStream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES, size, type, 22050, channels, blockAlign);
+	}
+
+	static int readAll(Audio::AudioStream *stream, int16 *buffer, int capacity, int chunk) {
+		int total = 0;
+		while (!stream->endOfData() && total < capacity) {
+			int samples = stream->readBuffer(buffer + total, MIN(chunk, capacity - total));
+			if (samples <= 0)
+				break;
+			total += samples;
+		}
+		return total;
+	}
+
+	void checkChunkedReads(Audio::ADPCMType type, int channels, uint32 blockAlign) {
+		uint32 size;
+		byte *data = createData(type, channels, blockAlign, 8, size);
+
+		Audio::SeekableAudioStream *stream = createStream(data, size, type, channels, blockAlign);
+		TS_ASSERT(stream->getPreferredBlockSize() > 0);
+		TS_ASSERT_EQUALS(stream->getPreferredBlockSize() % channels, 0);
+
+		const int capacity = blockAlign * 8 * 2;
+		int16 *reference = new int16[capacity];
+		int16 *buffer = new int16[capacity];
+		const int total = readAll(stream, reference, capacity, capacity);
+		TS_ASSERT(total > 0);
+		TS_ASSERT(stream->endOfData());
+
+		static const int chunks[] = { 2, 6, 64, 1000, 4096 };
+		for (int i = 0; i < ARRAYSIZE(chunks); i++) {
+			TS_ASSERT(stream->rewind());
+			TS_ASSERT_EQUALS(readAll(stream, buffer, capacity, chunks[i]), total);
+			TS_ASSERT_EQUALS(memcmp(reference, buffer, total * sizeof(int16)), 0);
+		}
+
+		delete[] buffer;
+		delete[] reference;
+		delete stream;
+		free(data);
+	}
+
+public:
+	void test_ms_ima_chunked_reads() {
+		checkChunkedReads(Audio::kADPCMMSIma, 1, 512);
+		checkChunkedReads(Audio::kADPCMMSIma, 2, 1024);
+	}
+
+	void test_ms_chunked_reads() {
+		checkChunkedReads(Audio::kADPCMMS, 1, 512);
+		checkChunkedReads(Audio::kADPCMMS, 2, 1024);
+	}
+};
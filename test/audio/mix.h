@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "audio/mix/mix.h"
+
+class SampleMixerTestSuite : public CxxTest::TestSuite {
+private:
+	uint32 _seed;
+
+	int16 nextSample() {
+		_seed = _seed * 1103515245 + 12345;
+		switch ((_seed >> 8) & 15) {
+		case 0:
+			return -32768;
+		case 1:
+			return 32767;
+		case 2:
+			return 0;
+		default:
+			return (int16)(_seed >> 16);
+		}
+	}
+
+	void compareWithGeneric(Audio::SampleMixer::MixFunc func, bool inStereo, bool outStereo, bool reverseStereo) {
+		static const Audio::st_volume_t volumes[][2] = {
+			{ 256, 256 }, { 255, 255 }, { 0, 0 }, { 128, 256 }, { 256, 1 }, { 37, 201 }, { 200, 0 }
+		};
+
+		for (uint v = 0; v < ARRAYSIZE(volumes); v++) {
+			// Odd lengths exercise the scalar tail of the SIMD kernels
+			for (uint numFrames = 0; numFrames <= 67; numFrames += 7) {
+				const uint inSamples = numFrames * (inStereo ? 2 : 1);
+				const uint outSamples = numFrames * (outStereo ? 2 : 1);
+
+				int16 *src = new int16[inSamples + 1];
+				int16 *dstGeneric = new int16[outSamples + 1];
+				int16 *dstSIMD = new int16[outSamples + 1];
+
+				for (uint i = 0; i < inSamples; i++)
+					src[i] = nextSample();
+				for (uint i = 0; i < outSamples; i++)
+					dstGeneric[i] = dstSIMD[i] = nextSample();
+
+				Audio::SampleMixer::mixGeneric(dstGeneric, src, numFrames, volumes[v][0], volumes[v][1], inStereo, outStereo, reverseStereo);
+				func(dstSIMD, src, numFrames, volumes[v][0], volumes[v][1], inStereo, outStereo, reverseStereo);
+
+				TS_ASSERT_EQUALS(memcmp(dstGeneric, dstSIMD, outSamples * sizeof(int16)), 0);
+
+				delete[] src;
+				delete[] dstGeneric;
+				delete[] dstSIMD;
+			}
+		}
+	}
+
+	void compareAllModes(Audio::SampleMixer::MixFunc func) {
+		compareWithGeneric(func, true, true, false);
+		compareWithGeneric(func, true, true, true);
+		compareWithGeneric(func, true, false, false);
+		compareWithGeneric(func, false, true, false);
+		compareWithGeneric(func, false, false, false);
+	}
+
+	void compareDotProduct(Audio::SampleMixer::DotProductFunc func) {
+		int16 samples[64], coefs[64];
+		for (uint i = 0; i < ARRAYSIZE(samples); i++) {
+			samples[i] = nextSample();
+			coefs[i] = (int16)(nextSample() / 2);
+		}
+
+		for (uint numTaps = 16; numTaps <= ARRAYSIZE(samples); numTaps += 16)
+			TS_ASSERT_EQUALS(func(samples, coefs, numTaps), Audio::SampleMixer::dotProductGeneric(samples, coefs, numTaps));
+	}
+
+public:
+	void setUp() {
+		_seed = 0x1234;
+	}
+
+	void test_mix_generic() {
+		int16 src[4] = { 1000, -1000, 32767, -32768 };
+		int16 dst[4] = { 0, 0, 32000, -32000 };
+
+		Audio::SampleMixer::mixGeneric(dst, src, 2, 128, 256, true, true, false);
+		TS_ASSERT_EQUALS(dst[0], 500);
+		TS_ASSERT_EQUALS(dst[1], -1000);
+		TS_ASSERT_EQUALS(dst[2], 32767);
+		TS_ASSERT_EQUALS(dst[3], -32768);
+	}
+
+	void test_mix_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareAllModes(Audio::SampleMixer::mixSSE2);
+		if (instrset_detect() >= 2)
+			compareDotProduct(Audio::SampleMixer::dotProductSSE2);
+#endif
+	}
+
+	void test_mix_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareAllModes(Audio::SampleMixer::mixAVX2);
+		if (instrset_detect() >= 8)
+			compareDotProduct(Audio::SampleMixer::dotProductAVX2);
+#endif
+	}
+
+	void test_mix_neon() {
+#ifdef SCUMMVM_NEON
+		compareAllModes(Audio::SampleMixer::mixNEON);
+		compareDotProduct(Audio::SampleMixer::dotProductNEON);
+#endif
+	}
+};
@@ -0,0 +1,88 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/prefetchstream.h"
+
+#include "helper.h"
+
+class PrefetchingAudioStreamTestSuite : public CxxTest::TestSuite
+{
+private:
+	void readTestTemplate(bool isStereo, bool prefetch) {
+		const int sampleRate = 11025;
+		const int time = 2;
+		const int totalSamples = sampleRate * time * (isStereo ? 2 : 1);
+
+		int16 *sine;
+		Audio::SeekableAudioStream *s = Audio::makePrefetchingAudioStream(createSineStream<int16>(sampleRate, time, &sine, false, isStereo), DisposeAfterUse::YES, 100);
+
+		// Read in odd sized chunks, so reads cross the ring buffer boundary
+		int16 *buffer = new int16[totalSamples];
+		const int chunk = isStereo ? 334 : 167;
+		int samples = 0;
+		while (samples < totalSamples) {
+			if (prefetch) {
+				((Audio::PrefetchingAudioStream *)s)->prefetch();
+				TS_ASSERT(((Audio::PrefetchingAudioStream *)s)->getPrefetchedSamples() > 0);
+			}
+
+			const int read = s->readBuffer(buffer + samples, MIN(chunk, totalSamples - samples));
+			TS_ASSERT(read > 0);
+			if (read <= 0)
+				break;
+			samples += read;
+		}
+
+		TS_ASSERT_EQUALS(samples, totalSamples);
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, sizeof(int16) * totalSamples), 0);
+		TS_ASSERT(s->endOfData());
+
+		delete[] sine;
+		delete[] buffer;
+		delete s;
+	}
+
+public:
+	void test_read_without_prefetch() {
+		readTestTemplate(false, false);
+		readTestTemplate(true, false);
+	}
+
+	void test_read_with_prefetch() {
+		readTestTemplate(false, true);
+		readTestTemplate(true, true);
+	}
+
+	void test_seek_flushes_ring() {
+		const int sampleRate = 11025;
+
+		int16 *sine;
+		Audio::PrefetchingAudioStream *s = new Audio::PrefetchingAudioStream(createSineStream<int16>(sampleRate, 2, &sine, false, true), DisposeAfterUse::YES, 100);
+
+		int16 buffer[64];
+		s->prefetch();
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, ARRAYSIZE(buffer)), ARRAYSIZE(buffer));
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, sizeof(buffer)), 0);
+
+		// Seeking must drop the samples decoded ahead
+		TS_ASSERT(s->seek(Audio::Timestamp(1000, sampleRate)));
+		TS_ASSERT_EQUALS(s->getPrefetchedSamples(), 0);
+		s->prefetch();
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, ARRAYSIZE(buffer)), ARRAYSIZE(buffer));
+		TS_ASSERT_EQUALS(memcmp(sine + sampleRate * 2, buffer, sizeof(buffer)), 0);
+
+		TS_ASSERT(s->rewind());
+		TS_ASSERT(!s->endOfData());
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, ARRAYSIZE(buffer)), ARRAYSIZE(buffer));
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, sizeof(buffer)), 0);
+
+		// Seeking past the end leaves nothing to read
+		s->seek(Audio::Timestamp(5000, sampleRate));
+		s->prefetch();
+		TS_ASSERT(s->endOfData());
+		TS_ASSERT_EQUALS(s->readBuffer(buffer, ARRAYSIZE(buffer)), 0);
+
+		delete[] sine;
+		delete s;
+	}
+};
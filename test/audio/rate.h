@@ -0,0 +1,258 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/mix/mix.h"
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/raw.h"
+
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "../null_osystem.h"
+
+#include <math.h>
+
+class RateConverterTestSuite : public CxxTest::TestSuite {
+private:
+	static Audio::AudioStream *createStream(int rate, int frames, bool stereo, double freq, int amplitude) {
+		const int samples = frames * (stereo ? 2 : 1);
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+
+		for (int i = 0; i < frames; i++) {
+			int16 value = (int16)(sin(2 * M_PI * freq * i / rate) * amplitude);
+			if (freq == 0.0)
+				value = amplitude;
+			data[i * (stereo ? 2 : 1)] = value;
+			if (stereo)
+				data[i * 2 + 1] = -value;
+		}
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0));
+	}
+
+	// Converts the whole stream in small chunks, like the mixer does
+	static int convertAll(Audio::RateConverter *converter, Audio::AudioStream *stream, int16 *out, int maxFrames, bool outStereo) {
+		int total = 0;
+		while (total < maxFrames) {
+			int chunk = MIN(maxFrames - total, 333);
+			if (stream->endOfData() && !converter->needsDraining())
+				break;
+			int converted = converter->convert(*stream, out + total * (outStereo ? 2 : 1), chunk, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			total += converted;
+			if (converted == 0)
+				break;
+		}
+		return total;
+	}
+
+	void checkLength(Audio::RateConverterType type, int inRate, int outRate, bool stereo) {
+		const int inFrames = inRate / 2;
+		const int expected = (int)((int64)inFrames * outRate / inRate);
+		const int maxFrames = expected + 64;
+
+		Audio::AudioStream *stream = createStream(inRate, inFrames, stereo, 440.0, 10000);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, true, false, type);
+		int16 *out = new int16[maxFrames * 2]();
+
+		int frames = convertAll(converter, stream, out, maxFrames, true);
+		Common::String message = Common::String::format("type %d, %d -> %d Hz, got %d frames instead of %d", type, inRate, outRate, frames, expected);
+		// The linear converter works with a fixed point step, so allow a slight drift
+		TSM_ASSERT_LESS_THAN_EQUALS(message.c_str(), ABS(frames - expected), expected / 2000 + 2);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+	}
+
+public:
+	void setUp() {
+		// Selecting the SIMD kernels requires a fully initialized backend
+		Audio::SampleMixer::mixFunc = Audio::SampleMixer::mixGeneric;
+		Audio::SampleMixer::dotProductFunc = Audio::SampleMixer::dotProductGeneric;
+	}
+
+	void test_parse_type() {
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType("polyphase"), Audio::kRateConverterPolyphase);
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType("linear"), Audio::kRateConverterLinear);
+		TS_ASSERT_EQUALS(Audio::parseRateConverterType("bogus"), Audio::kRateConverterLinear);
+	}
+
+	void test_output_length() {
+		checkLength(Audio::kRateConverterLinear, 22050, 44100, false);
+		checkLength(Audio::kRateConverterLinear, 11025, 48000, true);
+		checkLength(Audio::kRateConverterPolyphase, 22050, 44100, false);
+		checkLength(Audio::kRateConverterPolyphase, 11025, 48000, true);
+		checkLength(Audio::kRateConverterPolyphase, 44100, 22050, true);
+		checkLength(Audio::kRateConverterPolyphase, 48000, 11025, false);
+		checkLength(Audio::kRateConverterPolyphase, 22050, 22050, true);
+		// Does not reduce to a small number of phases
+		checkLength(Audio::kRateConverterPolyphase, 23153, 48000, false);
+	}
+
+	void test_polyphase_dc() {
+		const int frames = 4000;
+		Audio::AudioStream *stream = createStream(11025, frames, false, 0.0, 12345);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 48000, false, false, false, Audio::kRateConverterPolyphase);
+		int16 *out = new int16[frames * 8]();
+
+		int converted = convertAll(converter, stream, out, frames * 4, false);
+		for (int i = 100; i < converted - 100; i++)
+			TS_ASSERT_EQUALS(out[i], 12345);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+	}
+
+	void test_polyphase_sine() {
+		const int inRate = 22050, outRate = 48000;
+		const int frames = 8000;
+		const double freq = 1000.0;
+		Audio::AudioStream *stream = createStream(inRate, frames, true, freq, 16000);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, true, true, false, Audio::kRateConverterPolyphase);
+		int16 *out = new int16[frames * 6]();
+
+		int converted = convertAll(converter, stream, out, frames * 2, true);
+		double maxError = 0.0;
+		for (int i = 100; i < converted - 100; i++) {
+			double expected = sin(2 * M_PI * freq * i / outRate) * 16000;
+			maxError = MAX(maxError, fabs(out[i * 2] - expected));
+			maxError = MAX(maxError, fabs(out[i * 2 + 1] + expected));
+		}
+		// The filter should be flat and phase exact well below its cutoff
+		TS_ASSERT_LESS_THAN(maxError, 40.0);
+
+		delete[] out;
+		delete converter;
+		delete stream;
+	}
+
+	void test_throughput() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+#ifdef SCUMMVM_NEON
+		Audio::SampleMixer::mixFunc = Audio::SampleMixer::mixNEON;
+		Audio::SampleMixer::dotProductFunc = Audio::SampleMixer::dotProductNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			Audio::SampleMixer::mixFunc = Audio::SampleMixer::mixSSE2;
+			Audio::SampleMixer::dotProductFunc = Audio::SampleMixer::dotProductSSE2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			Audio::SampleMixer::mixFunc = Audio::SampleMixer::mixAVX2;
+			Audio::SampleMixer::dotProductFunc = Audio::SampleMixer::dotProductAVX2;
+		}
+#endif
+
+		static const struct {
+			int inRate;
+			int outRate;
+		} ratios[] = { { 11025, 48000 }, { 22050, 44100 }, { 22050, 48000 }, { 44100, 48000 }, { 48000, 48000 } };
+		static const char *const names[] = { "linear", "polyphase" };
+
+#ifdef SLOW_TESTS
+		const int seconds = 60;
+#else
+		const int seconds = 1;
+#endif
+		const int chunk = 1024;
+		int16 *out = new int16[chunk * 2];
+
+		for (int r = 0; r < ARRAYSIZE(ratios); r++) {
+			for (int type = Audio::kRateConverterLinear; type <= Audio::kRateConverterPolyphase; type++) {
+				const int inFrames = ratios[r].inRate * seconds;
+				Audio::AudioStream *stream = createStream(ratios[r].inRate, inFrames, true, 440.0, 10000);
+				Audio::RateConverter *converter = Audio::makeRateConverter(ratios[r].inRate, ratios[r].outRate, true, true, false, (Audio::RateConverterType)type);
+
+				uint32 start = g_system->getMillis();
+				int total = 0;
+				while (!stream->endOfData() || converter->needsDraining()) {
+					memset(out, 0, chunk * 2 * sizeof(int16));
+					int converted = converter->convert(*stream, out, chunk, 200, 200);
+					if (converted == 0)
+						break;
+					total += converted;
+				}
+				uint32 time = g_system->getMillis() - start;
+
+				debug("%s %d -> %d Hz: %d frames in %d ms", names[type], ratios[r].inRate, ratios[r].outRate, total, time);
+
+				delete converter;
+				delete stream;
+			}
+		}
+
+		delete[] out;
+#endif
+	}
+
+	void test_adpcm_throughput() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Audio::SampleMixer::mixFunc = Audio::SampleMixer::mixGeneric;
+		Audio::SampleMixer::dotProductFunc = Audio::SampleMixer::dotProductGeneric;
+
+#ifdef SLOW_TESTS
+		const int blocks = 2048;
+#else
+		const int blocks = 64;
+#endif
+		// Many block-based streams mixed at once, as with game sound effects
+		const int numStreams = 32;
+		const uint32 blockAlign = 1024;
+		const uint32 size = blockAlign * blocks;
+		const int chunk = 1024;
+
+		static const Audio::ADPCMType types[] = { Audio::kADPCMMSIma, Audio::kADPCMMS };
+		static const char *const names[] = { "MS IMA", "MS" };
+
+		// Silence is valid ADPCM data, and is decoded as fast as anything else
+		byte *data = (byte *)calloc(size, 1);
+		int16 *out = new int16[chunk * 2];
+
+		for (int t = 0; t < ARRAYSIZE(types); t++) {
+			Audio::AudioStream *streams[numStreams];
+			Audio::RateConverter *converters[numStreams];
+			for (int i = 0; i < numStreams; i++) {
+				streams[i] = Audio::makeADPCMStream(new Common::MemoryReadStream(data, size), DisposeAfterUse::YES, size, types[t], 22050, 2, blockAlign);
+				converters[i] = Audio::makeRateConverter(22050, 44100, true, true, false);
+			}
+
+			uint32 start = g_system->getMillis();
+			int total = 0;
+			bool active = true;
+			while (active) {
+				active = false;
+				memset(out, 0, chunk * 2 * sizeof(int16));
+				for (int i = 0; i < numStreams; i++) {
+					int converted = converters[i]->convert(*streams[i], out, chunk, 50, 50);
+					if (converted > 0)
+						active = true;
+					total += converted;
+				}
+			}
+			uint32 time = g_system->getMillis() - start;
+
+			debug("%s ADPCM: %d streams, %d frames in %d ms", names[t], numStreams, total, time);
+
+			for (int i = 0; i < numStreams; i++) {
+				delete converters[i];
+				delete streams[i];
+			}
+		}
+
+		delete[] out;
+		free(data);
+#endif
+	}
+};
@@ -0,0 +1,256 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/saves/default/default-saves.h"
+
+#include "common/config-manager.h"
+#include "common/fs.h"
+#include "common/ptr.h"
+
+#include "../null_osystem.h"
+
+class DefaultSavesTestSuite : public CxxTest::TestSuite {
+private:
+	/** Collects whatever is written to it, and can be made to fail. */
+	class RecordingWriteStream : public Common::WriteStream {
+	public:
+		RecordingWriteStream(Common::Array<byte> &data, bool fail) : _data(data), _fail(fail) {}
+
+		uint32 write(const void *dataPtr, uint32 dataSize) override {
+			const byte *bytes = (const byte *)dataPtr;
+			for (uint32 i = 0; i < dataSize; i++)
+				_data.push_back(bytes[i]);
+			return dataSize;
+		}
+
+		bool err() const override { return _fail; }
+		int64 pos() const override { return _data.size(); }
+
+	private:
+		Common::Array<byte> &_data;
+		bool _fail;
+	};
+
+	static const uint32 kDataSize = 64 * 1024 + 77;
+
+	static byte expectedByte(uint32 pos) {
+		// Compressible, yet not trivially so
+		return (byte)("Saved game data "[pos % 16] + ((pos * 2654435761U) >> 29));
+	}
+
+	static byte *makeData() {
+		byte *data = (byte *)malloc(kDataSize);
+		for (uint32 i = 0; i < kDataSize; i++)
+			data[i] = expectedByte(i);
+		return data;
+	}
+
+	static bool checkData(const Common::Array<byte> &data) {
+		if (data.size() != kDataSize)
+			return false;
+		for (uint32 i = 0; i < kDataSize; i++) {
+			if (data[i] != expectedByte(i))
+				return false;
+		}
+		return true;
+	}
+
+	static Common::Path savePath() {
+		return Common::Path("test-saves");
+	}
+
+	/** Set up the save file manager of the null backend, writing to a scratch directory. */
+	static DefaultSaveFileManager *createManager(bool asyncSaves, int compressionLevel = -1) {
+		Common::install_null_g_system();
+
+		ConfMan.registerDefault("async_saves", true);
+		ConfMan.registerDefault("save_compression_level", -1);
+		ConfMan.setBool("async_saves", asyncSaves, Common::ConfigManager::kTransientDomain);
+		ConfMan.setInt("save_compression_level", compressionLevel, Common::ConfigManager::kTransientDomain);
+		ConfMan.setPath("savepath", savePath(), Common::ConfigManager::kTransientDomain);
+
+		return (DefaultSaveFileManager *)g_system->getSavefileManager();
+	}
+
+	static void destroyManager(DefaultSaveFileManager *manager) {
+		manager->waitForPendingSaves();
+
+		// Also gets rid of the files written for the cloud sync
+		Common::FSNode dir(savePath());
+		Common::FSList files;
+		if (dir.getChildren(files, Common::FSNode::kListFilesOnly)) {
+			for (Common::FSList::const_iterator i = files.begin(); i != files.end(); ++i)
+				manager->removeFile(*i);
+		}
+		manager->removeFile(dir);
+
+		ConfMan.removeKey("async_saves", Common::ConfigManager::kTransientDomain);
+		ConfMan.removeKey("save_compression_level", Common::ConfigManager::kTransientDomain);
+		ConfMan.removeKey("savepath", Common::ConfigManager::kTransientDomain);
+	}
+
+	static bool writeSave(DefaultSaveFileManager *manager, const Common::String &filename) {
+		Common::OutSaveFile *saveFile = manager->openForSaving(filename);
+		if (!saveFile)
+			return false;
+
+		byte *data = makeData();
+		saveFile->write(data, kDataSize);
+		free(data);
+
+		saveFile->finalize();
+		const bool result = !saveFile->err();
+		delete saveFile;
+		return result;
+	}
+
+	static bool readSave(DefaultSaveFileManager *manager, const Common::String &filename) {
+		Common::ScopedPtr<Common::InSaveFile> saveFile(manager->openForLoading(filename));
+		if (!saveFile)
+			return false;
+
+		Common::Array<byte> data;
+		data.resize(kDataSize + 1);
+		data.resize(saveFile->read(data.data(), kDataSize + 1));
+		return checkData(data);
+	}
+
+	static int64 saveSize(const Common::String &filename) {
+		int64 size, mtime;
+		if (!Common::FSNode(savePath().join(filename)).getFileInfo(size, mtime))
+			return -1;
+		return size;
+	}
+
+public:
+	void test_queue() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DefaultSaveFileManager *manager = createManager(true);
+
+		Common::Array<byte> first, second;
+		const Common::FSNode node(savePath().join("queued"));
+		Common::SharedPtr<bool> firstFailed = manager->queueSave(node, new RecordingWriteStream(first, false), makeData(), kDataSize);
+		Common::SharedPtr<bool> secondFailed = manager->queueSave(node, new RecordingWriteStream(second, false), makeData(), kDataSize);
+
+		// Nothing is written before the timer runs
+		TS_ASSERT(manager->hasPendingSaves());
+		TS_ASSERT(first.empty());
+		TS_ASSERT(second.empty());
+
+		// The timer writes a bit of the first save at a time
+		DefaultSaveFileManager::pendingSavesTimerProc(manager);
+		TS_ASSERT(!first.empty());
+		TS_ASSERT_LESS_THAN(first.size(), kDataSize);
+		TS_ASSERT(second.empty());
+
+		manager->waitForPendingSaves();
+		TS_ASSERT(!manager->hasPendingSaves());
+		TS_ASSERT(checkData(first));
+		TS_ASSERT(checkData(second));
+		TS_ASSERT(!*firstFailed);
+		TS_ASSERT(!*secondFailed);
+
+		destroyManager(manager);
+#endif
+	}
+
+	void test_timer_proc() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DefaultSaveFileManager *manager = createManager(true);
+
+		Common::Array<byte> data;
+		Common::SharedPtr<bool> failed = manager->queueSave(Common::FSNode(savePath().join("timer")), new RecordingWriteStream(data, false), makeData(), kDataSize);
+		TS_ASSERT(manager->_pendingSavesTimerInstalled);
+
+		// Each call makes progress, until the save is done
+		uint32 calls = 0;
+		while (manager->hasPendingSaves() && calls < kDataSize) {
+			const uint32 written = data.size();
+			DefaultSaveFileManager::pendingSavesTimerProc(manager);
+			TS_ASSERT(data.size() > written || !manager->hasPendingSaves());
+			calls++;
+		}
+		TS_ASSERT(!manager->hasPendingSaves());
+		TS_ASSERT_LESS_THAN(1U, calls);
+		TS_ASSERT(checkData(data));
+		TS_ASSERT(!*failed);
+
+		// Nothing left to do
+		DefaultSaveFileManager::pendingSavesTimerProc(manager);
+
+		destroyManager(manager);
+#endif
+	}
+
+	void test_failed_save() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DefaultSaveFileManager *manager = createManager(true);
+
+		Common::Array<byte> data;
+		Common::SharedPtr<bool> failed = manager->queueSave(Common::FSNode(savePath().join("failing")), new RecordingWriteStream(data, true), makeData(), kDataSize);
+
+		// The failure only shows once the save was written
+		TS_ASSERT(!*failed);
+		while (manager->hasPendingSaves())
+			DefaultSaveFileManager::pendingSavesTimerProc(manager);
+		TS_ASSERT(*failed);
+
+		destroyManager(manager);
+#endif
+	}
+
+	void test_async_saves() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DefaultSaveFileManager *manager = createManager(true);
+
+		// Finalizing and checking for errors must not wait for the write
+		TS_ASSERT(writeSave(manager, "async.s00"));
+		TS_ASSERT(manager->hasPendingSaves());
+
+		while (manager->hasPendingSaves())
+			DefaultSaveFileManager::pendingSavesTimerProc(manager);
+		TS_ASSERT(readSave(manager, "async.s00"));
+
+		// Loading waits for pending saves by itself
+		TS_ASSERT(writeSave(manager, "async.s01"));
+		TS_ASSERT(manager->hasPendingSaves());
+		TS_ASSERT(readSave(manager, "async.s01"));
+		TS_ASSERT(!manager->hasPendingSaves());
+
+		destroyManager(manager);
+#endif
+	}
+
+	void test_sync_saves() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DefaultSaveFileManager *manager = createManager(false);
+
+		TS_ASSERT(writeSave(manager, "sync.s00"));
+		TS_ASSERT(!manager->hasPendingSaves());
+		TS_ASSERT(readSave(manager, "sync.s00"));
+
+		destroyManager(manager);
+#endif
+	}
+
+	void test_compression_level() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_ZLIB)
+		DefaultSaveFileManager *manager = createManager(true, 1);
+		TS_ASSERT(writeSave(manager, "fast.s00"));
+		manager->waitForPendingSaves();
+		TS_ASSERT(readSave(manager, "fast.s00"));
+		const int64 fastSize = saveSize("fast.s00");
+
+		ConfMan.setInt("save_compression_level", 9, Common::ConfigManager::kTransientDomain);
+		TS_ASSERT(writeSave(manager, "best.s00"));
+		manager->waitForPendingSaves();
+		TS_ASSERT(readSave(manager, "best.s00"));
+		const int64 bestSize = saveSize("best.s00");
+
+		TS_ASSERT_LESS_THAN(0, bestSize);
+		TS_ASSERT_LESS_THAN(bestSize, fastSize);
+		TS_ASSERT_LESS_THAN(fastSize, (int64)kDataSize);
+
+		destroyManager(manager);
+#endif
+	}
+};
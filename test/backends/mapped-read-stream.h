@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+
+#include "../null_osystem.h"
+
+class MappedReadStreamTestSuite : public CxxTest::TestSuite {
+private:
+	static const uint32 kFileSize = 300 * 1024;
+
+	static byte expectedByte(uint32 pos) {
+		return (byte)(pos ^ (pos >> 9));
+	}
+
+	static Common::FSNode writeFile() {
+		Common::FSNode node("test-mapped-read-stream.bin");
+		Common::ScopedPtr<Common::SeekableWriteStream> out(node.createWriteStream());
+		if (!out)
+			return node;
+
+		for (uint32 pos = 0; pos < kFileSize; pos++)
+			out->writeByte(expectedByte(pos));
+		out->finalize();
+		return Common::FSNode(node.getPath());
+	}
+
+	static void removeFile(const Common::FSNode &node) {
+		remove(node.getPath().toString(Common::Path::kNativeSeparator).c_str());
+	}
+
+public:
+	void test_plain_read_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::FSNode node = writeFile();
+
+		// Files may be truncated behind our back, so they are not mapped by default
+		Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT_EQUALS(stream->size(), (int64)kFileSize);
+			TS_ASSERT(!stream->borrowData(1024));
+		}
+
+		stream.reset();
+		removeFile(node);
+#endif
+	}
+
+	void test_mapped_read_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::FSNode node = writeFile();
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(node.createMappedReadStream());
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT_EQUALS(stream->size(), (int64)kFileSize);
+			TS_ASSERT(stream->seek(1000));
+
+			Common::SharedPtr<byte> data = stream->borrowData(1024);
+#ifdef HAS_MMAP
+			TS_ASSERT(data);
+			TS_ASSERT_EQUALS(stream->pos(), 2024);
+#endif
+			if (data) {
+				for (uint32 i = 0; i < 1024; i++) {
+					if (data.get()[i] != expectedByte(1000 + i)) {
+						TS_FAIL(Common::String::format("Mismatch at offset %u", 1000 + i).c_str());
+						break;
+					}
+				}
+			} else {
+				// Without mapping, the stream is the same as a plain one
+				TS_ASSERT_EQUALS(stream->pos(), 1000);
+				TS_ASSERT_EQUALS(stream->readByte(), expectedByte(1000));
+			}
+		}
+
+		stream.reset();
+		removeFile(node);
+#endif
+	}
+};
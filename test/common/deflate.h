@@ -0,0 +1,303 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/compression/deflate.h"
+#include "common/compression/unzip.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+class DeflateTestSuite : public CxxTest::TestSuite {
+private:
+	static const uint32 kDataSize = 3 * 1024 * 1024 + 1234;
+
+	static byte expectedByte(uint32 pos) {
+		// Compressible, yet never repeating exactly
+		return (byte)((pos / 7) ^ (pos >> 13) ^ (pos * 31 >> 17));
+	}
+
+	static void compress(Common::MemoryWriteStreamDynamic &dst) {
+		Common::MemoryWriteStreamDynamic *inner = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(inner);
+
+		byte buf[4096];
+		for (uint32 pos = 0; pos < kDataSize; pos += sizeof(buf)) {
+			uint32 len = MIN<uint32>(sizeof(buf), kDataSize - pos);
+			for (uint32 i = 0; i < len; i++)
+				buf[i] = expectedByte(pos + i);
+			gzip->write(buf, len);
+		}
+		gzip->finalize();
+
+		// The compressing stream owns the one it wraps, if it wrapped it at all
+		dst.write(inner->getData(), inner->size());
+		delete gzip;
+	}
+
+	/**
+	 * Build a zlib stream by hand, made of deflate blocks with fixed Huffman
+	 * codes holding literals only, so it does not depend on zlib being there.
+	 */
+	static void deflateLiterals(Common::MemoryWriteStreamDynamic &dst) {
+		uint32 bitBuf = 0;
+		int bitCount = 0;
+
+		// zlib header without a preset dictionary
+		dst.writeByte(0x78);
+		dst.writeByte(0x01);
+
+		uint32 adlerA = 1, adlerB = 0;
+		const uint32 blockSize = 100000;
+		for (uint32 pos = 0; pos < kDataSize; pos++) {
+			uint32 code, length;
+			if (pos % blockSize == 0) {
+				// Block header: final flag, then type 1
+				code = ((pos + blockSize >= kDataSize) ? 1 : 0) | (1 << 1);
+				length = 3;
+			} else {
+				code = 0;
+				length = 0;
+			}
+			bitBuf |= code << bitCount;
+			bitCount += length;
+
+			byte v = expectedByte(pos);
+			adlerA = (adlerA + v) % 65521;
+			adlerB = (adlerB + adlerA) % 65521;
+
+			if (v < 144) {
+				code = 0x30 + v;
+				length = 8;
+			} else {
+				code = 0x190 + v - 144;
+				length = 9;
+			}
+
+			// End of block code is 7 zero bits
+			bool endOfBlock = (pos % blockSize == blockSize - 1) || (pos == kDataSize - 1);
+
+			// Huffman codes are stored starting with their most significant bit
+			for (int i = length - 1; i >= 0; i--)
+				bitBuf |= ((code >> i) & 1) << bitCount++;
+			if (endOfBlock)
+				bitCount += 7;
+
+			while (bitCount >= 8) {
+				dst.writeByte(bitBuf & 0xFF);
+				bitBuf >>= 8;
+				bitCount -= 8;
+			}
+		}
+
+		if (bitCount)
+			dst.writeByte(bitBuf & 0xFF);
+
+		dst.writeUint32BE((adlerB << 16) | adlerA);
+	}
+
+	void checkRead(Common::SeekableReadStream &stream, uint32 pos, uint32 len) {
+		byte buf[512];
+		len = MIN<uint32>(len, sizeof(buf));
+
+		TS_ASSERT(stream.seek(pos));
+		TS_ASSERT_EQUALS(stream.pos(), (int64)pos);
+		uint32 expectedLen = MIN<uint32>(len, kDataSize - pos);
+		TS_ASSERT_EQUALS(stream.read(buf, len), expectedLen);
+
+		for (uint32 i = 0; i < expectedLen; i++) {
+			if (buf[i] != expectedByte(pos + i)) {
+				TS_FAIL(Common::String::format("Mismatch at offset %u", pos + i).c_str());
+				return;
+			}
+		}
+	}
+
+	void checkSeeks(Common::SeekableReadStream &stream) {
+		// Read through once, then jump back and forth
+		checkRead(stream, kDataSize - 100, 100);
+		checkRead(stream, 5, 300);
+		checkRead(stream, 2 * 1024 * 1024 + 77, 512);
+		checkRead(stream, 1024 * 1024 + 3, 512);
+		checkRead(stream, kDataSize - 512, 512);
+		checkRead(stream, 1024 * 1024 - 10, 512);
+		checkRead(stream, 0, 512);
+
+		uint32 pos = 0x9E3779B9;
+		for (int i = 0; i < 20; i++) {
+			pos = pos * 1103515245 + 12345;
+			checkRead(stream, pos % kDataSize, 512);
+		}
+	}
+
+	/**
+	 * Put raw deflated data into a zip archive with a single member,
+	 * "member.bin", with the given CRC32.
+	 */
+	static Common::Archive *makeZip(const byte *deflated, uint32 deflatedSize, uint32 crc) {
+		const char name[] = "member.bin";
+		const uint32 nameLen = sizeof(name) - 1;
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+
+		zip.writeUint32LE(0x04034b50); // local file header
+		zip.writeUint16LE(20);         // version needed
+		zip.writeUint16LE(0);          // flags
+		zip.writeUint16LE(8);          // deflated
+		zip.writeUint32LE(0);          // time and date
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(deflatedSize);
+		zip.writeUint32LE(kDataSize);
+		zip.writeUint16LE(nameLen);
+		zip.writeUint16LE(0);          // extra field
+		zip.write(name, nameLen);
+		zip.write(deflated, deflatedSize);
+
+		const uint32 centralDir = zip.pos();
+		zip.writeUint32LE(0x02014b50); // central directory header
+		zip.writeUint16LE(20);         // version made by
+		zip.writeUint16LE(20);         // version needed
+		zip.writeUint16LE(0);          // flags
+		zip.writeUint16LE(8);          // deflated
+		zip.writeUint32LE(0);          // time and date
+		zip.writeUint32LE(crc);
+		zip.writeUint32LE(deflatedSize);
+		zip.writeUint32LE(kDataSize);
+		zip.writeUint16LE(nameLen);
+		zip.writeUint16LE(0);          // extra field
+		zip.writeUint16LE(0);          // comment
+		zip.writeUint16LE(0);          // disk
+		zip.writeUint16LE(0);          // internal attributes
+		zip.writeUint32LE(0);          // external attributes
+		zip.writeUint32LE(0);          // local header offset
+		zip.write(name, nameLen);
+
+		const uint32 centralDirSize = zip.pos() - centralDir;
+		zip.writeUint32LE(0x06054b50); // end of central directory
+		zip.writeUint16LE(0);          // disk
+		zip.writeUint16LE(0);          // disk with the central directory
+		zip.writeUint16LE(1);          // entries on this disk
+		zip.writeUint16LE(1);          // entries
+		zip.writeUint32LE(centralDirSize);
+		zip.writeUint32LE(centralDir);
+		zip.writeUint16LE(0);          // comment
+
+		return Common::makeZipArchive(new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES));
+	}
+
+	/** Read the whole stream in order, and check its contents. */
+	void checkReadAll(Common::SeekableReadStream &stream) {
+		byte buf[4096];
+		uint32 pos = 0;
+		while (pos < kDataSize) {
+			const uint32 len = stream.read(buf, sizeof(buf));
+			if (!len) {
+				TS_FAIL(Common::String::format("Unexpected end at offset %u", pos).c_str());
+				return;
+			}
+			for (uint32 i = 0; i < len; i++) {
+				if (buf[i] != expectedByte(pos + i)) {
+					TS_FAIL(Common::String::format("Mismatch at offset %u", pos + i).c_str());
+					return;
+				}
+			}
+			pos += len;
+		}
+	}
+
+public:
+	void test_gzip_seek() {
+		Common::MemoryWriteStreamDynamic compressed(DisposeAfterUse::YES);
+		compress(compressed);
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(compressed.getData(), compressed.size())));
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int64)kDataSize);
+		checkSeeks(*stream);
+	}
+
+	void test_zlib_size() {
+		Common::MemoryWriteStreamDynamic compressed(DisposeAfterUse::YES);
+		deflateLiterals(compressed);
+
+		// zlib streams do not store their uncompressed size
+		Common::ScopedPtr<Common::SeekableReadStream> stream(Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(compressed.getData(), compressed.size())));
+		TS_ASSERT(stream);
+		TS_ASSERT(stream->seek(1000));
+		TS_ASSERT_EQUALS(stream->size(), (int64)kDataSize);
+		TS_ASSERT_EQUALS(stream->pos(), 1000);
+		checkSeeks(*stream);
+
+		TS_ASSERT(stream->seek(-10, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), (int64)kDataSize - 10);
+	}
+
+	void test_raw_deflate_seek() {
+#ifdef USE_ZLIB
+		Common::MemoryWriteStreamDynamic compressed(DisposeAfterUse::YES);
+		compress(compressed);
+
+		// Strip the plain gzip header and the trailer
+		const byte *data = compressed.getData();
+		TS_ASSERT_EQUALS(data[0], 0x1F);
+		TS_ASSERT_EQUALS(data[3], 0);
+
+		Common::ScopedPtr<Common::SeekableReadStream> stream(Common::wrapDeflateReadStream(
+			new Common::MemoryReadStream(data + 10, compressed.size() - 18), DisposeAfterUse::YES, kDataSize));
+		TS_ASSERT(stream);
+		checkSeeks(*stream);
+#endif
+	}
+
+	void test_zip_streamed_member() {
+#ifdef USE_ZLIB
+		Common::MemoryWriteStreamDynamic compressed(DisposeAfterUse::YES);
+		compress(compressed);
+
+		// The gzip trailer holds the CRC32 of the data
+		const byte *data = compressed.getData();
+		const uint32 crc = READ_LE_UINT32(data + compressed.size() - 8);
+
+		Common::Archive *archive = makeZip(data + 10, compressed.size() - 18, crc);
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+		Common::ScopedPtr<Common::SeekableReadStream> member(archive->createReadStreamForMember("member.bin"));
+
+		// Big members are inflated while they are read, which must still
+		// work once the archive is gone
+		delete archive;
+		TS_ASSERT(member);
+		if (!member)
+			return;
+
+		TS_ASSERT_EQUALS(member->size(), (int64)kDataSize);
+		checkSeeks(*member);
+		TS_ASSERT(member->seek(0));
+		checkReadAll(*member);
+		TS_ASSERT(!member->err());
+#endif
+	}
+
+	void test_zip_streamed_member_crc() {
+#ifdef USE_ZLIB
+		Common::MemoryWriteStreamDynamic compressed(DisposeAfterUse::YES);
+		compress(compressed);
+
+		const byte *data = compressed.getData();
+		const uint32 crc = READ_LE_UINT32(data + compressed.size() - 8);
+
+		Common::ScopedPtr<Common::Archive> archive(makeZip(data + 10, compressed.size() - 18, crc ^ 1));
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+		Common::ScopedPtr<Common::SeekableReadStream> member(archive->createReadStreamForMember("member.bin"));
+		TS_ASSERT(member);
+		if (!member)
+			return;
+
+		// The mismatch shows once all of the member was read
+		checkReadAll(*member);
+		TS_ASSERT(member->err());
+#endif
+	}
+};
@@ -0,0 +1,178 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/hashmap.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "../null_osystem.h"
+
+/**
+ * An archive whose members are kept in memory. Each member contains the
+ * name of the archive, so tests can tell which archive a stream came from.
+ */
+class TestMemberArchive : public Common::Archive {
+public:
+	TestMemberArchive(const Common::String &name) : _name(name) {}
+
+	void addMember(const Common::Path &path) {
+		_members.setVal(path, true);
+	}
+
+	bool hasFile(const Common::Path &path) const override {
+		return _members.contains(path);
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const override {
+		for (MemberMap::const_iterator i = _members.begin(); i != _members.end(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(i->_key, *this)));
+		return _members.size();
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return Common::ArchiveMemberPtr();
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return nullptr;
+		return new Common::MemoryReadStream((const byte *)_name.c_str(), _name.size());
+	}
+
+private:
+	typedef Common::HashMap<Common::Path, bool, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> MemberMap;
+	MemberMap _members;
+	Common::String _name;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+private:
+	static Common::String readOwner(const Common::SearchSet &set, const char *path) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(Common::Path(path));
+		if (!stream)
+			return Common::String();
+
+		Common::String owner = stream->readString(0, stream->size());
+		delete stream;
+		return owner;
+	}
+
+	static void fillSet(Common::SearchSet &set) {
+		TestMemberArchive *low = new TestMemberArchive("low");
+		low->addMember("shared.dat");
+		low->addMember("low.dat");
+		low->addMember("data/sub.dat");
+
+		TestMemberArchive *high = new TestMemberArchive("high");
+		high->addMember("SHARED.DAT");
+		high->addMember("high.dat");
+
+		set.add("low", low, 0);
+		set.add("high", high, 10);
+	}
+
+	void checkLookups(Common::SearchSet &set) {
+		TS_ASSERT_EQUALS(readOwner(set, "shared.dat"), "high");
+		TS_ASSERT_EQUALS(readOwner(set, "Low.Dat"), "low");
+		TS_ASSERT_EQUALS(readOwner(set, "high.dat"), "high");
+		TS_ASSERT_EQUALS(readOwner(set, "DATA/sub.dat"), "low");
+		TS_ASSERT_EQUALS(readOwner(set, "missing.dat"), "");
+
+		TS_ASSERT(set.hasFile("HIGH.DAT"));
+		TS_ASSERT(set.hasFile("data/SUB.dat"));
+		TS_ASSERT(!set.hasFile("sub.dat"));
+
+		Common::Archive *container = nullptr;
+		TS_ASSERT(set.getMember("shared.dat", &container));
+		TS_ASSERT_EQUALS(container, set.getArchive("high"));
+		TS_ASSERT(!set.getMember("missing.dat", &container));
+	}
+
+public:
+	void test_lookups() {
+		Common::SearchSet set;
+		fillSet(set);
+		checkLookups(set);
+
+		set.setIndexed(true);
+		checkLookups(set);
+	}
+
+	void test_index_invalidation() {
+		Common::SearchSet set;
+		set.setIndexed(true);
+		fillSet(set);
+
+		TS_ASSERT_EQUALS(readOwner(set, "shared.dat"), "high");
+
+		set.setPriority("low", 20);
+		TS_ASSERT_EQUALS(readOwner(set, "shared.dat"), "low");
+
+		set.remove("low");
+		TS_ASSERT_EQUALS(readOwner(set, "shared.dat"), "high");
+		TS_ASSERT(!set.hasFile("low.dat"));
+
+		TestMemberArchive *extra = new TestMemberArchive("extra");
+		extra->addMember("low.dat");
+		set.add("extra", extra);
+		TS_ASSERT_EQUALS(readOwner(set, "low.dat"), "extra");
+
+		// Archives changed behind the back of the set need a refresh
+		extra->addMember("late.dat");
+		set.refreshIndex();
+		TS_ASSERT(set.hasFile("late.dat"));
+
+		set.clear();
+		TS_ASSERT(!set.hasFile("high.dat"));
+	}
+
+	void test_lookup_benchmark() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const int numArchives = 50;
+		const int numMembers = 10000;
+#ifdef SLOW_TESTS
+		const int numLookups = 1000000;
+#else
+		const int numLookups = 20000;
+#endif
+
+		Common::SearchSet set;
+		for (int a = 0; a < numArchives; a++) {
+			Common::String name = Common::String::format("archive%d", a);
+			TestMemberArchive *archive = new TestMemberArchive(name);
+			for (int m = 0; m < numMembers; m++)
+				archive->addMember(Common::Path(Common::String::format("dir%d/file%d_%d.dat", m % 16, a, m)));
+			set.add(name, archive, a);
+		}
+
+		for (int indexed = 0; indexed < 2; indexed++) {
+			set.setIndexed(indexed != 0);
+
+			uint32 start = g_system->getMillis();
+			if (indexed)
+				set.hasFile("dir0/file0_0.dat");
+			uint32 buildTime = g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			int found = 0;
+			for (int i = 0; i < numLookups; i++) {
+				// Half of the lookups hit the lowest priority archive, the others miss
+				Common::String path = Common::String::format("dir%d/file%d_%d.dat", i % 16, (i & 1) ? 0 : numArchives, i % numMembers);
+				if (set.hasFile(Common::Path(path)))
+					found++;
+			}
+			uint32 time = g_system->getMillis() - start;
+
+			TS_ASSERT_EQUALS(found, numLookups / 2);
+			debug("SearchSet %s: %d lookups over %d archives in %d ms (index built in %d ms)",
+				indexed ? "indexed" : "linear", numLookups, numArchives, time, buildTime);
+		}
+#endif
+	}
+};
@@ -3,6 +3,28 @@
 #include "common/memstream.h"
 #include "common/substream.h"
 
+/** A memory stream handing out its contents in place, like a memory mapped file. */
+class BorrowingMemoryReadStream : public Common::MemoryReadStream {
+public:
+	BorrowingMemoryReadStream(byte *dataPtr, uint32 dataSize) : Common::MemoryReadStream(dataPtr, dataSize), _data(dataPtr) {}
+
+	Common::SharedPtr<byte> borrowData(uint32 dataSize) override {
+		if (dataSize > size() - pos())
+			return Common::SharedPtr<byte>();
+
+		byte *data = _data + pos();
+		skip(dataSize);
+		return Common::SharedPtr<byte>(data, NullDeleter());
+	}
+
+private:
+	struct NullDeleter {
+		void operator()(byte *) {}
+	};
+
+	byte *_data;
+};
+
 class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 	public:
 	void test_traverse() {
@@ -70,4 +92,35 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_borrow() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		BorrowingMemoryReadStream ms(contents, sizeof(contents));
+
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+		ssrs.seek(1);
+
+		// Borrowed data points into the parent stream, no copy is made
+		Common::SharedPtr<byte> data = ssrs.borrowData(3);
+		TS_ASSERT_EQUALS(data.get(), contents + 3);
+		TS_ASSERT_EQUALS(ssrs.pos(), 4);
+
+		// Borrowing past the end of the substream fails and leaves the position alone
+		TS_ASSERT(!ssrs.borrowData(3));
+		TS_ASSERT_EQUALS(ssrs.pos(), 4);
+
+		Common::SeekableReadStream *rs = ssrs.readStream(2);
+		TS_ASSERT_EQUALS(rs->size(), 2);
+		TS_ASSERT_EQUALS(rs->readByte(), 6);
+		TS_ASSERT_EQUALS(rs->readByte(), 7);
+		TS_ASSERT(ssrs.borrowData(0));
+		delete rs;
+
+		// Streams without support still copy
+		Common::MemoryReadStream plain(contents, sizeof(contents));
+		TS_ASSERT(!plain.borrowData(1));
+		rs = plain.readStream(4);
+		TS_ASSERT_EQUALS(rs->readByte(), 0);
+		delete rs;
+	}
 };
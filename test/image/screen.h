@@ -0,0 +1,71 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/screen.h"
+
+class TestDirtyScreen : public Graphics::Screen {
+public:
+	TestDirtyScreen() : Graphics::Screen(320, 200, Graphics::PixelFormat::createFormatCLUT8()) {}
+
+	Common::Array<Common::Rect> getMergedRects() {
+		mergeDirtyRects();
+		Common::Array<Common::Rect> rects;
+		for (Common::List<Common::Rect>::const_iterator i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i)
+			rects.push_back(*i);
+		_dirtyRects.clear();
+		return rects;
+	}
+};
+
+class ScreenTestSuite : public CxxTest::TestSuite {
+public:
+	void test_dirty_rect_list() {
+		TestDirtyScreen screen;
+		screen.clearDirtyRects();
+		TS_ASSERT(!screen.isDirty());
+
+		screen.addDirtyRect(Common::Rect(10, 10, 20, 20));
+		screen.addDirtyRect(Common::Rect(15, 15, 30, 30));
+		screen.addDirtyRect(Common::Rect(300, 180, 310, 190));
+		TS_ASSERT(screen.isDirty());
+
+		Common::Array<Common::Rect> rects = screen.getMergedRects();
+		TS_ASSERT_EQUALS(rects.size(), 2U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(10, 10, 30, 30));
+		TS_ASSERT_EQUALS(rects[1], Common::Rect(300, 180, 310, 190));
+	}
+
+	void test_dirty_tiles() {
+		TestDirtyScreen screen;
+		screen.clearDirtyRects();
+		screen.setDirtyTileSize(16);
+
+		// Two small sprites far apart only touch their own tiles
+		screen.addDirtyRect(Common::Rect(2, 3, 9, 10));
+		screen.addDirtyRect(Common::Rect(310, 190, 315, 195));
+		TS_ASSERT(screen.isDirty());
+
+		Common::Array<Common::Rect> rects = screen.getMergedRects();
+		TS_ASSERT_EQUALS(rects.size(), 2U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 0, 16, 16));
+		TS_ASSERT_EQUALS(rects[1], Common::Rect(304, 176, 320, 200));
+		TS_ASSERT(!screen.isDirty());
+
+		// Runs of tiles with the same extent on adjacent rows are merged
+		screen.addDirtyRect(Common::Rect(20, 20, 60, 40));
+		screen.addDirtyRect(Common::Rect(40, 40, 50, 50));
+		screen.addDirtyRect(Common::Rect(100, 0, 101, 1));
+		rects = screen.getMergedRects();
+		TS_ASSERT_EQUALS(rects.size(), 3U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(96, 0, 112, 16));
+		TS_ASSERT_EQUALS(rects[1], Common::Rect(16, 16, 64, 48));
+		TS_ASSERT_EQUALS(rects[2], Common::Rect(32, 48, 64, 64));
+
+		// Switching back keeps what is dirty
+		screen.addDirtyRect(Common::Rect(0, 0, 1, 1));
+		screen.setDirtyTileSize(0);
+		screen.addDirtyRect(Common::Rect(1, 1, 2, 2));
+		rects = screen.getMergedRects();
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 0, 16, 16));
+	}
+};
@@ -0,0 +1,268 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/blit.h"
+#include "graphics/managed_surface.h"
+#include "graphics/palette.h"
+
+#include "../null_osystem.h"
+
+class TransBlitTestSuite : public CxxTest::TestSuite {
+private:
+	typedef Graphics::TransBlit::Funcs Funcs;
+
+	static void selectFuncs(const Funcs *funcs) {
+		Graphics::TransBlit::_funcs = funcs;
+	}
+
+	/** Get the available row functions, which the null OSystem cannot detect */
+	static Common::Array<const Funcs *> getFuncs() {
+		Common::Array<const Funcs *> funcs;
+		funcs.push_back(&Graphics::TransBlit::_funcsGeneric);
+#ifdef SCUMMVM_NEON
+		funcs.push_back(&Graphics::TransBlit::_funcsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs.push_back(&Graphics::TransBlit::_funcsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs.push_back(&Graphics::TransBlit::_funcsAVX2);
+#endif
+		return funcs;
+	}
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/**
+	 * Fill a surface with pseudo-random pixels. A quarter of them match
+	 * the key, and the alpha of the others is mostly 0 or 255.
+	 */
+	static void fill(Graphics::Surface &surf, uint32 key, uint32 seed) {
+		const Graphics::PixelFormat &format = surf.format;
+		for (int y = 0; y < surf.h; y++) {
+			for (int x = 0; x < surf.w; x++) {
+				uint32 color = nextRandom(seed);
+				uint32 kind = nextRandom(seed) % 8;
+				if (kind < 2) {
+					color = key;
+				} else if (format.bytesPerPixel == 4 && format.aBits() != 0) {
+					byte a = (kind == 2) ? 0 : (kind == 3) ? (byte)nextRandom(seed) : 0xff;
+					color = format.ARGBToColor(a, color >> 16, color >> 8, color);
+				}
+
+				if (format.bytesPerPixel == 1)
+					*(byte *)surf.getBasePtr(x, y) = color;
+				else if (format.bytesPerPixel == 2)
+					*(uint16 *)surf.getBasePtr(x, y) = color;
+				else
+					*(uint32 *)surf.getBasePtr(x, y) = color;
+			}
+		}
+	}
+
+	static void mirror(const Graphics::Surface &src, Graphics::Surface &dst) {
+		dst.create(src.w, src.h, src.format);
+		const int bpp = src.format.bytesPerPixel;
+		for (int y = 0; y < src.h; y++) {
+			for (int x = 0; x < src.w; x++)
+				memcpy(dst.getBasePtr(src.w - x - 1, y), src.getBasePtr(x, y), bpp);
+		}
+	}
+
+	static void checkBlit(const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &dstFormat,
+			uint32 key, const Graphics::Palette *palette) {
+		const Common::Array<const Funcs *> funcs = getFuncs();
+
+		// An odd size, so every row has a tail after the vectors
+		Graphics::Surface src, flipped;
+		src.create(37, 11, srcFormat);
+		fill(src, key, 1);
+		mirror(src, flipped);
+
+		Graphics::ManagedSurface initial(64, 16, dstFormat);
+		fill(*initial.surfacePtr(), 0, 2);
+
+		static const int positions[][2] = { { 5, 3 }, { -7, -4 }, { 40, 9 }, { 0, 0 } };
+		for (uint p = 0; p < ARRAYSIZE(positions); p++) {
+			const Common::Point pos(positions[p][0], positions[p][1]);
+
+			// Flipped blits do not use the row functions, so blitting the
+			// mirrored source gives the results of the pixel by pixel code
+			Graphics::ManagedSurface expected(64, 16, dstFormat);
+			expected.simpleBlitFrom(initial);
+			expected.transBlitFrom(flipped, pos, key, true, 0xff, palette);
+
+			for (uint i = 0; i < funcs.size(); i++) {
+				selectFuncs(funcs[i]);
+				Graphics::ManagedSurface actual(64, 16, dstFormat);
+				actual.simpleBlitFrom(initial);
+				actual.transBlitFrom(src, pos, key, false, 0xff, palette);
+
+				for (int y = 0; y < actual.h; y++)
+					TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, y), actual.getBasePtr(0, y), actual.w * dstFormat.bytesPerPixel), 0);
+			}
+		}
+
+		src.free();
+		flipped.free();
+		selectFuncs(nullptr);
+	}
+
+	static Graphics::Palette createPalette() {
+		Graphics::Palette palette(256);
+		uint32 seed = 3;
+		for (uint i = 0; i < 256; i++)
+			palette.set(i, nextRandom(seed), nextRandom(seed), nextRandom(seed));
+		return palette;
+	}
+
+public:
+	void test_key_and_mask_rows() {
+		const Common::Array<const Funcs *> funcs = getFuncs();
+		const uint width = 77;
+
+		byte src8[width], mask[width], expected8[width], actual8[width];
+		uint32 src32[width], expected32[width], actual32[width];
+		uint32 seed = 5;
+		for (uint x = 0; x < width; x++) {
+			src8[x] = (nextRandom(seed) % 4) ? nextRandom(seed) : 0x2A;
+			mask[x] = (nextRandom(seed) % 3) ? 0 : nextRandom(seed) | 1;
+			src32[x] = (nextRandom(seed) % 4) ? nextRandom(seed) : 0x00FF00FF;
+		}
+
+		const Graphics::TransBlit::Key32 key32 = { 0xFFFFFFFF, 0x00FF00FF, 0, 0xFFFFFFFF };
+		for (uint i = 0; i < funcs.size(); i++) {
+			for (uint x = 0; x < width; x++) {
+				expected8[x] = actual8[x] = x;
+				expected32[x] = actual32[x] = x * 0x01010101;
+			}
+
+			funcs[i]->keyRow8(actual8, src8, width, 0x2A);
+			funcs[i]->keyRow32(actual32, src32, width, key32);
+			for (uint x = 0; x < width; x++) {
+				if (src8[x] != 0x2A)
+					expected8[x] = src8[x];
+				if (src32[x] != 0x00FF00FF)
+					expected32[x] = src32[x];
+			}
+			TS_ASSERT_EQUALS(memcmp(expected8, actual8, width), 0);
+			TS_ASSERT_EQUALS(memcmp(expected32, actual32, width * 4), 0);
+
+			funcs[i]->maskRow8(actual8, src8 + 1, mask, width - 1);
+			funcs[i]->maskRow32(actual32, src32 + 1, mask, width - 1);
+			for (uint x = 0; x < width - 1; x++) {
+				if (mask[x]) {
+					expected8[x] = src8[x + 1];
+					expected32[x] = src32[x + 1];
+				}
+			}
+			TS_ASSERT_EQUALS(memcmp(expected8, actual8, width), 0);
+			TS_ASSERT_EQUALS(memcmp(expected32, actual32, width * 4), 0);
+		}
+	}
+
+	void test_trans_blit_matches_generic() {
+		const Graphics::PixelFormat clut8 = Graphics::PixelFormat::createFormatCLUT8();
+		const Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::PixelFormat argb(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const Graphics::PixelFormat xrgb(4, 8, 8, 8, 0, 16, 8, 0, 0);
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::Palette palette = createPalette();
+
+		checkBlit(clut8, clut8, 0x2A, nullptr);
+		checkBlit(clut8, rgba, 0x2A, &palette);
+		checkBlit(clut8, rgb565, 0, &palette);
+		checkBlit(rgba, rgba, rgba.RGBToColor(0xFF, 0, 0xFF), nullptr);
+		checkBlit(argb, argb, 0, nullptr);
+		checkBlit(xrgb, xrgb, xrgb.RGBToColor(0xFF, 0, 0xFF), nullptr);
+	}
+
+	void test_trans_blit_speed() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Array<const Funcs *> funcs = getFuncs();
+
+#ifdef SLOW_TESTS
+		const int iters = 2000;
+#else
+		const int iters = 20;
+#endif
+		const Graphics::PixelFormat clut8 = Graphics::PixelFormat::createFormatCLUT8();
+		const Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::Palette palette = createPalette();
+
+		static const struct {
+			const char *name;
+			bool srcIs8Bit, dstIs8Bit;
+		} cases[] = {
+			{ "8-bit to 8-bit", true, true },
+			{ "8-bit to 32-bit", true, false },
+			{ "32-bit to 32-bit", false, false }
+		};
+
+		for (uint c = 0; c < ARRAYSIZE(cases); c++) {
+			Graphics::Surface src, flipped;
+			src.create(256, 256, cases[c].srcIs8Bit ? clut8 : rgba);
+			fill(src, 0, 7);
+			mirror(src, flipped);
+			Graphics::ManagedSurface dst(640, 480, cases[c].dstIs8Bit ? clut8 : rgba);
+
+			// The flipped blit measures the pixel by pixel code
+			uint32 start = g_system->getMillis();
+			for (int n = 0; n < iters; n++)
+				dst.transBlitFrom(flipped, Common::Point(n % 300, n % 200), 0, true, 0xff, &palette);
+			uint32 time = g_system->getMillis() - start;
+			debug("transBlitFrom %s, per pixel: %d blits in %d ms", cases[c].name, iters, time);
+
+			for (uint i = 0; i < funcs.size(); i++) {
+				selectFuncs(funcs[i]);
+				start = g_system->getMillis();
+				for (int n = 0; n < iters; n++)
+					dst.transBlitFrom(src, Common::Point(n % 300, n % 200), 0, false, 0xff, &palette);
+				time = g_system->getMillis() - start;
+				debug("transBlitFrom %s, row functions %d: %d blits in %d ms", cases[c].name, i, iters, time);
+			}
+
+			src.free();
+			flipped.free();
+		}
+
+		selectFuncs(nullptr);
+#endif
+	}
+};
@@ -0,0 +1,200 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+private:
+	typedef Graphics::YUVToRGBManager::RowFunc RowFunc;
+
+	enum Format {
+		kFormat444,
+		kFormat422,
+		kFormat420,
+		kFormat420Alpha,
+		kFormat410,
+		kFormatCount
+	};
+
+	/** A YUV image with pseudo-random planes, including a padding column and row for 410 */
+	struct Image {
+		int width, height, yPitch, uvPitch;
+		Common::Array<byte> y, u, v, a;
+
+		Image(int w, int h) : width(w), height(h), yPitch(w + 3), uvPitch(w + 5) {
+			y.resize(yPitch * h);
+			a.resize(yPitch * h);
+			u.resize(uvPitch * (h + 1));
+			v.resize(uvPitch * (h + 1));
+
+			uint32 seed = 1;
+			fill(y, seed);
+			fill(u, seed);
+			fill(v, seed);
+			fill(a, seed);
+		}
+
+		static void fill(Common::Array<byte> &plane, uint32 &seed) {
+			for (uint i = 0; i < plane.size(); i++) {
+				seed = seed * 1103515245 + 12345;
+				plane[i] = (byte)(seed >> 16);
+			}
+		}
+	};
+
+	static void convert(Format format, Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, const Image &image) {
+		switch (format) {
+		case kFormat444:
+			YUVToRGBMan.convert444(&dst, scale, image.y.data(), image.u.data(), image.v.data(), image.width, image.height, image.yPitch, image.uvPitch);
+			break;
+		case kFormat422:
+			YUVToRGBMan.convert422(&dst, scale, image.y.data(), image.u.data(), image.v.data(), image.width, image.height, image.yPitch, image.uvPitch);
+			break;
+		case kFormat420:
+			YUVToRGBMan.convert420(&dst, scale, image.y.data(), image.u.data(), image.v.data(), image.width, image.height, image.yPitch, image.uvPitch);
+			break;
+		case kFormat420Alpha:
+			YUVToRGBMan.convert420Alpha(&dst, scale, image.y.data(), image.u.data(), image.v.data(), image.a.data(), image.width, image.height, image.yPitch, image.uvPitch);
+			break;
+		case kFormat410:
+			YUVToRGBMan.convert410(&dst, scale, image.y.data(), image.u.data(), image.v.data(), image.width, image.height, image.yPitch, image.uvPitch);
+			break;
+		default:
+			break;
+		}
+	}
+
+	static void selectRowFunc(RowFunc func) {
+		Graphics::YUVToRGBManager::_rowFunc = func;
+		Graphics::YUVToRGBManager::_rowFuncSelected = true;
+	}
+
+	/** Get the available SIMD row converters, which the null OSystem cannot detect */
+	static Common::Array<RowFunc> getRowFuncs() {
+		Common::Array<RowFunc> funcs;
+#ifdef SCUMMVM_NEON
+		funcs.push_back(Graphics::YUVToRGBManager::convertRowNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs.push_back(Graphics::YUVToRGBManager::convertRowSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs.push_back(Graphics::YUVToRGBManager::convertRowAVX2);
+#endif
+		return funcs;
+	}
+
+public:
+	void test_simd_matches_lookup() {
+		const Common::Array<RowFunc> funcs = getRowFuncs();
+
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		// An odd number of vectors wide, plus a tail for the lookup tables
+		Image image(4 * 25, 12);
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			Graphics::Surface expected, actual;
+			expected.create(image.width, image.height, formats[f]);
+			actual.create(image.width, image.height, formats[f]);
+
+			for (int format = 0; format < kFormatCount; format++) {
+				for (int scale = Graphics::YUVToRGBManager::kScaleFull; scale <= Graphics::YUVToRGBManager::kScaleITU; scale++) {
+					selectRowFunc(nullptr);
+					convert((Format)format, expected, (Graphics::YUVToRGBManager::LuminanceScale)scale, image);
+
+					for (uint i = 0; i < funcs.size(); i++) {
+						memset(actual.getPixels(), 0, actual.pitch * actual.h);
+						selectRowFunc(funcs[i]);
+						convert((Format)format, actual, (Graphics::YUVToRGBManager::LuminanceScale)scale, image);
+
+						for (int y = 0; y < image.height; y++)
+							TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, y), actual.getBasePtr(0, y), image.width * formats[f].bytesPerPixel), 0);
+					}
+				}
+			}
+
+			expected.free();
+			actual.free();
+		}
+
+		selectRowFunc(nullptr);
+		YUVToRGBMan.destroy();
+	}
+
+	void test_speed() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::Array<RowFunc> funcs = getRowFuncs();
+		funcs.insert_at(0, nullptr);
+
+		static const char *const formatNames[] = { "444", "422", "420", "420Alpha", "410" };
+
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 5;
+#endif
+		Image image(640, 480);
+		Graphics::Surface surface;
+		surface.create(image.width, image.height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+
+		for (int format = 0; format < kFormatCount; format++) {
+			for (uint i = 0; i < funcs.size(); i++) {
+				selectRowFunc(funcs[i]);
+
+				uint32 start = g_system->getMillis();
+				for (int n = 0; n < iters; n++)
+					convert((Format)format, surface, Graphics::YUVToRGBManager::kScaleFull, image);
+				uint32 time = g_system->getMillis() - start;
+
+				debug("YUV%s to RGB, converter %d: %d frames of %dx%d in %d ms", formatNames[format], i, iters, image.width, image.height, time);
+			}
+		}
+
+		surface.free();
+		selectRowFunc(nullptr);
+		YUVToRGBMan.destroy();
+#endif
+	}
+};
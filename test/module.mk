@@ -13,9 +13,14 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mmapstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/saves/default/default-saves.o \
+	backends/saves/savefile.o \
+	backends/timer/default/default-timer.o
+TESTS += $(srcdir)/test/backends/*.h
 endif
 
 ifdef WIN32
@@ -25,11 +30,34 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o \
-	backends/platform/sdl/win32/win32_wrapper.o
+	backends/platform/sdl/win32/win32_wrapper.o \
+	backends/saves/default/default-saves.o \
+	backends/saves/savefile.o \
+	backends/timer/default/default-timer.o
+endif
+
+ifdef USE_CLOUD
+ifdef USE_LIBCURL
+# The save file manager keeps the timestamps for the cloud sync
+TEST_LIBS += backends/libbackends.a base/version.o
+endif
+endif
+
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/*.h
+	TEST_LIBS += video/libvideo.a
 endif
 
 TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
+ifdef USE_TINYGL
+	TESTS += $(srcdir)/test/tinygl/*.h
+endif
+
+ifdef USE_HQ_SCALERS
+	TESTS += $(srcdir)/test/scaler/*.h
+endif
+
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
@@ -52,6 +80,12 @@ TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
 TEST_CXXFLAGS  := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 TEST_CXXFLAGS += -Wno-self-assign-overloaded
 
+# Time decoding the Bink videos of a directory, with
+# "make test BINK_BENCHMARK=path/to/videos".
+ifdef BINK_BENCHMARK
+TEST_CFLAGS += -DBINK_BENCHMARK_DIR=\"$(BINK_BENCHMARK)\"
+endif
+
 ifdef WIN32
 TEST_LDFLAGS := $(filter-out -mwindows,$(TEST_LDFLAGS))
 endif
@@ -0,0 +1,179 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/scaler/hq.h"
+#include "graphics/scaler/intern.h"
+
+#include "../null_osystem.h"
+
+class HQScalerTestSuite : public CxxTest::TestSuite {
+	typedef HQScaler::PatternRowFunc PatternRowFunc;
+
+	/** Get the available pattern functions, which the null OSystem cannot detect */
+	static Common::Array<PatternRowFunc> getFuncs() {
+		Common::Array<PatternRowFunc> funcs;
+		funcs.push_back(HQScaler::patternRowGeneric);
+#ifdef SCUMMVM_NEON
+		funcs.push_back(HQScaler::patternRowNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs.push_back(HQScaler::patternRowSSE2);
+#endif
+		return funcs;
+	}
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	/** The YUV value of a color, as HQScaler::initLUT() computes it */
+	static uint32 toYUV(int r, int g, int b) {
+		int y = (r + g + b) >> 2;
+		int u = 128 + ((r - b) >> 2);
+		int v = 128 + ((-r + 2 * g - b) >> 3);
+		return (y << 16) | (u << 8) | v;
+	}
+
+	/**
+	 * Fill a 32-bit surface with blocks of similar colors, with a border
+	 * of one pixel for the scaler to read.
+	 */
+	static void fill(Graphics::Surface &surf, uint32 seed) {
+		uint32 color = 0;
+		for (int y = 0; y < surf.h; y++) {
+			for (int x = 0; x < surf.w; x++) {
+				uint32 kind = nextRandom(seed) % 8;
+				if (kind == 0)
+					color = nextRandom(seed);
+				else if (kind == 1)
+					color ^= nextRandom(seed) & 0x070707;
+				surf.setPixel(x, y, surf.format.RGBToColor(color >> 16, color >> 8, color));
+			}
+		}
+	}
+
+public:
+	void test_pattern_rows_match_generic() {
+		const Common::Array<PatternRowFunc> funcs = getFuncs();
+		const int width = 45;
+
+		uint32 seed = 1;
+		uint32 rows[3][width + 2];
+		for (int iter = 0; iter < 50; iter++) {
+			// Mostly small differences around the thresholds
+			int r = nextRandom(seed) & 0xFF, g = nextRandom(seed) & 0xFF, b = nextRandom(seed) & 0xFF;
+			for (int i = 0; i < 3; i++) {
+				for (int x = 0; x < width + 2; x++) {
+					if (nextRandom(seed) % 4) {
+						r = CLIP<int>(r + (int)(nextRandom(seed) % 41) - 20, 0, 255);
+						g = CLIP<int>(g + (int)(nextRandom(seed) % 41) - 20, 0, 255);
+						b = CLIP<int>(b + (int)(nextRandom(seed) % 41) - 20, 0, 255);
+					}
+					rows[i][x] = toYUV(r, g, b);
+				}
+			}
+
+			uint8 expected[width], actual[width];
+			HQScaler::patternRowGeneric(rows[0], rows[1], rows[2], expected, width);
+			for (int x = 0; x < width; x++) {
+				int pattern = 0;
+				for (int n = 0, bit = 1; n < 9; n++) {
+					if (n == 4)
+						continue;
+					if (diffYUV(rows[1][x + 1], rows[n / 3][x + n % 3]))
+						pattern |= bit;
+					bit <<= 1;
+				}
+				TS_ASSERT_EQUALS(expected[x], pattern);
+			}
+
+			for (uint i = 1; i < funcs.size(); i++) {
+				funcs[i](rows[0], rows[1], rows[2], actual, width);
+				TS_ASSERT_EQUALS(memcmp(expected, actual, width), 0);
+			}
+		}
+	}
+
+	void test_hq_scale_matches_generic() {
+		const Common::Array<PatternRowFunc> funcs = getFuncs();
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			Graphics::Surface src;
+			src.create(67, 23, formats[f]);
+			fill(src, 2 + f);
+
+			HQScaler scaler(formats[f]);
+			for (uint factor = 2; factor <= 3; factor++) {
+				scaler.setFactor(factor);
+
+				Graphics::Surface expected, actual;
+				expected.create(65 * factor, 21 * factor, formats[f]);
+				actual.create(65 * factor, 21 * factor, formats[f]);
+
+				HQScaler::_patternRow = HQScaler::patternRowGeneric;
+				scaler.scale((const uint8 *)src.getBasePtr(1, 1), src.pitch, (uint8 *)expected.getPixels(), expected.pitch, 65, 21, 0, 0);
+
+				for (uint i = 1; i < funcs.size(); i++) {
+					HQScaler::_patternRow = funcs[i];
+					scaler.scale((const uint8 *)src.getBasePtr(1, 1), src.pitch, (uint8 *)actual.getPixels(), actual.pitch, 65, 21, 0, 0);
+					for (int y = 0; y < expected.h; y++)
+						TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, y), actual.getBasePtr(0, y), expected.w * formats[f].bytesPerPixel), 0);
+				}
+
+				expected.free();
+				actual.free();
+			}
+			src.free();
+		}
+		HQScaler::_patternRow = nullptr;
+	}
+
+	void test_hq_scale_speed() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Common::Array<PatternRowFunc> funcs = getFuncs();
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 2;
+#endif
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+		Graphics::Surface src, dst;
+		src.create(322, 202, format);
+		fill(src, 7);
+		dst.create(320 * 3, 200 * 3, format);
+
+		HQScaler scaler(format);
+		for (uint factor = 2; factor <= 3; factor++) {
+			scaler.setFactor(factor);
+			for (uint i = 0; i < funcs.size(); i++) {
+				HQScaler::_patternRow = funcs[i];
+				uint32 start = g_system->getMillis();
+				for (int n = 0; n < iters; n++)
+					scaler.scale((const uint8 *)src.getBasePtr(1, 1), src.pitch, (uint8 *)dst.getPixels(), dst.pitch, 320, 200, 0, 0);
+				debug("HQ%dx, pattern function %d: %d frames in %d ms", factor, i, iters, g_system->getMillis() - start);
+			}
+		}
+
+		src.free();
+		dst.free();
+		HQScaler::_patternRow = nullptr;
+#endif
+	}
+};
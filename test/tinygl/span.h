@@ -0,0 +1,286 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/array.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "graphics/surface.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../null_osystem.h"
+
+class TinyGLSpanTestSuite : public CxxTest::TestSuite {
+	typedef TinyGL::TexturedSpan TexturedSpan;
+	typedef TinyGL::TexturedSpan::Funcs Funcs;
+
+	static const int kWidth = 160;
+	static const int kHeight = 120;
+
+	static void selectFuncs(const Funcs *funcs) {
+		TexturedSpan::_funcs = funcs;
+	}
+
+	/** Get the available block functions, which the null OSystem cannot detect */
+	static Common::Array<const Funcs *> getFuncs() {
+		Common::Array<const Funcs *> funcs;
+		funcs.push_back(&TexturedSpan::_funcsGeneric);
+#ifdef SCUMMVM_NEON
+		funcs.push_back(&TexturedSpan::_funcsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs.push_back(&TexturedSpan::_funcsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs.push_back(&TexturedSpan::_funcsAVX2);
+#endif
+		return funcs;
+	}
+
+	/** The number of blocks which went through the counting block functions. */
+	static int &blockCount() {
+		static int count = 0;
+		return count;
+	}
+
+	static uint countingDepthTest(const uint *pz, uint z, int dzdx, int depthFunc) {
+		blockCount()++;
+		return TexturedSpan::depthTestGeneric(pz, z, dzdx, depthFunc);
+	}
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 16) | (seed << 16);
+	}
+
+	static void drawScene(TGLuint texture, int count) {
+		tglClearColor(0.2f, 0.3f, 0.4f, 1.0f);
+		tglClearDepth(1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1.0f, 1.0f, -0.75f, 0.75f, 1.0f, 10.0f);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		tglEnable(TGL_TEXTURE_2D);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+
+		for (int i = 0; i < count; i++) {
+			// Tilted quads in perspective, which overlap in depth
+			const float offset = (i % 4) * 0.1f;
+			if (i % 2) {
+				tglEnable(TGL_BLEND);
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			}
+			tglDepthMask((i % 3) ? TGL_TRUE : TGL_FALSE);
+			tglBegin(TGL_QUADS);
+			tglColor4f(1.0f, 0.8f, 0.6f, 0.7f);
+			tglTexCoord2f(0.0f, 0.0f);
+			tglVertex3f(-1.5f + offset, -1.0f, -1.5f);
+			tglColor4f(0.3f, 1.0f, 0.9f, 0.9f);
+			tglTexCoord2f(4.0f, 0.0f);
+			tglVertex3f(1.2f, -1.1f + offset, -4.0f - offset);
+			tglColor4f(0.6f, 0.4f, 1.0f, 0.5f);
+			tglTexCoord2f(4.0f, 4.0f);
+			tglVertex3f(1.4f, 1.2f, -4.5f);
+			tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+			tglTexCoord2f(0.0f, 4.0f);
+			tglVertex3f(-1.3f, 0.9f - offset, -1.8f + offset);
+			tglEnd();
+			tglDisable(TGL_BLEND);
+			tglDepthMask(TGL_TRUE);
+		}
+
+		tglDisable(TGL_TEXTURE_2D);
+	}
+
+	/**
+	 * With dirty rects, the triangles are scissored to the dirty regions,
+	 * which makes the blocks at their edges go through the per pixel code.
+	 * Without block functions, all pixels go through it.
+	 */
+	static Graphics::Surface *render(bool dirtyRects, int frames, int count, bool blockFuncs = true) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, format, 256, false, dirtyRects);
+		TinyGL::setContext(context);
+		if (!blockFuncs)
+			TinyGL::gl_get_context()->fb->_spanFormatSupported = false;
+
+		byte pixels[8 * 8 * 4];
+		for (int i = 0; i < 8 * 8; i++) {
+			byte v = ((i / 8 + i % 8) & 1) ? 255 : 40;
+			pixels[i * 4 + 0] = v;
+			pixels[i * 4 + 1] = 255 - v;
+			pixels[i * 4 + 2] = v / 2;
+			pixels[i * 4 + 3] = (i % 3) ? 255 : 128;
+		}
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_S, TGL_REPEAT);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_T, TGL_REPEAT);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 8, 8, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, pixels);
+
+		for (int i = 0; i < frames; i++) {
+			drawScene(texture, count);
+			TinyGL::presentBuffer();
+		}
+
+		Graphics::Surface *surface = TinyGL::copyFromFrameBuffer(format);
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext(context);
+		return surface;
+	}
+
+	static bool samePixels(const Graphics::Surface *a, const Graphics::Surface *b) {
+		for (int y = 0; y < kHeight; y++) {
+			if (memcmp(a->getBasePtr(0, y), b->getBasePtr(0, y), kWidth * 4) != 0)
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_block_functions_match_generic() {
+		const Common::Array<const Funcs *> funcs = getFuncs();
+		static const int depthFuncs[] = {
+			TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+
+		uint32 seed = 1;
+		for (int iter = 0; iter < 2000; iter++) {
+			uint zbuf[TexturedSpan::kBlockSize];
+			uint32 texels[TexturedSpan::kBlockSize], initial[TexturedSpan::kBlockSize];
+			TexturedSpan::Block block;
+
+			// Some blocks cross the top bit of the depth range
+			block.z = (iter % 5) ? nextRandom(seed) >> 1 : 0x7FFFFF00 + nextRandom(seed) % 0x200;
+			block.dzdx = (int)nextRandom(seed) >> (8 + iter % 16);
+			for (int i = 0; i < TexturedSpan::kBlockSize; i++) {
+				zbuf[i] = (iter % 3) ? nextRandom(seed) : block.z + i * block.dzdx;
+				texels[i] = nextRandom(seed);
+				initial[i] = nextRandom(seed);
+			}
+			block.r = nextRandom(seed) >> 8;
+			block.g = nextRandom(seed) >> 8;
+			block.b = nextRandom(seed) >> 8;
+			block.a = nextRandom(seed) >> 8;
+			block.drdx = (int)nextRandom(seed) >> 20;
+			block.dgdx = (int)nextRandom(seed) >> 20;
+			block.dbdx = (int)nextRandom(seed) >> 20;
+			block.dadx = (int)nextRandom(seed) >> 20;
+
+			const int depthFunc = depthFuncs[iter % ARRAYSIZE(depthFuncs)];
+			const uint mask = TexturedSpan::depthTestGeneric(zbuf, block.z, block.dzdx, depthFunc);
+			TexturedSpan::Format format;
+			TexturedSpan::getFormat(formats[iter % ARRAYSIZE(formats)], format);
+			const TexturedSpan::BlendMode blendMode = (iter & 1) ? TexturedSpan::kBlendSrcAlpha : TexturedSpan::kBlendNone;
+			const bool depthWrite = (iter & 2) != 0;
+
+			uint32 expected[TexturedSpan::kBlockSize];
+			uint expectedZ[TexturedSpan::kBlockSize];
+			memcpy(expected, initial, sizeof(expected));
+			memcpy(expectedZ, zbuf, sizeof(expectedZ));
+			TexturedSpan::shadeGeneric(expected, expectedZ, texels, mask, block, format, blendMode, depthWrite);
+
+			for (uint i = 0; i < funcs.size(); i++) {
+				TS_ASSERT_EQUALS(funcs[i]->depthTest(zbuf, block.z, block.dzdx, depthFunc), mask);
+
+				uint32 actual[TexturedSpan::kBlockSize];
+				uint actualZ[TexturedSpan::kBlockSize];
+				memcpy(actual, initial, sizeof(actual));
+				memcpy(actualZ, zbuf, sizeof(actualZ));
+				funcs[i]->shade(actual, actualZ, texels, mask, block, format, blendMode, depthWrite);
+				TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(actual)), 0);
+				TS_ASSERT_EQUALS(memcmp(expectedZ, actualZ, sizeof(actualZ)), 0);
+			}
+		}
+	}
+
+	void test_textured_triangles_match_per_pixel_code() {
+		const Common::Array<const Funcs *> funcs = getFuncs();
+		const Funcs *previous = TexturedSpan::_funcs;
+		Graphics::Surface *reference = render(false, 1, 6, false);
+
+		for (uint i = 0; i < funcs.size(); i++) {
+			selectFuncs(funcs[i]);
+			Graphics::Surface *actual = render(false, 1, 6);
+			TS_ASSERT(samePixels(reference, actual));
+			actual->free();
+			delete actual;
+
+			actual = render(true, 1, 6);
+			TS_ASSERT(samePixels(reference, actual));
+			actual->free();
+			delete actual;
+		}
+
+		reference->free();
+		delete reference;
+		selectFuncs(previous);
+	}
+
+	void test_scissored_triangles_use_block_functions() {
+		const Funcs *previous = TexturedSpan::_funcs;
+		Graphics::Surface *reference = render(false, 1, 6, false);
+
+		static const Funcs countingFuncs = { &countingDepthTest, &TexturedSpan::shadeGeneric };
+		selectFuncs(&countingFuncs);
+		blockCount() = 0;
+		Graphics::Surface *actual = render(true, 1, 6);
+		TS_ASSERT_LESS_THAN(0, blockCount());
+		TS_ASSERT(samePixels(reference, actual));
+
+		actual->free();
+		delete actual;
+		reference->free();
+		delete reference;
+		selectFuncs(previous);
+	}
+
+	void test_textured_triangles_speed() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Common::Array<const Funcs *> funcs = getFuncs();
+		const Funcs *previous = TexturedSpan::_funcs;
+#ifdef SLOW_TESTS
+		const int frames = 500;
+#else
+		const int frames = 5;
+#endif
+
+		uint32 start = g_system->getMillis();
+		Graphics::Surface *surface = render(false, frames, 6, false);
+		debug("Textured triangles, per pixel: %d frames in %d ms", frames, g_system->getMillis() - start);
+		surface->free();
+		delete surface;
+
+		for (uint i = 0; i < funcs.size(); i++) {
+			selectFuncs(funcs[i]);
+			start = g_system->getMillis();
+			surface = render(false, frames, 6);
+			debug("Textured triangles, block functions %d: %d frames in %d ms", i, frames, g_system->getMillis() - start);
+			surface->free();
+			delete surface;
+		}
+		selectFuncs(previous);
+#endif
+	}
+};
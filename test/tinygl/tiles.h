@@ -0,0 +1,221 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+
+class TinyGLTilesTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 160;
+	static const int kHeight = 120;
+
+	static void drawScene(TGLuint texture) {
+		tglClearColor(0.2f, 0.3f, 0.4f, 1.0f);
+		tglClearDepth(1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		// A large smooth shaded triangle crossing many tiles
+		tglBegin(TGL_TRIANGLES);
+		tglColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+		tglVertex3f(-0.95f, -0.9f, 0.5f);
+		tglColor4f(0.0f, 1.0f, 0.0f, 1.0f);
+		tglVertex3f(0.9f, -0.7f, -0.2f);
+		tglColor4f(0.0f, 0.0f, 1.0f, 1.0f);
+		tglVertex3f(-0.1f, 0.95f, 0.1f);
+		tglEnd();
+
+		// A blended textured quad intersecting it in depth
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglEnable(TGL_TEXTURE_2D);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 1.0f, 1.0f, 0.75f);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(-0.6f, -0.5f, -0.5f);
+		tglTexCoord2f(3.0f, 0.0f);
+		tglVertex3f(0.7f, -0.6f, 0.6f);
+		tglTexCoord2f(3.0f, 3.0f);
+		tglVertex3f(0.8f, 0.7f, 0.6f);
+		tglTexCoord2f(0.0f, 3.0f);
+		tglVertex3f(-0.5f, 0.6f, -0.5f);
+		tglEnd();
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_BLEND);
+
+		// Lines and points
+		tglBegin(TGL_LINES);
+		tglColor4f(1.0f, 1.0f, 0.0f, 1.0f);
+		tglVertex3f(-1.0f, 0.8f, -0.9f);
+		tglVertex3f(1.0f, -0.8f, -0.9f);
+		tglEnd();
+	}
+
+	static Graphics::Surface *render(int tileSize, bool dirtyRects) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, format, 256, false, dirtyRects);
+		TinyGL::setContext(context);
+		TinyGL::setTileSize(tileSize);
+
+		// Selecting the block functions would need a backend
+		if (!TinyGL::TexturedSpan::_funcs)
+			TinyGL::TexturedSpan::_funcs = &TinyGL::TexturedSpan::_funcsGeneric;
+
+		byte pixels[8 * 8 * 4];
+		for (int i = 0; i < 8 * 8; i++) {
+			byte v = ((i / 8 + i % 8) & 1) ? 255 : 40;
+			pixels[i * 4 + 0] = v;
+			pixels[i * 4 + 1] = 255 - v;
+			pixels[i * 4 + 2] = v / 2;
+			pixels[i * 4 + 3] = 255;
+		}
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_S, TGL_REPEAT);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_WRAP_T, TGL_REPEAT);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 8, 8, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, pixels);
+
+		drawScene(texture);
+		TinyGL::presentBuffer();
+
+		Graphics::Surface *surface = TinyGL::copyFromFrameBuffer(format);
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext(context);
+		return surface;
+	}
+
+	static bool samePixels(const Graphics::Surface *a, const Graphics::Surface *b) {
+		for (int y = 0; y < kHeight; y++) {
+			if (memcmp(a->getBasePtr(0, y), b->getBasePtr(0, y), kWidth * 4) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	static const int kSeamWidth = 16;
+	static const int kSeamHeight = 4;
+
+	/**
+	 * Red channel of the second frame drawn by renderSeam(), before and after
+	 * clipped spans kept interpolating. Only x = 7 to 12 is redrawn.
+	 */
+	static const byte kSeamBefore[kSeamHeight][kSeamWidth];
+	static const byte kSeamAfter[kSeamHeight][kSeamWidth];
+
+	/**
+	 * Draw a horizontal red gradient over the whole frame, then the same frame
+	 * again with a triangle hidden behind it, so that only the rectangle of the
+	 * latter is redrawn when presenting dirty rectangles.
+	 */
+	static void renderSeam(int tileSize, byte red[2][kSeamHeight][kSeamWidth]) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		TinyGL::ContextHandle *context = TinyGL::createContext(kSeamWidth, kSeamHeight, format, 256, false, true);
+		TinyGL::setContext(context);
+		TinyGL::setTileSize(tileSize);
+
+		// Both frames must have the same state, for their draw calls to match
+		tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		tglClearDepth(1.0f);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		for (int frame = 0; frame < 2; frame++) {
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+			// Quads change the edge flags of their vertices while they are
+			// drawn, so they never match the ones of the previous frame
+			tglBegin(TGL_TRIANGLES);
+			tglColor4f(0.0f, 0.0f, 0.0f, 1.0f);
+			tglVertex3f(-1.0f, -1.0f, 0.0f);
+			tglColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+			tglVertex3f(1.0f, -1.0f, 0.0f);
+			tglVertex3f(1.0f, 1.0f, 0.0f);
+			tglVertex3f(1.0f, 1.0f, 0.0f);
+			tglColor4f(0.0f, 0.0f, 0.0f, 1.0f);
+			tglVertex3f(-1.0f, 1.0f, 0.0f);
+			tglVertex3f(-1.0f, -1.0f, 0.0f);
+			tglEnd();
+
+			if (frame == 1) {
+				tglBegin(TGL_TRIANGLES);
+				tglColor4f(0.0f, 1.0f, 0.0f, 1.0f);
+				tglVertex3f(0.0f, -1.0f, 0.5f);
+				tglVertex3f(0.5f, -1.0f, 0.5f);
+				tglVertex3f(0.5f, 1.0f, 0.5f);
+				tglEnd();
+			}
+
+			TinyGL::presentBuffer();
+
+			Graphics::Surface *surface = TinyGL::copyFromFrameBuffer(format);
+			for (int y = 0; y < kSeamHeight; y++) {
+				for (int x = 0; x < kSeamWidth; x++) {
+					byte r, g, b;
+					format.colorToRGB(surface->getPixel(x, y), r, g, b);
+					red[frame][y][x] = r;
+				}
+			}
+			surface->free();
+			delete surface;
+		}
+
+		TinyGL::destroyContext(context);
+	}
+
+public:
+	void test_tiles_match_whole_frame() {
+		// Tiling must not change the output of either way of presenting the frame
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++) {
+			Graphics::Surface *reference = render(0, dirtyRects);
+
+			const int tileSizes[] = { 8, 16, 50, 64 };
+			for (int i = 0; i < ARRAYSIZE(tileSizes); i++) {
+				Graphics::Surface *tiled = render(tileSizes[i], dirtyRects);
+				TS_ASSERT(samePixels(reference, tiled));
+				tiled->free();
+				delete tiled;
+			}
+
+			reference->free();
+			delete reference;
+		}
+	}
+
+	void test_dirty_rect_seam() {
+		const int tileSizes[] = { 0, 4 };
+		for (int i = 0; i < ARRAYSIZE(tileSizes); i++) {
+			byte red[2][kSeamHeight][kSeamWidth];
+			renderSeam(tileSizes[i], red);
+
+			// Redrawing part of the gradient must not leave a seam
+			TS_ASSERT_EQUALS(memcmp(red[0], kSeamAfter, sizeof(kSeamAfter)), 0);
+			TS_ASSERT_EQUALS(memcmp(red[1], kSeamAfter, sizeof(kSeamAfter)), 0);
+			TS_ASSERT_DIFFERS(memcmp(red[1], kSeamBefore, sizeof(kSeamBefore)), 0);
+		}
+	}
+};
+
+const byte TinyGLTilesTestSuite::kSeamBefore[kSeamHeight][kSeamWidth] = {
+	{ 0, 17, 34, 51, 68, 85, 102,  0,  17,  34,  51,  68,  85, 221, 238, 255 },
+	{ 0, 17, 34, 51, 68, 85, 102,  0,  17,  34, 170, 187, 204, 221, 238, 255 },
+	{ 0, 17, 34, 51, 68, 85, 102, 85, 102, 119, 136, 153, 170, 221, 238, 255 },
+	{ 0, 17, 34, 51, 68, 85, 102,  0,  17,  34,  51,  68,  85, 221, 238, 255 }
+};
+
+const byte TinyGLTilesTestSuite::kSeamAfter[kSeamHeight][kSeamWidth] = {
+	{ 0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 },
+	{ 0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 },
+	{ 0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 },
+	{ 0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 }
+};
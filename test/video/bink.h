@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+
+#include "video/bink_decoder.h"
+
+#include "../null_osystem.h"
+
+class BinkDecoderTestSuite : public CxxTest::TestSuite {
+	typedef Video::BinkDecoder::BinkVideoTrack BinkVideoTrack;
+
+	static void fillPlane(Common::RandomSource &rnd, byte *plane, uint32 size) {
+		for (uint32 i = 0; i < size; i++)
+			plane[i] = rnd.getRandomNumber(255);
+	}
+
+	/** Randomize the pixels of all planes in the given band. */
+	static void changeBand(Common::RandomSource &rnd, BinkVideoTrack &track, uint32 band) {
+		const uint32 yPitch = track._yBlockWidth * 8;
+		const uint32 uvPitch = track._uvBlockWidth * 8;
+		// The last band may only have half as many Y rows
+		const uint32 yRows = MIN<uint32>(16, track._yBlockHeight * 8 - band * 16);
+
+		fillPlane(rnd, track._curPlanes[0] + band * 16 * yPitch, yRows * yPitch);
+		fillPlane(rnd, track._curPlanes[1] + band * 8 * uvPitch, 8 * uvPitch);
+		fillPlane(rnd, track._curPlanes[2] + band * 8 * uvPitch, 8 * uvPitch);
+		if (track._hasAlpha)
+			fillPlane(rnd, track._curPlanes[3] + band * 16 * yPitch, yRows * yPitch);
+
+		track._changedBands[band] = true;
+	}
+
+	void changedBandsTemplate(bool hasAlpha) {
+		Common::install_null_g_system();
+
+		// Odd-sized, so that the last band and column are partial
+		const uint32 width = 70, height = 53;
+		BinkVideoTrack track(width, height, 2, Common::Rational(15), false, hasAlpha, MKTAG('B', 'I', 'K', 'i'));
+		track.setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0));
+
+		track._surface = new Graphics::Surface();
+		track._surface->create(track._surfaceWidth, track._surfaceHeight, track._pixelFormat);
+
+		Common::RandomSource rnd("bink");
+		for (uint32 band = 0; band < track._changedBands.size(); band++)
+			changeBand(rnd, track, band);
+
+		// The first conversion is always a full one
+		track.convertChangedBands();
+
+		// Change the first and the last band, keep the rest as it is
+		for (uint32 band = 0; band < track._changedBands.size(); band++)
+			track._changedBands[band] = false;
+		changeBand(rnd, track, 0);
+		changeBand(rnd, track, track._changedBands.size() - 1);
+		track.convertChangedBands();
+
+		Graphics::Surface partial;
+		partial.copyFrom(*track._surface);
+
+		// Convert the same planes again, but all of them
+		memset(track._surface->getPixels(), 0, track._surface->h * track._surface->pitch);
+		track.setOutputPixelFormat(track._pixelFormat);
+		track.convertChangedBands();
+
+		for (int y = 0; y < track._surface->h; y++)
+			TS_ASSERT_EQUALS(memcmp(partial.getBasePtr(0, y), track._surface->getBasePtr(0, y), track._surface->w * track._surface->format.bytesPerPixel), 0);
+
+		partial.free();
+	}
+
+public:
+	void test_changed_bands_match_full_conversion() {
+		changedBandsTemplate(false);
+	}
+
+	void test_changed_bands_match_full_conversion_alpha() {
+		changedBandsTemplate(true);
+	}
+
+	/**
+	 * Decode every Bink video in the directory passed to make as
+	 * BINK_BENCHMARK, and report how long decoding a frame takes.
+	 * Without it, there is nothing to decode and this is skipped.
+	 */
+	void test_decode_speed() {
+#ifdef BINK_BENCHMARK_DIR
+		Common::install_null_g_system();
+
+		Common::FSNode dir(BINK_BENCHMARK_DIR);
+		Common::FSList files;
+		if (!dir.getChildren(files, Common::FSNode::kListFilesOnly)) {
+			TS_FAIL("Cannot list the Bink benchmark directory " BINK_BENCHMARK_DIR);
+			return;
+		}
+
+		int videoCount = 0;
+		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+			if (!file->getName().hasSuffixIgnoreCase(".bik"))
+				continue;
+			videoCount++;
+
+			Video::BinkDecoder decoder;
+			if (!decoder.loadStream(file->createReadStream())) {
+				TS_FAIL(file->getName().c_str());
+				continue;
+			}
+
+			const int frameCount = decoder.getFrameCount();
+			const uint32 startTime = g_system->getMillis();
+			for (int frame = 0; frame < frameCount; frame++)
+				TS_ASSERT(decoder.decodeNextFrame());
+			const uint32 time = g_system->getMillis() - startTime;
+
+			Common::String result = Common::String::format("%s: %d frames of %dx%d in %u ms, %.3f ms/frame", file->getName().c_str(),
+					frameCount, decoder.getWidth(), decoder.getHeight(), time, frameCount ? (double)time / frameCount : 0.0);
+			TS_TRACE(result.c_str());
+		}
+
+		if (!videoCount)
+			TS_FAIL("No .bik files in the Bink benchmark directory " BINK_BENCHMARK_DIR);
+#endif
+	}
+};
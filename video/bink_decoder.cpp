@@ -32,6 +32,7 @@
 #include "common/stream.h"
 #include "common/substream.h"
 #include "common/file.h"
+#include "common/memstream.h"
 #include "common/str.h"
 #include "common/bitstream.h"
 #include "common/compression/huffman.h"
@@ -186,8 +187,7 @@ void BinkDecoder::readNextPacket() {
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
+			audio.bits = new Common::BitStream32LELSB(createPacketStream(audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
 
 			audioTrack->decodePacket();
 
@@ -203,8 +203,7 @@ void BinkDecoder::readNextPacket() {
 	uint32 videoPacketStart = _bink->pos();
 	uint32 videoPacketEnd   = _bink->pos() + frameSize;
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	frame.bits = new Common::BitStream32LELSB(createPacketStream(videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
 
 	videoTrack->decodePacket(frame);
 
@@ -212,6 +211,16 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = 0;
 }
 
+Common::SeekableReadStream *BinkDecoder::createPacketStream(uint32 start, uint32 end) {
+	// Decode straight from the file contents when they are in memory already
+	_bink->seek(start);
+	Common::SharedPtr<byte> data = _bink->borrowData(end - start);
+	if (data)
+		return new Common::MemoryReadStream(data, end - start);
+
+	return new Common::SeekableSubReadStream(_bink, start, end);
+}
+
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
 	// Bink audio track indexes are relative to the first audio track
 	Track *track = getTrack(index + 1);
@@ -243,7 +252,7 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 }
 
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
-		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id), _surface(nullptr) {
+		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id), _surface(nullptr), _surfaceValid(false) {
 	_curFrame = -1;
 
 	for (int i = 0; i < 16; i++)
@@ -291,6 +300,8 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, uint32
 	_uvBlockWidth  = (width  + 15) >> 4;
 	_uvBlockHeight = (height + 15) >> 4;
 
+	_changedBands.resize(_uvBlockHeight);
+
 	// The planes are sized according to the number of blocks
 	_curPlanes[0] = new byte[_yBlockWidth  * 8 * _yBlockHeight  * 8](); // Y
 	_curPlanes[1] = new byte[_uvBlockWidth * 8 * _uvBlockHeight * 8](); // U, 1/4 resolution
@@ -432,6 +443,7 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 	}
 
 	_curFrame = -1;
+	_surfaceValid = false;
 
 	// Re-initialize the video with solid green
 	memset(_curPlanes[0],   0, _yBlockWidth  * 8 * _yBlockHeight  * 8);
@@ -457,8 +469,13 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 		// surface.
 		_surface->h = _height;
 		_surface->w = _width;
+
+		_surfaceValid = false;
 	}
 
+	for (uint32 i = 0; i < _changedBands.size(); i++)
+		_changedBands[i] = false;
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			frame.bits->skip(32);
@@ -474,22 +491,15 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 
 		decodePlane(frame, planeIdx, i != 0);
 
-		if (frame.bits->pos() >= frame.bits->size())
+		if (frame.bits->pos() >= frame.bits->size()) {
+			// The remaining planes still hold the frame before the last one
+			if (i < 2)
+				_surfaceValid = false;
 			break;
+		}
 	}
 
-	// Convert the YUV data we have to our format
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	if (_hasAlpha) {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	} else {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	}
+	convertChangedBands();
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
@@ -498,6 +508,51 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	_curFrame++;
 }
 
+void BinkDecoder::BinkVideoTrack::convertChangedBands() {
+	// Bands made of skipped blocks only are identical to the last frame,
+	// which is still in the surface
+	if (!_surfaceValid) {
+		for (uint32 i = 0; i < _changedBands.size(); i++)
+			_changedBands[i] = true;
+
+		_surfaceValid = true;
+	}
+
+	uint32 band = 0;
+	while (band < _changedBands.size()) {
+		if (!_changedBands[band]) {
+			band++;
+			continue;
+		}
+
+		uint32 firstBand = band;
+		while (band < _changedBands.size() && _changedBands[band])
+			band++;
+
+		// Convert the run of changed bands in one go.
+		// The width used here is the surface-width, and not the video-width
+		// to allow for odd-sized videos.
+		int top    = firstBand * 16;
+		int bottom = MIN<int>(band * 16, _surfaceHeight);
+
+		Graphics::Surface dst;
+		dst.init(_surfaceWidth, bottom - top, _surface->pitch, _surface->getBasePtr(0, top), _surface->format);
+
+		uint32 yOffset  = top * _yBlockWidth * 8;
+		uint32 uvOffset = (top / 2) * _uvBlockWidth * 8;
+
+		if (_hasAlpha) {
+			assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
+			YUVToRGBMan.convert420Alpha(&dst, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0] + yOffset, _curPlanes[1] + uvOffset,
+					_curPlanes[2] + uvOffset, _curPlanes[3] + yOffset, _surfaceWidth, bottom - top, _yBlockWidth * 8, _uvBlockWidth * 8);
+		} else {
+			assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
+			YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0] + yOffset, _curPlanes[1] + uvOffset,
+					_curPlanes[2] + uvOffset, _surfaceWidth, bottom - top, _yBlockWidth * 8, _uvBlockWidth * 8);
+		}
+	}
+}
+
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
 	uint32 blockWidth  = isChroma ? _uvBlockWidth  : _yBlockWidth;
 	uint32 blockHeight = isChroma ? _uvBlockHeight : _yBlockHeight;
@@ -543,17 +598,23 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 		ctx.dest = ctx.destStart + 8 * ctx.blockY * ctx.pitch;
 		ctx.prev = ctx.prevStart + 8 * ctx.blockY * ctx.pitch;
 
+		bool changed = false;
+
 		for (ctx.blockX = 0; ctx.blockX < blockWidth; ctx.blockX++, ctx.dest += 8, ctx.prev += 8) {
 			BlockType blockType = (BlockType) getBundleValue(kSourceBlockTypes);
 
 			// 16x16 block type on odd line means part of the already decoded block, so skip it
 			if ((ctx.blockY & 1) && (blockType == kBlockScaled)) {
+				changed = true;
 				ctx.blockX += 1;
 				ctx.dest   += 8;
 				ctx.prev   += 8;
 				continue;
 			}
 
+			if (blockType != kBlockSkip)
+				changed = true;
+
 			switch (blockType) {
 			case kBlockSkip:
 				blockSkip(ctx);
@@ -591,6 +652,9 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 		}
 
+		// A band spans one chroma block row or two luma block rows
+		if (changed)
+			_changedBands[isChroma ? ctx.blockY : (ctx.blockY >> 1)] = true;
 	}
 
 	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
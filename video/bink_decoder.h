@@ -38,6 +38,10 @@
 
 #include "graphics/surface.h"
 
+#ifdef CXXTEST_RUNNING
+class BinkDecoderTestSuite;
+#endif
+
 namespace Audio {
 class AudioStream;
 class QueuingAudioStream;
@@ -67,6 +71,10 @@ namespace Video {
  *  - scumm (he)
  */
 class BinkDecoder : public VideoDecoder {
+#ifdef CXXTEST_RUNNING
+	friend class ::BinkDecoderTestSuite;
+#endif
+
 public:
 	BinkDecoder();
 	~BinkDecoder();
@@ -84,6 +92,9 @@ protected:
 	uint32 findKeyFrame(uint32 frame) const;
 
 private:
+	/** Create a stream over the packet data in [start, end) of the file. */
+	Common::SeekableReadStream *createPacketStream(uint32 start, uint32 end);
+
 	static const int kAudioChannelsMax  = 2;
 	static const int kAudioBlockSizeMax = (kAudioChannelsMax << 11);
 
@@ -146,6 +157,10 @@ private:
 	};
 
 	class BinkVideoTrack : public FixedRateVideoTrack {
+#ifdef CXXTEST_RUNNING
+		friend class ::BinkDecoderTestSuite;
+#endif
+
 	public:
 		BinkVideoTrack(uint32 width, uint32 height, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id);
 		~BinkVideoTrack();
@@ -153,14 +168,14 @@ private:
 		uint16 getWidth() const override { return _width; }
 		uint16 getHeight() const  override{ return _height; }
 		Graphics::PixelFormat getPixelFormat() const override { return _pixelFormat; }
-		bool setOutputPixelFormat(const Graphics::PixelFormat &format) override { _pixelFormat = format; return true; }
+		bool setOutputPixelFormat(const Graphics::PixelFormat &format) override { _pixelFormat = format; _surfaceValid = false; return true; }
 		int getCurFrame() const override { return _curFrame; }
 		int getFrameCount() const override { return _frameCount; }
 		const Graphics::Surface *decodeNextFrame() override { return _surface; }
 		bool isSeekable() const  override{ return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
-		void setCurFrame(uint32 frame) { _curFrame = frame; }
+		void setCurFrame(uint32 frame) { _curFrame = frame; _surfaceValid = false; }
 
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
@@ -275,6 +290,16 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		/**
+		 * Bands of 16 pixel rows (one chroma block row) that differ from the
+		 * last frame and need to be converted to RGB again.
+		 */
+		Common::Array<bool> _changedBands;
+		bool _surfaceValid; ///< Does the surface hold the last decoded frame?
+
+		/** Convert the changed bands of the current planes into the surface. */
+		void convertChangedBands();
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -283,7 +308,7 @@ private:
 		/** Initialize the Huffman decoders. */
 		void initHuffman();
 
-		/** Decode a plane. */
+		/** Decode a plane, marking the bands it changes. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
 		/** Read/Initialize a bundle for decoding a plane. */